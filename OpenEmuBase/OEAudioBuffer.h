@@ -64,6 +64,39 @@ typedef NSUInteger (^OEAudioBufferReadBlock)(void * buffer, NSUInteger bytesRequ
  */
 - (OEAudioBufferReadBlock)readBlock;
 
+/**
+ * Returns a contiguous region of the buffer where the producer can write
+ * the next length bytes in place, instead of copying them with
+ * -write:maxLength:. The bytes are not visible to the consumer until
+ * -commitWrite: is called.
+ * @param length Amount of bytes to be written.
+ * @returns A pointer to the region, or NULL if length bytes can't be written.
+ */
+- (void *)reserveWriteRegion:(NSUInteger)length;
+
+/**
+ * Makes the first length bytes of the region returned by the last call to
+ * -reserveWriteRegion: available to the consumer.
+ */
+- (void)commitWrite:(NSUInteger)length;
+
+/**
+ * Returns a contiguous region of the buffer holding the next bytes to be
+ * read, so the consumer can use them in place instead of copying them with
+ * -read:maxLength:. They stay in the buffer until -commitRead: is called.
+ * @param length On input, the largest amount of bytes wanted. On output, the
+ *      amount of bytes in the region.
+ * @returns A pointer to the region, or NULL if there is nothing to read.
+ */
+- (const void *)reserveReadRegion:(NSUInteger *)length;
+
+/**
+ * Removes the first length bytes of the region returned by the last call to
+ * -reserveReadRegion: from the buffer.
+ * @returns NO if the producer overwrote part of them while they were in use.
+ */
+- (BOOL)commitRead:(NSUInteger)length;
+
 @end
 
 
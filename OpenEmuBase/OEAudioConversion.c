@@ -0,0 +1,277 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OEAudioConversion.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// The number of frames decoded to float at a time. Small enough to stay in L1.
+#define OE_AUDIO_BLOCK_SIZE 256
+
+typedef struct {
+    const char *name;
+    void (*decode[4])(const void *source, size_t stride, float *samples, size_t count);
+    void (*encode[4])(const float *samples, void *destination, size_t stride, size_t count, float gain);
+    /// Adds scaled samples to float32 samples, without clipping.
+    void (*mix)(const float *samples, void *destination, size_t stride, size_t count, float gain);
+    void (*accumulate)(float *sum, const float *samples, size_t count);
+} OEAudioKernels;
+
+// Baseline kernels: SSE2 on x86_64, NEON on arm64.
+#define OE_KERNEL(name) OEAudioVector##name
+#define OE_KERNEL_WIDTH 4
+#define OE_KERNEL_ATTRIBUTES
+#if defined(__x86_64__)
+#define OE_KERNEL_NAME "sse2"
+#elif defined(__arm64__) || defined(__aarch64__)
+#define OE_KERNEL_NAME "neon"
+#else
+#define OE_KERNEL_NAME "vector"
+#endif
+#include "OEAudioConversionKernels.h"
+#undef OE_KERNEL
+#undef OE_KERNEL_WIDTH
+#undef OE_KERNEL_ATTRIBUTES
+#undef OE_KERNEL_NAME
+
+#if defined(__x86_64__)
+#define OE_KERNEL(name) OEAudioAVX2##name
+#define OE_KERNEL_WIDTH 8
+#define OE_KERNEL_ATTRIBUTES __attribute__((target("avx2")))
+#define OE_KERNEL_NAME "avx2"
+#include "OEAudioConversionKernels.h"
+#undef OE_KERNEL
+#undef OE_KERNEL_WIDTH
+#undef OE_KERNEL_ATTRIBUTES
+#undef OE_KERNEL_NAME
+#endif
+
+static const OEAudioKernels *OEAudioBestKernels(void)
+{
+#if defined(__x86_64__)
+    if(__builtin_cpu_supports("avx2"))
+        return &OEAudioAVX2kernels;
+#endif
+    return &OEAudioVectorkernels;
+}
+
+struct OEAudioConverter {
+    OEAudioFormat source;
+    OEAudioFormat destination;
+    const OEAudioKernels *kernels;
+    float gain;
+    /// Both formats are identical.
+    bool identical;
+    /// Channels map one to one and the layouts match, so every buffer is a single run of samples.
+    bool flat;
+};
+
+size_t OEAudioSampleTypeSize(OEAudioSampleType type)
+{
+    static const size_t sizes[] = { 2, 3, 4, 4 };
+    return type <= OEAudioSampleTypeFloat32 ? sizes[type] : 0;
+}
+
+OEAudioSampleType OEAudioSampleTypeForBitDepth(size_t bitDepth)
+{
+    switch(bitDepth)
+    {
+        case 24 : return OEAudioSampleTypeInt24;
+        case 32 : return OEAudioSampleTypeInt32;
+        default : return OEAudioSampleTypeInt16;
+    }
+}
+
+size_t OEAudioFormatBytesPerFrame(const OEAudioFormat *format)
+{
+    size_t size = OEAudioSampleTypeSize(format->sampleType);
+    return format->planar ? size : size * format->channelCount;
+}
+
+OEAudioConverter *OEAudioConverterCreate(const OEAudioFormat *source, const OEAudioFormat *destination)
+{
+    if(source->channelCount == 0 || destination->channelCount == 0 ||
+       OEAudioSampleTypeSize(source->sampleType) == 0 || OEAudioSampleTypeSize(destination->sampleType) == 0)
+        return NULL;
+
+    OEAudioConverter *converter = calloc(1, sizeof(OEAudioConverter));
+    if(converter == NULL)
+        return NULL;
+
+    converter->source = *source;
+    converter->destination = *destination;
+    converter->kernels = OEAudioBestKernels();
+    converter->gain = 1;
+
+    // Mono is the same whether planar or interleaved.
+    bool sameLayout = source->planar == destination->planar || source->channelCount == 1;
+    converter->flat = source->channelCount == destination->channelCount && sameLayout;
+    converter->identical = converter->flat && source->sampleType == destination->sampleType;
+
+    return converter;
+}
+
+void OEAudioConverterDestroy(OEAudioConverter *converter)
+{
+    free(converter);
+}
+
+const OEAudioFormat *OEAudioConverterGetSourceFormat(const OEAudioConverter *converter)
+{
+    return &converter->source;
+}
+
+const OEAudioFormat *OEAudioConverterGetDestinationFormat(const OEAudioConverter *converter)
+{
+    return &converter->destination;
+}
+
+void OEAudioConverterSetGain(OEAudioConverter *converter, float gain)
+{
+    converter->gain = gain;
+}
+
+float OEAudioConverterGetGain(const OEAudioConverter *converter)
+{
+    return converter->gain;
+}
+
+const char *OEAudioConverterGetKernelName(const OEAudioConverter *converter)
+{
+    return converter->kernels->name;
+}
+
+/// Returns the address of a channel's sample in a frame, and the distance in samples to the next frame.
+static uint8_t *OEAudioChannelAddress(const OEAudioFormat *format, void *const *buffers, size_t channel, size_t frame, size_t *outStride)
+{
+    size_t size = OEAudioSampleTypeSize(format->sampleType);
+    if(format->planar)
+    {
+        *outStride = 1;
+        return (uint8_t *)buffers[channel] + frame * size;
+    }
+    *outStride = format->channelCount;
+    return (uint8_t *)buffers[0] + (frame * format->channelCount + channel) * size;
+}
+
+typedef void (*OEAudioEncodeFunction)(const float *samples, void *destination, size_t stride, size_t count, float gain);
+
+static void OEAudioConvertRun(const OEAudioConverter *converter, OEAudioEncodeFunction encode, const uint8_t *source, uint8_t *destination, size_t count)
+{
+    const OEAudioKernels *kernels = converter->kernels;
+    size_t sourceSize = OEAudioSampleTypeSize(converter->source.sampleType);
+    size_t destinationSize = OEAudioSampleTypeSize(converter->destination.sampleType);
+    float samples[OE_AUDIO_BLOCK_SIZE];
+
+    for(size_t start = 0; start < count; start += OE_AUDIO_BLOCK_SIZE)
+    {
+        size_t length = count - start < OE_AUDIO_BLOCK_SIZE ? count - start : OE_AUDIO_BLOCK_SIZE;
+        kernels->decode[converter->source.sampleType](source + start * sourceSize, 1, samples, length);
+        encode(samples, destination + start * destinationSize, 1, length, converter->gain);
+    }
+}
+
+static void OEAudioConverterProcess(OEAudioConverter *converter, const void *const *source, void *const *destination, size_t frameCount, bool mixes)
+{
+    const OEAudioFormat *from = &converter->source, *to = &converter->destination;
+    const OEAudioKernels *kernels = converter->kernels;
+    OEAudioEncodeFunction encode = mixes ? kernels->mix : kernels->encode[to->sampleType];
+    size_t bufferCount = from->planar && from->channelCount > 1 ? from->channelCount : 1;
+
+    if(!mixes && converter->identical && converter->gain == 1 && from->sampleType != OEAudioSampleTypeFloat32)
+    {
+        size_t length = frameCount * OEAudioFormatBytesPerFrame(from);
+        for(size_t i = 0; i < bufferCount; i++)
+            memcpy(destination[i], source[i], length);
+        return;
+    }
+
+    if(converter->flat)
+    {
+        size_t count = from->planar ? frameCount : frameCount * from->channelCount;
+        for(size_t i = 0; i < bufferCount; i++)
+            OEAudioConvertRun(converter, encode, source[i], destination[i], count);
+        return;
+    }
+
+    void *const *sourceBuffers = (void *const *)source;
+    float samples[OE_AUDIO_BLOCK_SIZE], mix[OE_AUDIO_BLOCK_SIZE];
+    size_t sourceStride, destinationStride;
+
+    for(size_t start = 0; start < frameCount; start += OE_AUDIO_BLOCK_SIZE)
+    {
+        size_t length = frameCount - start < OE_AUDIO_BLOCK_SIZE ? frameCount - start : OE_AUDIO_BLOCK_SIZE;
+        const float *block = samples;
+        float gain = converter->gain;
+
+        if(from->channelCount == 1)
+        {
+            // Decoded once and copied to every destination channel.
+            const uint8_t *input = OEAudioChannelAddress(from, sourceBuffers, 0, start, &sourceStride);
+            kernels->decode[from->sampleType](input, sourceStride, samples, length);
+        }
+        else if(to->channelCount == 1)
+        {
+            for(size_t channel = 0; channel < from->channelCount; channel++)
+            {
+                const uint8_t *input = OEAudioChannelAddress(from, sourceBuffers, channel, start, &sourceStride);
+                kernels->decode[from->sampleType](input, sourceStride, channel == 0 ? mix : samples, length);
+                if(channel > 0)
+                    kernels->accumulate(mix, samples, length);
+            }
+            block = mix;
+            gain /= from->channelCount;
+        }
+
+        for(size_t channel = 0; channel < to->channelCount; channel++)
+        {
+            if(from->channelCount > 1 && to->channelCount > 1)
+            {
+                if(channel < from->channelCount)
+                {
+                    const uint8_t *input = OEAudioChannelAddress(from, sourceBuffers, channel, start, &sourceStride);
+                    kernels->decode[from->sampleType](input, sourceStride, samples, length);
+                }
+                else
+                    memset(samples, 0, length * sizeof(float));
+            }
+
+            uint8_t *output = OEAudioChannelAddress(to, destination, channel, start, &destinationStride);
+            encode(block, output, destinationStride, length, gain);
+        }
+    }
+}
+
+void OEAudioConverterConvert(OEAudioConverter *converter, const void *const *source, void *const *destination, size_t frameCount)
+{
+    OEAudioConverterProcess(converter, source, destination, frameCount, false);
+}
+
+void OEAudioConverterMix(OEAudioConverter *converter, const void *const *source, void *const *destination, size_t frameCount)
+{
+    if(converter->destination.sampleType == OEAudioSampleTypeFloat32)
+        OEAudioConverterProcess(converter, source, destination, frameCount, true);
+}
@@ -0,0 +1,115 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OEAudioConversion_h
+#define OEAudioConversion_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Converts audio between sample types, interleaved and planar layouts and
+ * channel counts, optionally applying a gain, in a single pass over the
+ * source and destination.
+ *
+ * Samples are decoded to float in small blocks that stay in L1, routed to
+ * the destination channels, scaled, clipped and encoded. Decoding and
+ * encoding use SIMD kernels; the widest instruction set supported by the
+ * CPU is selected at run time when a converter is created.
+ *
+ * Channels are routed as follows: equal counts map one to one; mono is
+ * copied to every destination channel; any layout is downmixed to mono by
+ * averaging; otherwise extra source channels are dropped and extra
+ * destination channels are silent.
+ */
+
+typedef uint32_t OEAudioSampleType;
+enum {
+    OEAudioSampleTypeInt16      = 0,
+    /// Packed in 3 bytes, little endian.
+    OEAudioSampleTypeInt24      = 1,
+    OEAudioSampleTypeInt32      = 2,
+    OEAudioSampleTypeFloat32    = 3,
+};
+
+typedef struct {
+    OEAudioSampleType sampleType;
+    uint32_t channelCount;
+    /// If true, each channel is in its own buffer.
+    bool planar;
+} OEAudioFormat;
+
+/// Returns the size of one sample of the given type, in bytes.
+size_t OEAudioSampleTypeSize(OEAudioSampleType type);
+
+/// Returns the sample type matching a core's audioBitDepth: 16, 24 or 32 bit signed integers.
+OEAudioSampleType OEAudioSampleTypeForBitDepth(size_t bitDepth);
+
+/// Returns the size of one frame in a buffer of the given format, in bytes.
+/// For planar formats, this is the size of one sample.
+size_t OEAudioFormatBytesPerFrame(const OEAudioFormat *format);
+
+typedef struct OEAudioConverter OEAudioConverter;
+
+/// Creates a converter. Returns NULL if either format has no channels or an unknown sample type.
+OEAudioConverter *OEAudioConverterCreate(const OEAudioFormat *source, const OEAudioFormat *destination);
+
+void OEAudioConverterDestroy(OEAudioConverter *converter);
+
+const OEAudioFormat *OEAudioConverterGetSourceFormat(const OEAudioConverter *converter);
+const OEAudioFormat *OEAudioConverterGetDestinationFormat(const OEAudioConverter *converter);
+
+/// Sets a linear gain applied to every sample. Results are clipped to full scale. Defaults to 1.
+void OEAudioConverterSetGain(OEAudioConverter *converter, float gain);
+float OEAudioConverterGetGain(const OEAudioConverter *converter);
+
+/// Returns the name of the instruction set used by the converter's kernels, e.g. "avx2".
+const char *OEAudioConverterGetKernelName(const OEAudioConverter *converter);
+
+/*
+ * Converts frameCount frames. source and destination hold one buffer for
+ * interleaved formats, or one buffer per channel for planar formats.
+ * Never allocates memory, so it can be called on a realtime thread.
+ */
+void OEAudioConverterConvert(OEAudioConverter *converter, const void *const *source, void *const *destination, size_t frameCount);
+
+/*
+ * Like OEAudioConverterConvert, but adds the converted samples to the
+ * destination instead of replacing them, without clipping. Does nothing
+ * unless the destination sample type is OEAudioSampleTypeFloat32.
+ */
+void OEAudioConverterMix(OEAudioConverter *converter, const void *const *source, void *const *destination, size_t frameCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OEAudioConversion_h */
@@ -0,0 +1,241 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Sample decoding and encoding kernels, included by OEAudioConversion.c once
+// per instruction set. The includer defines:
+//   OE_KERNEL(name)       the name of a kernel for this instruction set
+//   OE_KERNEL_WIDTH       the number of float lanes in a vector
+//   OE_KERNEL_ATTRIBUTES  attributes enabling the instruction set, if any
+//
+// Strides are in samples. Strided access falls back to scalar code; only
+// contiguous samples are processed a vector at a time.
+
+typedef float   OE_KERNEL(Float)   __attribute__((vector_size(OE_KERNEL_WIDTH * 4)));
+typedef int32_t OE_KERNEL(Int32)   __attribute__((vector_size(OE_KERNEL_WIDTH * 4)));
+typedef int16_t OE_KERNEL(Int16)   __attribute__((vector_size(OE_KERNEL_WIDTH * 2)));
+
+static inline __attribute__((always_inline)) OE_KERNEL_ATTRIBUTES
+OE_KERNEL(Float) OE_KERNEL(clamp)(OE_KERNEL(Float) value, float low, float high)
+{
+    OE_KERNEL(Float) lows = value * 0 + low, highs = value * 0 + high;
+    OE_KERNEL(Int32) below = value < lows, above = value > highs;
+    OE_KERNEL(Int32) bits = (OE_KERNEL(Int32))value;
+    bits = (bits & ~below) | ((OE_KERNEL(Int32))lows & below);
+    bits = (bits & ~above) | ((OE_KERNEL(Int32))highs & above);
+    return (OE_KERNEL(Float))bits;
+}
+
+#pragma mark Decoding
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(decodeInt16)(const void *source, size_t stride, float *samples, size_t count)
+{
+    const int16_t *input = source;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Int16) packed;
+            memcpy(&packed, input + i, sizeof(packed));
+            OE_KERNEL(Float) value = __builtin_convertvector(__builtin_convertvector(packed, OE_KERNEL(Int32)), OE_KERNEL(Float)) * (1.0f / 32768.0f);
+            memcpy(samples + i, &value, sizeof(value));
+        }
+    }
+    for(; i < count; i++)
+        samples[i] = input[i * stride] * (1.0f / 32768.0f);
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(decodeInt24)(const void *source, size_t stride, float *samples, size_t count)
+{
+    const uint8_t *input = source;
+    for(size_t i = 0; i < count; i++)
+    {
+        const uint8_t *bytes = input + i * stride * 3;
+        int32_t value = (int32_t)((uint32_t)bytes[0] << 8 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 24) >> 8;
+        samples[i] = value * (1.0f / 8388608.0f);
+    }
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(decodeInt32)(const void *source, size_t stride, float *samples, size_t count)
+{
+    const int32_t *input = source;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Int32) packed;
+            memcpy(&packed, input + i, sizeof(packed));
+            OE_KERNEL(Float) value = __builtin_convertvector(packed, OE_KERNEL(Float)) * (1.0f / 2147483648.0f);
+            memcpy(samples + i, &value, sizeof(value));
+        }
+    }
+    for(; i < count; i++)
+        samples[i] = input[i * stride] * (1.0f / 2147483648.0f);
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(decodeFloat32)(const void *source, size_t stride, float *samples, size_t count)
+{
+    const float *input = source;
+    if(stride == 1)
+    {
+        memcpy(samples, input, count * sizeof(float));
+        return;
+    }
+    for(size_t i = 0; i < count; i++)
+        samples[i] = input[i * stride];
+}
+
+#pragma mark Encoding
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(encodeInt16)(const float *samples, void *destination, size_t stride, size_t count, float gain)
+{
+    int16_t *output = destination;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        // Offset to positive values, so truncation rounds to nearest.
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Float) value;
+            memcpy(&value, samples + i, sizeof(value));
+            value = OE_KERNEL(clamp)(value * (gain * 32768.0f) + 32768.5f, 0.0f, 65535.5f);
+            OE_KERNEL(Int32) rounded = __builtin_convertvector(value, OE_KERNEL(Int32)) - 32768;
+            OE_KERNEL(Int16) packed = __builtin_convertvector(rounded, OE_KERNEL(Int16));
+            memcpy(output + i, &packed, sizeof(packed));
+        }
+    }
+    for(; i < count; i++)
+    {
+        float value = samples[i] * (gain * 32768.0f) + 32768.5f;
+        value = value < 0.0f ? 0.0f : value > 65535.5f ? 65535.5f : value;
+        output[i * stride] = (int16_t)((int32_t)value - 32768);
+    }
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(encodeInt24)(const float *samples, void *destination, size_t stride, size_t count, float gain)
+{
+    uint8_t *output = destination;
+    for(size_t i = 0; i < count; i++)
+    {
+        float value = samples[i] * (gain * 8388608.0f) + 8388608.5f;
+        value = value < 0.0f ? 0.0f : value > 16777215.0f ? 16777215.0f : value;
+        int32_t rounded = (int32_t)value - 8388608;
+        uint8_t *bytes = output + i * stride * 3;
+        bytes[0] = (uint8_t)rounded;
+        bytes[1] = (uint8_t)(rounded >> 8);
+        bytes[2] = (uint8_t)(rounded >> 16);
+    }
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(encodeInt32)(const float *samples, void *destination, size_t stride, size_t count, float gain)
+{
+    // 2147483520 is the largest float below 2^31.
+    int32_t *output = destination;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Float) value;
+            memcpy(&value, samples + i, sizeof(value));
+            value = OE_KERNEL(clamp)(value * (gain * 2147483648.0f), -2147483648.0f, 2147483520.0f);
+            OE_KERNEL(Int32) packed = __builtin_convertvector(value, OE_KERNEL(Int32));
+            memcpy(output + i, &packed, sizeof(packed));
+        }
+    }
+    for(; i < count; i++)
+    {
+        float value = samples[i] * (gain * 2147483648.0f);
+        value = value < -2147483648.0f ? -2147483648.0f : value > 2147483520.0f ? 2147483520.0f : value;
+        output[i * stride] = (int32_t)value;
+    }
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(encodeFloat32)(const float *samples, void *destination, size_t stride, size_t count, float gain)
+{
+    float *output = destination;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Float) value;
+            memcpy(&value, samples + i, sizeof(value));
+            value = OE_KERNEL(clamp)(value * gain, -1.0f, 1.0f);
+            memcpy(output + i, &value, sizeof(value));
+        }
+    }
+    for(; i < count; i++)
+    {
+        float value = samples[i] * gain;
+        output[i * stride] = value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value;
+    }
+}
+
+#pragma mark Mixing
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(mixFloat32)(const float *samples, void *destination, size_t stride, size_t count, float gain)
+{
+    float *output = destination;
+    size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+        {
+            OE_KERNEL(Float) value, sum;
+            memcpy(&value, samples + i, sizeof(value));
+            memcpy(&sum, output + i, sizeof(sum));
+            sum += value * gain;
+            memcpy(output + i, &sum, sizeof(sum));
+        }
+    }
+    for(; i < count; i++)
+        output[i * stride] += samples[i] * gain;
+}
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(accumulate)(float *sum, const float *samples, size_t count)
+{
+    size_t i = 0;
+    for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+    {
+        OE_KERNEL(Float) a, b;
+        memcpy(&a, sum + i, sizeof(a));
+        memcpy(&b, samples + i, sizeof(b));
+        a += b;
+        memcpy(sum + i, &a, sizeof(a));
+    }
+    for(; i < count; i++)
+        sum[i] += samples[i];
+}
+
+static const OEAudioKernels OE_KERNEL(kernels) = {
+    .name = OE_KERNEL_NAME,
+    .decode = { OE_KERNEL(decodeInt16), OE_KERNEL(decodeInt24), OE_KERNEL(decodeInt32), OE_KERNEL(decodeFloat32) },
+    .encode = { OE_KERNEL(encodeInt16), OE_KERNEL(encodeInt24), OE_KERNEL(encodeInt32), OE_KERNEL(encodeFloat32) },
+    .mix = OE_KERNEL(mixFloat32),
+    .accumulate = OE_KERNEL(accumulate),
+};
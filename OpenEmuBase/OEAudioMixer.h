@@ -0,0 +1,71 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEAudioBuffer.h>
+
+@class OEGameCore;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OEAudioMixer
+ * @abstract Mixes every audio track of a core into a single stream.
+ * @discussion
+ * Cores with an audioBufferCount above 1 output each track at its own sample
+ * rate and channel count. A mixer reads all tracks, resamples them to
+ * outputSampleRate with an OEAudioResampler each, and sums them with a gain
+ * per track into interleaved 16-bit frames of channelCount channels.
+ *
+ * Tracks are processed in blocks small enough to stay in the L1 cache: each
+ * track is resampled into the block, then converted to float, routed to the
+ * output channels, scaled and added to the mix in a single SIMD pass. The
+ * mix is clipped once, when written out. Reads take no locks and don't
+ * allocate memory. A track which underflows contributes silence for the
+ * frames it could not provide.
+ *
+ * Like OEAudioResampler, the mixer expects 16-bit samples from the core.
+ * -write:maxLength: is not supported.
+ */
+@interface OEAudioMixer : NSObject <OEAudioBuffer>
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithGameCore:(OEGameCore *)gameCore outputSampleRate:(double)outputSampleRate channelCount:(NSUInteger)channelCount NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) NSUInteger trackCount;
+@property (readonly) double outputSampleRate;
+@property (readonly) NSUInteger channelCount;
+
+/// The linear gain of a track. Can be changed from any thread. Defaults to 1.
+- (float)gainForTrack:(NSUInteger)track;
+- (void)setGain:(float)gain forTrack:(NSUInteger)track;
+
+/// Forwarded to the resampler of every track. See -[OEAudioResampler rateAdjustment].
+@property double rateAdjustment;
+
+@end
+
+NS_ASSUME_NONNULL_END
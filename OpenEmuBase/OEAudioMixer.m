@@ -0,0 +1,200 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEAudioMixer.h"
+#import "OEAudioResampler.h"
+#import "OEAudioConversion.h"
+#import "OEGameCore.h"
+#import <stdatomic.h>
+
+/// The number of frames mixed at a time.
+static const NSUInteger OEAudioMixerBlockSize = 256;
+
+@implementation OEAudioMixer
+{
+    NSArray<OEAudioResampler *> *_resamplers;
+    OEAudioBufferReadBlock __strong *_readTrack;
+    OEAudioConverter **_trackConverters;
+    NSUInteger *_trackFrameSizes;
+    _Atomic float *_gains;
+
+    OEAudioConverter *_outputConverter;
+    int16_t *_trackSamples;
+    float *_mix;
+}
+
+- (instancetype)initWithGameCore:(OEGameCore *)gameCore outputSampleRate:(double)outputSampleRate channelCount:(NSUInteger)channelCount
+{
+    NSParameterAssert(channelCount > 0);
+
+    if((self = [super init]))
+    {
+        _trackCount = [gameCore audioBufferCount];
+        _outputSampleRate = outputSampleRate;
+        _channelCount = channelCount;
+
+        NSMutableArray<OEAudioResampler *> *resamplers = [NSMutableArray arrayWithCapacity:_trackCount];
+        _readTrack = (__strong OEAudioBufferReadBlock *)calloc(_trackCount, sizeof(OEAudioBufferReadBlock));
+        _trackConverters = calloc(_trackCount, sizeof(OEAudioConverter *));
+        _trackFrameSizes = calloc(_trackCount, sizeof(NSUInteger));
+        _gains = calloc(_trackCount, sizeof(_Atomic float));
+
+        OEAudioFormat mixFormat = { OEAudioSampleTypeFloat32, (uint32_t)channelCount, false };
+        NSUInteger maximumTrackChannelCount = 1;
+        for(NSUInteger track = 0; track < _trackCount; track++)
+        {
+            NSUInteger trackChannelCount = [gameCore channelCountForBuffer:track];
+            OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:[gameCore audioBufferAtIndex:track]
+                                                                            channelCount:trackChannelCount
+                                                                         inputSampleRate:[gameCore audioSampleRateForBuffer:track]
+                                                                        outputSampleRate:outputSampleRate
+                                                                            filterLength:32];
+            [resamplers addObject:resampler];
+            _readTrack[track] = [resampler readBlock];
+
+            OEAudioFormat trackFormat = { OEAudioSampleTypeInt16, (uint32_t)trackChannelCount, false };
+            _trackConverters[track] = OEAudioConverterCreate(&trackFormat, &mixFormat);
+            _trackFrameSizes[track] = trackChannelCount * sizeof(int16_t);
+            atomic_init(&_gains[track], 1.0f);
+            maximumTrackChannelCount = MAX(maximumTrackChannelCount, trackChannelCount);
+        }
+        _resamplers = resamplers;
+
+        OEAudioFormat outputFormat = { OEAudioSampleTypeInt16, (uint32_t)channelCount, false };
+        _outputConverter = OEAudioConverterCreate(&mixFormat, &outputFormat);
+        _trackSamples = calloc(OEAudioMixerBlockSize * maximumTrackChannelCount, sizeof(int16_t));
+        _mix = calloc(OEAudioMixerBlockSize * channelCount, sizeof(float));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for(NSUInteger track = 0; track < _trackCount; track++)
+    {
+        _readTrack[track] = nil;
+        OEAudioConverterDestroy(_trackConverters[track]);
+    }
+    free(_readTrack);
+    free(_trackConverters);
+    free(_trackFrameSizes);
+    free(_gains);
+    OEAudioConverterDestroy(_outputConverter);
+    free(_trackSamples);
+    free(_mix);
+}
+
+#pragma mark - Properties
+
+- (float)gainForTrack:(NSUInteger)track
+{
+    NSParameterAssert(track < _trackCount);
+    return atomic_load_explicit(&_gains[track], memory_order_relaxed);
+}
+
+- (void)setGain:(float)gain forTrack:(NSUInteger)track
+{
+    NSParameterAssert(track < _trackCount);
+    atomic_store_explicit(&_gains[track], gain, memory_order_relaxed);
+}
+
+- (double)rateAdjustment
+{
+    return _resamplers.firstObject.rateAdjustment ?: 1;
+}
+
+- (void)setRateAdjustment:(double)rateAdjustment
+{
+    for(OEAudioResampler *resampler in _resamplers)
+        resampler.rateAdjustment = rateAdjustment;
+}
+
+- (NSUInteger)length
+{
+    NSUInteger frameCount = NSUIntegerMax;
+    for(NSUInteger track = 0; track < _trackCount; track++)
+        frameCount = MIN(frameCount, _resamplers[track].length / _trackFrameSizes[track]);
+    return frameCount * _channelCount * sizeof(int16_t);
+}
+
+#pragma mark - Reading
+
+static NSUInteger OEAudioMixerRead(OEAudioMixer *mixer, void *outBuffer, NSUInteger length)
+{
+    const NSUInteger frameSize = mixer->_channelCount * sizeof(int16_t);
+    const NSUInteger frameCount = length / frameSize;
+    NSUInteger mixed = 0;
+
+    while(mixed < frameCount)
+    {
+        NSUInteger blockFrames = MIN(frameCount - mixed, OEAudioMixerBlockSize);
+        NSUInteger produced = 0;
+        memset(mixer->_mix, 0, blockFrames * mixer->_channelCount * sizeof(float));
+
+        for(NSUInteger track = 0; track < mixer->_trackCount; track++)
+        {
+            NSUInteger trackFrameSize = mixer->_trackFrameSizes[track];
+            NSUInteger received = mixer->_readTrack[track](mixer->_trackSamples, blockFrames * trackFrameSize) / trackFrameSize;
+            if(received == 0)
+                continue;
+
+            OEAudioConverter *converter = mixer->_trackConverters[track];
+            OEAudioConverterSetGain(converter, atomic_load_explicit(&mixer->_gains[track], memory_order_relaxed));
+            OEAudioConverterMix(converter, (const void *[]){ mixer->_trackSamples }, (void *[]){ mixer->_mix }, received);
+            produced = MAX(produced, received);
+        }
+
+        if(produced == 0)
+            break;
+
+        OEAudioConverterConvert(mixer->_outputConverter, (const void *[]){ mixer->_mix }, (void *[]){ (uint8_t *)outBuffer + mixed * frameSize }, produced);
+        mixed += produced;
+        if(produced < blockFrames)
+            break;
+    }
+
+    return mixed * frameSize;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    return OEAudioMixerRead(self, buffer, len);
+}
+
+- (OEAudioBufferReadBlock)readBlock
+{
+    return ^NSUInteger(void *buffer, NSUInteger len) {
+        return OEAudioMixerRead(self, buffer, len);
+    };
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    NSAssert(NO, @"%@ is read-only", self.class);
+    return 0;
+}
+
+@end
@@ -0,0 +1,93 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEAudioBuffer.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OEAudioResampler
+ * @abstract Converts the sample rate of the interleaved 16-bit audio read from another buffer.
+ * @discussion
+ * Cores output audio at their own rate, e.g. 32040 Hz, 44100 Hz or an odd
+ * NTSC-derived rate. A resampler reads from a core's audio buffer and can be
+ * handed to the audio output in its place.
+ *
+ * Conversion uses a windowed-sinc filter of filterLength taps with 256
+ * polyphase branches, interpolated linearly between adjacent branches, so any
+ * ratio is supported and the ratio can change between two reads without
+ * glitches. The filter is evaluated with SIMD vectors. When downsampling, the
+ * cutoff is lowered to the output Nyquist frequency to prevent aliasing.
+ *
+ * Reads take no locks and don't allocate memory, so they are safe on a
+ * realtime thread. Only a single thread may read from a resampler.
+ * -write:maxLength: is not supported.
+ */
+@interface OEAudioResampler : NSObject <OEAudioBuffer>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ * @method initWithSourceBuffer:channelCount:inputSampleRate:outputSampleRate:filterLength:
+ * @param source The buffer to read input samples from, e.g. -[OEGameCore audioBufferAtIndex:].
+ * @param filterLength The number of taps of the filter, rounded up to a multiple of 4.
+ * Longer filters attenuate aliasing better but cost more and add filterLength / 2 frames
+ * of latency. 32 is a good default; 8 is enough when upsampling.
+ */
+- (instancetype)initWithSourceBuffer:(id<OEAudioBuffer>)source channelCount:(NSUInteger)channelCount inputSampleRate:(double)inputSampleRate outputSampleRate:(double)outputSampleRate filterLength:(NSUInteger)filterLength NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) id<OEAudioBuffer> sourceBuffer;
+@property (readonly) NSUInteger channelCount;
+@property (readonly) double inputSampleRate;
+@property (readonly) double outputSampleRate;
+@property (readonly) NSUInteger filterLength;
+
+/*!
+ * @property rateAdjustment
+ * @abstract A factor applied to the input sample rate, for dynamic rate control.
+ * @discussion
+ * A value above 1 consumes input samples faster, e.g. to drain a source buffer
+ * that slowly fills up because the producer's clock runs ahead of the audio
+ * device's. Can be changed from any thread; takes effect on the next read.
+ * Clamped between 0.5 and 2. Defaults to 1.
+ *
+ * This is an alternative to -[OEGameCore controlsAudioRate], which adjusts
+ * the emulation speed instead. Don't set it from the core's
+ * audioRateAdjustment: consuming samples faster while the core produces them
+ * faster would cancel out the correction.
+ */
+@property double rateAdjustment;
+
+/// The number of output frames produced per input frame, including rateAdjustment.
+@property (readonly) double ratio;
+
+/// Discards the filter history. Must not be called while a read is in progress.
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,278 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEAudioResampler.h"
+#import <simd/simd.h>
+#import <stdatomic.h>
+
+/// The number of polyphase branches of the filter.
+static const NSUInteger OEAudioResamplerPhaseCount = 256;
+/// The largest number of output frames generated in one pass over the history.
+static const NSUInteger OEAudioResamplerFramesPerPass = 1024;
+
+static double OEBesselI0(double x)
+{
+    double sum = 1, term = 1;
+    for (int k = 1; k < 32 && term > 1e-12 * sum; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+@implementation OEAudioResampler
+{
+    OEAudioBufferReadBlock _readSource;
+    _Atomic double _rateAdjustment;
+
+    // (OEAudioResamplerPhaseCount + 1) branches of _filterLength taps.
+    float *_filter;
+    float *_kernel;
+
+    // Input frames converted to float, one array per channel. Output frame
+    // n is computed from the taps starting at floor(_position).
+    float **_history;
+    NSUInteger _historyCapacity;
+    NSUInteger _historyFrames;
+    double _position;
+
+    int16_t *_sourceSamples;
+}
+
+- (instancetype)initWithSourceBuffer:(id<OEAudioBuffer>)source channelCount:(NSUInteger)channelCount inputSampleRate:(double)inputSampleRate outputSampleRate:(double)outputSampleRate filterLength:(NSUInteger)filterLength
+{
+    NSParameterAssert(channelCount > 0 && inputSampleRate > 0 && outputSampleRate > 0);
+
+    if((self = [super init]))
+    {
+        _sourceBuffer = source;
+        _channelCount = channelCount;
+        _inputSampleRate = inputSampleRate;
+        _outputSampleRate = outputSampleRate;
+        _filterLength = MAX(4, (filterLength + 3) & ~(NSUInteger)3);
+        atomic_store(&_rateAdjustment, 1.0);
+
+        if ([source respondsToSelector:@selector(readBlock)])
+            _readSource = [source readBlock];
+        else
+            _readSource = ^NSUInteger(void *buffer, NSUInteger length) {
+                return [source read:buffer maxLength:length];
+            };
+
+        [self OE_buildFilter];
+
+        // Enough room for one pass at the largest rateAdjustment.
+        _historyCapacity = _filterLength + (NSUInteger)ceil(OEAudioResamplerFramesPerPass * 2 * inputSampleRate / outputSampleRate) + 2;
+        _history = calloc(channelCount, sizeof(float *));
+        for (NSUInteger channel = 0; channel < channelCount; channel++)
+            _history[channel] = calloc(_historyCapacity, sizeof(float));
+        _sourceSamples = calloc(_historyCapacity * channelCount, sizeof(int16_t));
+        _kernel = calloc(_filterLength, sizeof(float));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (NSUInteger channel = 0; channel < _channelCount; channel++)
+        free(_history[channel]);
+    free(_history);
+    free(_sourceSamples);
+    free(_kernel);
+    free(_filter);
+}
+
+- (void)OE_buildFilter
+{
+    // Kaiser-windowed sinc. The passband is narrowed by the expected
+    // transition width of the window, so that short filters still reject
+    // most of what lies above the cutoff.
+    const NSUInteger length = _filterLength;
+    const double beta = 8.0;
+    const double cutoff = MIN(1.0, _outputSampleRate / _inputSampleRate) * (1.0 - 2.0 / length);
+    const double windowNorm = OEBesselI0(beta);
+
+    _filter = calloc((OEAudioResamplerPhaseCount + 1) * length, sizeof(float));
+    for (NSUInteger phase = 0; phase <= OEAudioResamplerPhaseCount; phase++) {
+        double fraction = (double)phase / OEAudioResamplerPhaseCount;
+        for (NSUInteger tap = 0; tap < length; tap++) {
+            double x = (double)tap - (double)(length / 2 - 1) - fraction;
+            double sinc = x == 0 ? 1 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+            double r = x / (length / 2.0);
+            double window = fabs(r) >= 1 ? 0 : OEBesselI0(beta * sqrt(1 - r * r)) / windowNorm;
+            _filter[phase * length + tap] = (float)(cutoff * sinc * window);
+        }
+    }
+}
+
+#pragma mark - Properties
+
+- (double)rateAdjustment
+{
+    return atomic_load_explicit(&_rateAdjustment, memory_order_relaxed);
+}
+
+- (void)setRateAdjustment:(double)rateAdjustment
+{
+    atomic_store_explicit(&_rateAdjustment, MAX(0.5, MIN(rateAdjustment, 2.0)), memory_order_relaxed);
+}
+
+- (double)ratio
+{
+    return _outputSampleRate / (_inputSampleRate * self.rateAdjustment);
+}
+
+- (NSUInteger)length
+{
+    NSUInteger frameSize = _channelCount * sizeof(int16_t);
+    return (NSUInteger)ceil(_sourceBuffer.length / frameSize * _outputSampleRate / _inputSampleRate) * frameSize;
+}
+
+- (void)reset
+{
+    _historyFrames = 0;
+    _position = 0;
+}
+
+#pragma mark - Reading
+
+static void OEAudioResamplerFetch(OEAudioResampler *resampler, NSUInteger frameCount)
+{
+    const NSUInteger channelCount = resampler->_channelCount;
+    frameCount = MIN(frameCount, resampler->_historyCapacity - resampler->_historyFrames);
+
+    NSUInteger bytes = resampler->_readSource(resampler->_sourceSamples, frameCount * channelCount * sizeof(int16_t));
+    NSUInteger received = bytes / (channelCount * sizeof(int16_t));
+
+    const int16_t *source = resampler->_sourceSamples;
+    for (NSUInteger channel = 0; channel < channelCount; channel++) {
+        float *history = resampler->_history[channel] + resampler->_historyFrames;
+        for (NSUInteger frame = 0; frame < received; frame++)
+            history[frame] = source[frame * channelCount + channel] * (1.0f / 32768.0f);
+    }
+    resampler->_historyFrames += received;
+}
+
+static void OEAudioResamplerDiscardConsumedFrames(OEAudioResampler *resampler)
+{
+    NSUInteger consumed = MIN((NSUInteger)resampler->_position, resampler->_historyFrames);
+    if (consumed == 0)
+        return;
+
+    NSUInteger remaining = resampler->_historyFrames - consumed;
+    for (NSUInteger channel = 0; channel < resampler->_channelCount; channel++)
+        memmove(resampler->_history[channel], resampler->_history[channel] + consumed, remaining * sizeof(float));
+    resampler->_historyFrames = remaining;
+    resampler->_position -= consumed;
+}
+
+static NSUInteger OEAudioResamplerGenerate(OEAudioResampler *resampler, int16_t *output, NSUInteger frameCount, double step)
+{
+    const NSUInteger length = resampler->_filterLength;
+    const NSUInteger channelCount = resampler->_channelCount;
+    float *kernel = resampler->_kernel;
+    double position = resampler->_position;
+    NSUInteger frame = 0;
+
+    for (; frame < frameCount; frame++) {
+        NSUInteger base = (NSUInteger)position;
+        if (base + length > resampler->_historyFrames)
+            break;
+
+        // Interpolate the kernel between the two nearest branches.
+        double phase = (position - base) * OEAudioResamplerPhaseCount;
+        NSUInteger branch = (NSUInteger)phase;
+        float weight = (float)(phase - branch);
+        const float *lower = resampler->_filter + branch * length;
+        const float *upper = lower + length;
+        for (NSUInteger tap = 0; tap < length; tap += 4) {
+            simd_float4 a = *(const simd_packed_float4 *)(lower + tap);
+            simd_float4 b = *(const simd_packed_float4 *)(upper + tap);
+            *(simd_packed_float4 *)(kernel + tap) = a + (b - a) * weight;
+        }
+
+        for (NSUInteger channel = 0; channel < channelCount; channel++) {
+            const float *input = resampler->_history[channel] + base;
+            simd_float4 sum = 0;
+            for (NSUInteger tap = 0; tap < length; tap += 4)
+                sum += *(const simd_packed_float4 *)(kernel + tap) * *(const simd_packed_float4 *)(input + tap);
+
+            float sample = simd_reduce_add(sum) * 32768.0f;
+            output[frame * channelCount + channel] = (int16_t)rintf(simd_clamp(sample, -32768.0f, 32767.0f));
+        }
+
+        position += step;
+    }
+
+    resampler->_position = position;
+    return frame;
+}
+
+static NSUInteger OEAudioResamplerRead(OEAudioResampler *resampler, void *outBuffer, NSUInteger length)
+{
+    const NSUInteger frameSize = resampler->_channelCount * sizeof(int16_t);
+    const double step = resampler->_inputSampleRate * atomic_load_explicit(&resampler->_rateAdjustment, memory_order_relaxed) / resampler->_outputSampleRate;
+    NSUInteger frameCount = length / frameSize;
+    NSUInteger produced = 0;
+
+    while (produced < frameCount) {
+        OEAudioResamplerDiscardConsumedFrames(resampler);
+
+        // Fetch exactly the input needed for this pass, so a source that
+        // anticipates underflow is not asked for more than necessary.
+        NSUInteger passFrames = MIN(frameCount - produced, OEAudioResamplerFramesPerPass);
+        NSUInteger needed = (NSUInteger)(resampler->_position + (passFrames - 1) * step) + resampler->_filterLength;
+        if (needed > resampler->_historyFrames)
+            OEAudioResamplerFetch(resampler, needed - resampler->_historyFrames);
+
+        NSUInteger generated = OEAudioResamplerGenerate(resampler, (int16_t *)outBuffer + produced * resampler->_channelCount, passFrames, step);
+        produced += generated;
+        if (generated < passFrames)
+            break;
+    }
+
+    return produced * frameSize;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    return OEAudioResamplerRead(self, buffer, len);
+}
+
+- (OEAudioBufferReadBlock)readBlock
+{
+    return ^NSUInteger(void *buffer, NSUInteger len) {
+        return OEAudioResamplerRead(self, buffer, len);
+    };
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    NSAssert(NO, @"%@ is read-only", self.class);
+    return 0;
+}
+
+@end
@@ -0,0 +1,89 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEAudioBuffer.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OEAudioTimeStretcher
+ * @abstract Changes the speed of the interleaved 16-bit audio read from another buffer without changing its pitch.
+ * @discussion
+ * While a core runs faster or slower than real time, it produces audio at
+ * rate times the normal speed. A time stretcher reads it from the core's
+ * audio buffer and outputs real-time audio at the original pitch, instead of
+ * sped-up chipmunk audio or audio with dropped chunks.
+ *
+ * Stretching uses WSOLA: the output is an overlap-add of Hann windowed
+ * segments of 20 ms, each taken from around the position in the input
+ * corresponding to rate times the output position. Each segment is shifted
+ * by up to 10 ms to the offset where it best continues the previous one, as
+ * found by normalized cross-correlation over all channels, evaluated with
+ * SIMD vectors. The cost per output frame doesn't depend on the rate; input
+ * skipped at high rates is only copied out of the source.
+ *
+ * At a rate of 1, reads pass through to the source unchanged. Changing the
+ * rate, to or from 1, doesn't cause discontinuities.
+ *
+ * Reads take no locks and don't allocate memory, so they are safe on a
+ * realtime thread. Only a single thread may read from a time stretcher.
+ * -write:maxLength: is not supported.
+ */
+@interface OEAudioTimeStretcher : NSObject <OEAudioBuffer>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ * @method initWithSourceBuffer:channelCount:sampleRate:
+ * @param source The buffer to read input samples from, e.g. -[OEGameCore ringBufferAtIndex:].
+ * @param sampleRate The sample rate of both the input and the output, which determines the segment length.
+ */
+- (instancetype)initWithSourceBuffer:(id<OEAudioBuffer>)source channelCount:(NSUInteger)channelCount sampleRate:(double)sampleRate;
+
+@property (readonly) id<OEAudioBuffer> sourceBuffer;
+@property (readonly) NSUInteger channelCount;
+@property (readonly) double sampleRate;
+
+/*!
+ * @property rate
+ * @abstract The speed of the input relative to real time, e.g. 2 when a core runs at double speed.
+ * @discussion
+ * Can be changed from any thread; takes effect at the next segment.
+ * Clamped between 0.25 and 8. Defaults to 1.
+ */
+@property double rate;
+
+/// YES if the rate is 1 and no stretched audio is buffered, so reading the
+/// source directly returns the same audio. Only meaningful on the reading thread.
+@property (readonly) BOOL passesThrough;
+
+/// Discards the buffered input and output. Must not be called while a read is in progress.
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
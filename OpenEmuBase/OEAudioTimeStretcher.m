@@ -0,0 +1,375 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEAudioTimeStretcher.h"
+#import "OEAudioTimeStretcher_Internal.h"
+#import <simd/simd.h>
+#import <stdatomic.h>
+
+@implementation OEAudioTimeStretcher
+{
+    OEAudioBufferReadBlock _readSource;
+    _Atomic double _rate;
+
+    // Segments are 2 * _hopFrames long, one starts every _hopFrames output
+    // frames, and each may be shifted by up to _searchFrames either way.
+    NSUInteger _hopFrames;
+    NSUInteger _searchFrames;
+    // The Hann window, with each value repeated for every channel.
+    float *_window;
+
+    // Input frames converted to float, interleaved. The first frame is
+    // input frame _historyStart.
+    float *_history;
+    double *_energy;
+    NSUInteger _historyCapacity;
+    NSUInteger _historyFrames;
+    uint64_t _historyStart;
+    int16_t *_sourceSamples;
+
+    // Whether the last output came from a segment, which the next output
+    // must continue, rather than straight from the source.
+    BOOL _stretching;
+    // The input frame the next segment would start at if it wasn't shifted.
+    double _position;
+    // The input frame the last segment started at.
+    uint64_t _segmentStart;
+    // The second half of the last segment, windowed and as is.
+    float *_tail;
+    float *_template;
+
+    // Output frames not returned yet.
+    float *_segment;
+    int16_t *_output;
+    NSUInteger _outputFrames;
+    NSUInteger _outputOffset;
+}
+
+- (instancetype)initWithSourceBuffer:(id<OEAudioBuffer>)source channelCount:(NSUInteger)channelCount sampleRate:(double)sampleRate
+{
+    OEAudioBufferReadBlock readBlock;
+    if ([source respondsToSelector:@selector(readBlock)])
+        readBlock = [source readBlock];
+    else
+        readBlock = ^NSUInteger(void *buffer, NSUInteger length) {
+            return [source read:buffer maxLength:length];
+        };
+
+    if((self = [self initWithReadBlock:readBlock channelCount:channelCount sampleRate:sampleRate]))
+        _sourceBuffer = source;
+    return self;
+}
+
+- (instancetype)initWithReadBlock:(OEAudioBufferReadBlock)readBlock channelCount:(NSUInteger)channelCount sampleRate:(double)sampleRate
+{
+    NSParameterAssert(channelCount > 0 && sampleRate > 0);
+
+    if((self = [super init]))
+    {
+        _readSource = readBlock;
+        _channelCount = channelCount;
+        _sampleRate = sampleRate;
+        atomic_store(&_rate, 1.0);
+
+        // 10 ms hops, rounded to a multiple of 4 frames for the SIMD loops.
+        _hopFrames = MAX(4, (NSUInteger)lround(sampleRate * 0.01 / 4) * 4);
+        _searchFrames = _hopFrames;
+
+        // A periodic Hann window of two hops, so that overlapping halves add up to 1.
+        NSUInteger segmentFrames = 2 * _hopFrames;
+        _window = calloc(segmentFrames * channelCount, sizeof(float));
+        for (NSUInteger frame = 0; frame < segmentFrames; frame++)
+            for (NSUInteger channel = 0; channel < channelCount; channel++)
+                _window[frame * channelCount + channel] = (float)(0.5 - 0.5 * cos(2 * M_PI * frame / segmentFrames));
+
+        // A segment and the frames it may be shifted over.
+        _historyCapacity = 2 * _searchFrames + segmentFrames;
+        _history = calloc(_historyCapacity * channelCount, sizeof(float));
+        _energy = calloc(_historyCapacity + 1, sizeof(double));
+        _sourceSamples = calloc(_historyCapacity * channelCount, sizeof(int16_t));
+
+        _tail = calloc(_hopFrames * channelCount, sizeof(float));
+        _template = calloc(_hopFrames * channelCount, sizeof(float));
+        _segment = calloc(_hopFrames * channelCount, sizeof(float));
+        _output = calloc(_historyCapacity * channelCount, sizeof(int16_t));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_window);
+    free(_history);
+    free(_energy);
+    free(_sourceSamples);
+    free(_tail);
+    free(_template);
+    free(_segment);
+    free(_output);
+}
+
+#pragma mark - Properties
+
+- (double)rate
+{
+    return atomic_load_explicit(&_rate, memory_order_relaxed);
+}
+
+- (void)setRate:(double)rate
+{
+    atomic_store_explicit(&_rate, MAX(0.25, MIN(rate, 8.0)), memory_order_relaxed);
+}
+
+- (BOOL)passesThrough
+{
+    return atomic_load_explicit(&_rate, memory_order_relaxed) == 1 && !_stretching && _historyFrames == 0 && _outputOffset >= _outputFrames;
+}
+
+- (NSUInteger)length
+{
+    return _sourceBuffer.length;
+}
+
+- (void)reset
+{
+    _historyFrames = 0;
+    _stretching = NO;
+    _outputFrames = 0;
+    _outputOffset = 0;
+}
+
+#pragma mark - Reading
+
+/// Makes the history hold the input frames from start to start + frameCount,
+/// reading and dropping the frames before start. Returns NO if the source
+/// runs out; the frames read so far are kept for the next attempt.
+static BOOL OEAudioTimeStretcherFetch(OEAudioTimeStretcher *stretcher, uint64_t start, NSUInteger frameCount)
+{
+    const NSUInteger channelCount = stretcher->_channelCount;
+    const NSUInteger frameSize = channelCount * sizeof(int16_t);
+
+    NSUInteger dropped = (NSUInteger)MIN(start - stretcher->_historyStart, stretcher->_historyFrames);
+    if (dropped > 0) {
+        stretcher->_historyFrames -= dropped;
+        memmove(stretcher->_history, stretcher->_history + dropped * channelCount, stretcher->_historyFrames * channelCount * sizeof(float));
+        stretcher->_historyStart += dropped;
+    }
+
+    // At high rates, whole stretches of input fall between two segments.
+    while (stretcher->_historyStart < start) {
+        NSUInteger skipped = (NSUInteger)MIN(start - stretcher->_historyStart, stretcher->_historyCapacity);
+        NSUInteger received = stretcher->_readSource(stretcher->_sourceSamples, skipped * frameSize) / frameSize;
+        stretcher->_historyStart += received;
+        if (received < skipped)
+            return NO;
+    }
+
+    if (stretcher->_historyFrames >= frameCount)
+        return YES;
+
+    NSUInteger needed = frameCount - stretcher->_historyFrames;
+    NSUInteger received = stretcher->_readSource(stretcher->_sourceSamples, needed * frameSize) / frameSize;
+
+    const int16_t *source = stretcher->_sourceSamples;
+    float *history = stretcher->_history + stretcher->_historyFrames * channelCount;
+    for (NSUInteger i = 0; i < received * channelCount; i++)
+        history[i] = source[i] * (1.0f / 32768.0f);
+    stretcher->_historyFrames += received;
+
+    return received == needed;
+}
+
+/// Returns the offset into the history, between 0 and 2 * _searchFrames, at
+/// which a segment best continues the last one.
+static NSUInteger OEAudioTimeStretcherBestOffset(OEAudioTimeStretcher *stretcher)
+{
+    const NSUInteger channelCount = stretcher->_channelCount;
+    const NSUInteger hopSamples = stretcher->_hopFrames * channelCount;
+    const NSUInteger maxOffset = 2 * stretcher->_searchFrames;
+    const float *history = stretcher->_history;
+    const float *template = stretcher->_template;
+
+    // The energy of any candidate is the difference of two prefix sums.
+    double *energy = stretcher->_energy;
+    energy[0] = 0;
+    for (NSUInteger frame = 0; frame < maxOffset + stretcher->_hopFrames; frame++) {
+        double sum = 0;
+        for (NSUInteger channel = 0; channel < channelCount; channel++)
+            sum += (double)history[frame * channelCount + channel] * history[frame * channelCount + channel];
+        energy[frame + 1] = energy[frame] + sum;
+    }
+
+    NSUInteger best = maxOffset / 2;
+    float bestScore = -INFINITY;
+
+    // Search every other offset, then refine around the best one.
+    for (NSUInteger pass = 0; pass < 2; pass++) {
+        NSUInteger first = pass == 0 ? 0 : (best > 0 ? best - 1 : 0);
+        NSUInteger last = pass == 0 ? maxOffset : MIN(best + 1, maxOffset);
+        NSUInteger step = pass == 0 ? 2 : 1;
+        for (NSUInteger offset = first; offset <= last; offset += step) {
+            const float *candidate = history + offset * channelCount;
+            simd_float4 sum = 0;
+            for (NSUInteger i = 0; i < hopSamples; i += 4)
+                sum += *(const simd_packed_float4 *)(template + i) * *(const simd_packed_float4 *)(candidate + i);
+
+            float score = simd_reduce_add(sum) / sqrtf((float)(energy[offset + stretcher->_hopFrames] - energy[offset]) + 1e-9f);
+            if (score > bestScore) {
+                bestScore = score;
+                best = offset;
+            }
+        }
+    }
+
+    return best;
+}
+
+static void OEAudioTimeStretcherEmit(OEAudioTimeStretcher *stretcher, const float *frames, NSUInteger frameCount)
+{
+    NSUInteger sampleCount = frameCount * stretcher->_channelCount;
+    for (NSUInteger i = 0; i < sampleCount; i++)
+        stretcher->_output[i] = (int16_t)rintf(simd_clamp(frames[i] * 32768.0f, -32768.0f, 32767.0f));
+    stretcher->_outputFrames = frameCount;
+    stretcher->_outputOffset = 0;
+}
+
+/// Outputs the next segment, overlapped with the last one.
+static BOOL OEAudioTimeStretcherNextSegment(OEAudioTimeStretcher *stretcher, double rate)
+{
+    const NSUInteger channelCount = stretcher->_channelCount;
+    const NSUInteger hopFrames = stretcher->_hopFrames;
+    const NSUInteger hopSamples = hopFrames * channelCount;
+    const NSUInteger searchFrames = stretcher->_searchFrames;
+    NSUInteger offset;
+
+    if (!stretcher->_stretching) {
+        // Continue from the next unread frame, which needs no crossfade.
+        // The segment counts as shifted back as far as possible, so that
+        // the next ones never start before it, even at low rates.
+        uint64_t start = stretcher->_historyStart;
+        if (!OEAudioTimeStretcherFetch(stretcher, start, 2 * hopFrames))
+            return NO;
+
+        offset = 0;
+        memcpy(stretcher->_segment, stretcher->_history, hopSamples * sizeof(float));
+        stretcher->_position = start + searchFrames;
+        stretcher->_stretching = YES;
+    } else {
+        uint64_t regionStart = (uint64_t)stretcher->_position - searchFrames;
+        if (!OEAudioTimeStretcherFetch(stretcher, regionStart, stretcher->_historyCapacity))
+            return NO;
+
+        offset = OEAudioTimeStretcherBestOffset(stretcher);
+        const float *input = stretcher->_history + offset * channelCount;
+        for (NSUInteger i = 0; i < hopSamples; i += 4)
+            *(simd_packed_float4 *)(stretcher->_segment + i) = *(const simd_packed_float4 *)(stretcher->_tail + i) + *(const simd_packed_float4 *)(stretcher->_window + i) * *(const simd_packed_float4 *)(input + i);
+    }
+
+    // Keep the second half to overlap with the next segment, and as is to
+    // find where the next segment continues it best.
+    const float *secondHalf = stretcher->_history + (offset + hopFrames) * channelCount;
+    for (NSUInteger i = 0; i < hopSamples; i += 4)
+        *(simd_packed_float4 *)(stretcher->_tail + i) = *(const simd_packed_float4 *)(stretcher->_window + hopSamples + i) * *(const simd_packed_float4 *)(secondHalf + i);
+    memcpy(stretcher->_template, secondHalf, hopSamples * sizeof(float));
+
+    stretcher->_segmentStart = stretcher->_historyStart + offset;
+    stretcher->_position += rate * hopFrames;
+    OEAudioTimeStretcherEmit(stretcher, stretcher->_segment, hopFrames);
+    return YES;
+}
+
+/// Outputs the unread input in the history, so reads can go straight to
+/// the source again. The input following the last segment continues it
+/// without a crossfade.
+static void OEAudioTimeStretcherFlushHistory(OEAudioTimeStretcher *stretcher)
+{
+    NSUInteger first = 0;
+    if (stretcher->_stretching) {
+        // A fetch which ran out of input may have dropped the frames following
+        // the last segment, or not read them yet. Continue from what is left.
+        uint64_t next = stretcher->_segmentStart + stretcher->_hopFrames;
+        if (next > stretcher->_historyStart)
+            first = (NSUInteger)MIN(next - stretcher->_historyStart, stretcher->_historyFrames);
+    }
+    OEAudioTimeStretcherEmit(stretcher, stretcher->_history + first * stretcher->_channelCount, stretcher->_historyFrames - first);
+
+    stretcher->_historyStart += stretcher->_historyFrames;
+    stretcher->_historyFrames = 0;
+    stretcher->_stretching = NO;
+}
+
+static NSUInteger OEAudioTimeStretcherRead(OEAudioTimeStretcher *stretcher, void *outBuffer, NSUInteger length)
+{
+    const NSUInteger channelCount = stretcher->_channelCount;
+    const NSUInteger frameSize = channelCount * sizeof(int16_t);
+    NSUInteger frameCount = length / frameSize;
+    NSUInteger produced = 0;
+
+    while (produced < frameCount) {
+        if (stretcher->_outputOffset < stretcher->_outputFrames) {
+            NSUInteger count = MIN(frameCount - produced, stretcher->_outputFrames - stretcher->_outputOffset);
+            memcpy((int16_t *)outBuffer + produced * channelCount, stretcher->_output + stretcher->_outputOffset * channelCount, count * frameSize);
+            stretcher->_outputOffset += count;
+            produced += count;
+            continue;
+        }
+
+        double rate = atomic_load_explicit(&stretcher->_rate, memory_order_relaxed);
+        if (rate != 1) {
+            if (!OEAudioTimeStretcherNextSegment(stretcher, rate))
+                break;
+        } else if (stretcher->_stretching || stretcher->_historyFrames > 0) {
+            OEAudioTimeStretcherFlushHistory(stretcher);
+        } else {
+            NSUInteger received = stretcher->_readSource((int16_t *)outBuffer + produced * channelCount, (frameCount - produced) * frameSize) / frameSize;
+            stretcher->_historyStart += received;
+            produced += received;
+            break;
+        }
+    }
+
+    return produced * frameSize;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    return OEAudioTimeStretcherRead(self, buffer, len);
+}
+
+- (OEAudioBufferReadBlock)readBlock
+{
+    return ^NSUInteger(void *buffer, NSUInteger len) {
+        return OEAudioTimeStretcherRead(self, buffer, len);
+    };
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    NSAssert(NO, @"%@ is read-only", self.class);
+    return 0;
+}
+
+@end
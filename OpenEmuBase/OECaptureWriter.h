@@ -0,0 +1,107 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OECaptureWriter
+ * @abstract Records the audio and video produced by a core to files.
+ * @discussion
+ * Audio is written as a WAV file and video as a YUV4MPEG2 (Y4M) stream,
+ * which ffmpeg and most editors read directly.
+ *
+ * Assign the writer to OEGameCore.captureWriter. Audio is tapped from the
+ * core's first OERingBuffer as the core writes it, so the audio device
+ * still reads every sample. Video frames are copied by -appendVideoFrame:
+ * into a frame pool allocated when the writer is attached. A background
+ * thread converts and writes both; the core thread never waits for it or
+ * for the disk. When the writer falls behind, frames and audio which don't
+ * fit are dropped and counted. Dropped or missing video frames are replaced
+ * by the previous frame and dropped audio by silence, so both files keep
+ * the timing of the emulation.
+ *
+ * A writer can only be attached to one core, once.
+ */
+@interface OECaptureWriter : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ * @method initWithAudioURL:videoURL:error:
+ * @abstract Creates the output files.
+ * @param audioURL Where to write the WAV file, or nil to not record audio.
+ * @param videoURL Where to write the Y4M file, or nil to not record video.
+ */
+- (nullable instancetype)initWithAudioURL:(nullable NSURL *)audioURL videoURL:(nullable NSURL *)videoURL error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+@property (readonly, nullable) NSURL *audioURL;
+@property (readonly, nullable) NSURL *videoURL;
+
+/// The number of video frames which can wait for the writer thread.
+/// Must be set before the writer is attached. Defaults to 8.
+@property (nonatomic) NSUInteger videoFramePoolSize;
+
+/// How much audio can wait for the writer thread.
+/// Must be set before the writer is attached. Defaults to 1 second.
+@property (nonatomic) NSTimeInterval audioBufferDuration;
+
+/*!
+ * @method appendVideoFrame:
+ * @abstract Copies the frame a bitmap core has just drawn into the frame pool.
+ * @discussion
+ * Call on the core thread from -[OERenderDelegate didExecute], with the
+ * buffer returned by -[OEGameCore getVideoBufferWithHint:] for the frame.
+ * The screenRect of the core is copied. Frames which are not appended, e.g.
+ * because they were skipped, repeat the previous frame in the video file.
+ * @returns NO if the frame was dropped because the pool is full, or if the
+ * writer isn't recording video.
+ */
+- (BOOL)appendVideoFrame:(const void *)pixels;
+
+/*!
+ * @method finishWriting
+ * @abstract Writes everything still queued and closes the files.
+ * @discussion Blocks until the writer thread is done. Anything the core
+ * produces afterwards is ignored. Called when the writer is deallocated.
+ */
+- (void)finishWriting;
+
+@property (readonly, getter=isFinished) BOOL finished;
+
+/// The number of video frames written so far, including repeated frames.
+@property (readonly) NSUInteger writtenVideoFrameCount;
+/// The number of video frames dropped because the frame pool was full.
+@property (readonly) NSUInteger droppedVideoFrameCount;
+/// The number of audio frames written so far, including silence.
+@property (readonly) NSUInteger writtenAudioFrameCount;
+/// The number of audio frames dropped because the audio buffer was full.
+@property (readonly) NSUInteger droppedAudioFrameCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,553 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OECaptureWriter.h"
+#import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
+#import "OERingBuffer.h"
+#import "OERingBuffer_Internal.h"
+#import "TPCircularBuffer.h"
+#import "OELogging.h"
+#import <stdatomic.h>
+#import <stdio.h>
+
+#pragma mark - Pixel Formats
+
+/// Converts a row of 8-bit RGBA pixels to BT.601 limited range Y, Cb and Cr.
+static void OECaptureConvertRow(const uint8_t *rgba, uint8_t *y, uint8_t *u, uint8_t *v, NSUInteger width)
+{
+    for (NSUInteger i = 0; i < width; i++, rgba += 4) {
+        int r = rgba[0], g = rgba[1], b = rgba[2];
+        y[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+        u[i] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+        v[i] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+    }
+}
+
+static NSInteger OECaptureGCD(NSInteger a, NSInteger b)
+{
+    while (b != 0) {
+        NSInteger t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+#pragma mark -
+
+/// A frame in the pool.
+typedef struct {
+    uint8_t *pixels;
+    NSUInteger width;
+    NSUInteger height;
+    /// How many times the previous frame is repeated before this one.
+    NSUInteger repeatCount;
+} OECaptureVideoFrame;
+
+/// Precedes each write in the audio buffer.
+typedef struct {
+    /// Bytes of silence to write before the chunk, for dropped audio.
+    uint64_t silenceLength;
+    uint64_t length;
+} OECaptureAudioChunk;
+
+static const NSTimeInterval OECaptureWakeUpInterval = 0.1;
+
+@implementation OECaptureWriter
+{
+    FILE *_audioFile;
+    FILE *_videoFile;
+    NSThread *_thread;
+    dispatch_semaphore_t _wakeSemaphore;
+    dispatch_semaphore_t _doneSemaphore;
+    atomic_bool _finishing;
+    // Core thread only.
+    BOOL _attached;
+    __weak OEGameCore *_gameCore;
+
+    // Audio, written by the tap of the core's ring buffer.
+    OERingBuffer *_tappedBuffer;
+    TPCircularBuffer _audioBuffer;
+    BOOL _hasAudioBuffer;
+    NSUInteger _audioChannelCount;
+    NSUInteger _audioBitDepth;
+    double _audioSampleRate;
+    _Atomic(uint64_t) _pendingSilenceLength;
+    _Atomic(uint64_t) _droppedAudioBytes;
+    _Atomic(uint64_t) _writtenAudioBytes;
+
+    // Video. The pool is a ring of frames with a single producer, the core
+    // thread, and a single consumer, the writer thread.
+    OECaptureVideoFrame *_videoFrames;
+    NSUInteger _videoFrameCount;
+    NSUInteger _maximumFrameWidth;
+    NSUInteger _maximumFrameHeight;
+    NSUInteger _bytesPerPixel;
+    OEPixelConverter *_converter;
+    double _frameRate;
+    OEIntSize _aspectSize;
+    _Atomic(uint64_t) _queuedFrameCount;
+    _Atomic(uint64_t) _dequeuedFrameCount;
+    // Frames to repeat before the next queued frame. Core thread only, except when finishing.
+    _Atomic(NSUInteger) _pendingRepeatCount;
+    BOOL _frameAppended;
+    _Atomic(NSUInteger) _droppedVideoFrameCount;
+    _Atomic(NSUInteger) _writtenVideoFrameCount;
+
+    // Writer thread only.
+    NSUInteger _outputWidth;
+    NSUInteger _outputHeight;
+    uint8_t *_rgbaRow;
+    // The Y, Cb and Cr planes of the last frame written.
+    uint8_t *_planes;
+}
+
+- (instancetype)initWithAudioURL:(NSURL *)audioURL videoURL:(NSURL *)videoURL error:(NSError **)error
+{
+    if ((self = [super init])) {
+        _audioURL = [audioURL copy];
+        _videoURL = [videoURL copy];
+        _videoFramePoolSize = 8;
+        _audioBufferDuration = 1;
+        _wakeSemaphore = dispatch_semaphore_create(0);
+        _doneSemaphore = dispatch_semaphore_create(0);
+
+        if (audioURL != nil) {
+            _audioFile = fopen(audioURL.fileSystemRepresentation, "wb");
+            if (_audioFile == NULL) {
+                if (error != NULL)
+                    *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : audioURL }];
+                return nil;
+            }
+            // Filled in by -finishWriting, once the length is known.
+            uint8_t header[44] = { 0 };
+            fwrite(header, sizeof(header), 1, _audioFile);
+        }
+
+        if (videoURL != nil) {
+            _videoFile = fopen(videoURL.fileSystemRepresentation, "wb");
+            if (_videoFile == NULL) {
+                if (error != NULL)
+                    *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : videoURL }];
+                return nil;
+            }
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self finishWriting];
+    _tappedBuffer.writeTap = nil;
+
+    if (_hasAudioBuffer)
+        TPCircularBufferCleanup(&_audioBuffer);
+    for (NSUInteger i = 0; i < _videoFrameCount; i++)
+        free(_videoFrames[i].pixels);
+    free(_videoFrames);
+    free(_rgbaRow);
+    if (_converter != NULL)
+        OEPixelConverterDestroy(_converter);
+    free(_planes);
+}
+
+#pragma mark - Core Thread
+
+static void OECaptureWriterAppendAudio(OECaptureWriter *writer, const void *bytes, NSUInteger length)
+{
+    if (atomic_load_explicit(&writer->_finishing, memory_order_relaxed))
+        return;
+
+    uint32_t space;
+    uint8_t *head = TPCircularBufferHead(&writer->_audioBuffer, &space);
+    if (head == NULL || space < sizeof(OECaptureAudioChunk) + length) {
+        atomic_fetch_add_explicit(&writer->_pendingSilenceLength, length, memory_order_relaxed);
+        atomic_fetch_add_explicit(&writer->_droppedAudioBytes, length, memory_order_relaxed);
+        return;
+    }
+
+    OECaptureAudioChunk chunk = {
+        .silenceLength = atomic_exchange_explicit(&writer->_pendingSilenceLength, 0, memory_order_relaxed),
+        .length = length,
+    };
+    memcpy(head, &chunk, sizeof(chunk));
+    memcpy(head + sizeof(chunk), bytes, length);
+    TPCircularBufferProduce(&writer->_audioBuffer, (uint32_t)(sizeof(chunk) + length));
+    dispatch_semaphore_signal(writer->_wakeSemaphore);
+}
+
+- (void)OE_attachToGameCore:(OEGameCore *)gameCore
+{
+    if (_attached || self.isFinished) {
+        os_log_error(OE_LOG_DEFAULT, "A capture writer can only be attached to one core, once");
+        return;
+    }
+    _attached = YES;
+    _gameCore = gameCore;
+
+    if (_audioFile != NULL)
+        [self OE_tapAudioOfGameCore:gameCore];
+    if (_videoFile != NULL)
+        [self OE_allocateFramePoolForGameCore:gameCore];
+
+    if (!_hasAudioBuffer && _videoFrames == NULL)
+        return;
+
+    // The thread only holds the writer weakly, so releasing it finishes writing.
+    __weak OECaptureWriter *weakSelf = self;
+    dispatch_semaphore_t wakeSemaphore = _wakeSemaphore;
+    dispatch_semaphore_t doneSemaphore = _doneSemaphore;
+    _thread = [[NSThread alloc] initWithBlock:^{
+        while (YES) {
+            @autoreleasepool {
+                OECaptureWriter *writer = weakSelf;
+                if (writer == nil || writer.isFinished) break;
+                [writer OE_drain];
+            }
+            dispatch_semaphore_wait(wakeSemaphore, dispatch_time(DISPATCH_TIME_NOW, OECaptureWakeUpInterval * NSEC_PER_SEC));
+        }
+        dispatch_semaphore_signal(doneSemaphore);
+    }];
+    _thread.name = @"org.openemu.capture-writer";
+    _thread.qualityOfService = NSQualityOfServiceUtility;
+    [_thread start];
+}
+
+- (void)OE_tapAudioOfGameCore:(OEGameCore *)gameCore
+{
+    id<OEAudioBuffer> buffer = gameCore.audioBufferCount > 0 ? [gameCore audioBufferAtIndex:0] : nil;
+    if (![buffer isKindOfClass:[OERingBuffer class]]) {
+        os_log_error(OE_LOG_DEFAULT, "Can't capture audio of a core without an OERingBuffer");
+        return;
+    }
+
+    _audioChannelCount = [gameCore channelCountForBuffer:0];
+    _audioSampleRate = [gameCore audioSampleRateForBuffer:0];
+    _audioBitDepth = gameCore.audioBitDepth;
+    NSUInteger bytesPerFrame = _audioChannelCount * _audioBitDepth / 8;
+    NSUInteger bufferLength = (NSUInteger)MAX(_audioBufferDuration * _audioSampleRate, 1) * bytesPerFrame;
+    if (!TPCircularBufferInit(&_audioBuffer, (uint32_t)bufferLength))
+        return;
+    _hasAudioBuffer = YES;
+
+    // The writer may be released on another thread while the core is
+    // writing, before it gets to remove the tap, so only hold it weakly.
+    __weak OECaptureWriter *weakSelf = self;
+    _tappedBuffer = (OERingBuffer *)buffer;
+    _tappedBuffer.writeTap = ^(const void *bytes, NSUInteger length) {
+        OECaptureWriter *writer = weakSelf;
+        if (writer != nil)
+            OECaptureWriterAppendAudio(writer, bytes, length);
+    };
+}
+
+- (void)OE_allocateFramePoolForGameCore:(OEGameCore *)gameCore
+{
+    if (gameCore.gameCoreRendering == OEGameCoreRenderingBitmap)
+        _converter = OEPixelConverterCreate(gameCore.pixelFormat, gameCore.pixelType, OEPixelFormat_RGBA, OEPixelType_UNSIGNED_BYTE);
+    if (_converter == NULL) {
+        os_log_error(OE_LOG_DEFAULT, "Can't capture video of a core which doesn't render bitmaps in a supported pixel format");
+        return;
+    }
+    _bytesPerPixel = OEPixelBytesPerPixel(gameCore.pixelFormat, gameCore.pixelType);
+
+    OEIntSize bufferSize = gameCore.bufferSize;
+    _maximumFrameWidth = bufferSize.width;
+    _maximumFrameHeight = bufferSize.height;
+    _frameRate = gameCore.frameInterval;
+    _aspectSize = gameCore.aspectSize;
+
+    NSUInteger count = MAX(_videoFramePoolSize, 1);
+    _videoFrames = calloc(count, sizeof(OECaptureVideoFrame));
+    for (NSUInteger i = 0; i < count; i++) {
+        _videoFrames[i].pixels = malloc(_maximumFrameWidth * _maximumFrameHeight * _bytesPerPixel);
+        if (_videoFrames[i].pixels == NULL)
+            break;
+        _videoFrameCount++;
+    }
+}
+
+- (void)OE_detachFromGameCore:(OEGameCore *)gameCore
+{
+    _tappedBuffer.writeTap = nil;
+    _gameCore = nil;
+}
+
+- (BOOL)appendVideoFrame:(const void *)pixels
+{
+    OEGameCore *gameCore = _gameCore;
+    if (gameCore == nil || _videoFrameCount == 0 || self.isFinished)
+        return NO;
+
+    _frameAppended = YES;
+
+    uint64_t queued = atomic_load_explicit(&_queuedFrameCount, memory_order_relaxed);
+    uint64_t dequeued = atomic_load_explicit(&_dequeuedFrameCount, memory_order_acquire);
+    if (queued - dequeued >= _videoFrameCount) {
+        // Repeat the previous frame instead.
+        atomic_fetch_add_explicit(&_droppedVideoFrameCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&_pendingRepeatCount, 1, memory_order_relaxed);
+        return NO;
+    }
+
+    OEIntRect rect = gameCore.screenRect;
+    NSInteger bytesPerRow = gameCore.bytesPerRow;
+    NSUInteger width = MIN((NSUInteger)MAX(rect.size.width, 0), _maximumFrameWidth);
+    NSUInteger height = MIN((NSUInteger)MAX(rect.size.height, 0), _maximumFrameHeight);
+    NSUInteger rowLength = width * _bytesPerPixel;
+
+    OECaptureVideoFrame *frame = &_videoFrames[queued % _videoFrameCount];
+    const uint8_t *src = (const uint8_t *)pixels + rect.origin.y * bytesPerRow + rect.origin.x * _bytesPerPixel;
+    for (NSUInteger y = 0; y < height; y++)
+        memcpy(frame->pixels + y * rowLength, src + y * bytesPerRow, rowLength);
+    frame->width = width;
+    frame->height = height;
+    frame->repeatCount = atomic_exchange_explicit(&_pendingRepeatCount, 0, memory_order_relaxed);
+
+    atomic_store_explicit(&_queuedFrameCount, queued + 1, memory_order_release);
+    dispatch_semaphore_signal(_wakeSemaphore);
+    return YES;
+}
+
+- (void)OE_gameCoreDidExecuteFrame:(OEGameCore *)gameCore
+{
+    if (_videoFrameCount == 0)
+        return;
+
+    // Frames which weren't appended repeat the previous one, or are black
+    // if they come before the first appended frame.
+    if (!_frameAppended)
+        atomic_fetch_add_explicit(&_pendingRepeatCount, 1, memory_order_relaxed);
+    _frameAppended = NO;
+}
+
+#pragma mark - Writer Thread
+
+- (void)OE_drain
+{
+    if (_hasAudioBuffer)
+        [self OE_drainAudio];
+    if (_videoFrameCount > 0)
+        [self OE_drainVideo];
+}
+
+- (void)OE_writeSilence:(uint64_t)length
+{
+    static const uint8_t zeros[4096];
+    atomic_fetch_add_explicit(&_writtenAudioBytes, length, memory_order_relaxed);
+    while (length > 0) {
+        size_t count = (size_t)MIN(length, sizeof(zeros));
+        fwrite(zeros, 1, count, _audioFile);
+        length -= count;
+    }
+}
+
+- (void)OE_drainAudio
+{
+    uint32_t available;
+    const uint8_t *tail;
+    while ((tail = TPCircularBufferTail(&_audioBuffer, &available)) != NULL && available >= sizeof(OECaptureAudioChunk)) {
+        OECaptureAudioChunk chunk;
+        memcpy(&chunk, tail, sizeof(chunk));
+        [self OE_writeSilence:chunk.silenceLength];
+        fwrite(tail + sizeof(chunk), 1, chunk.length, _audioFile);
+        atomic_fetch_add_explicit(&_writtenAudioBytes, chunk.length, memory_order_relaxed);
+        TPCircularBufferConsume(&_audioBuffer, (uint32_t)(sizeof(chunk) + chunk.length));
+    }
+}
+
+- (void)OE_writeVideoHeaderForFrame:(const OECaptureVideoFrame *)frame
+{
+    _outputWidth = MAX(frame->width, 1);
+    _outputHeight = MAX(frame->height, 1);
+    _rgbaRow = malloc(_outputWidth * 4);
+    _planes = malloc(_outputWidth * _outputHeight * 3);
+
+    // Black, until the first frame is converted.
+    NSUInteger planeSize = _outputWidth * _outputHeight;
+    memset(_planes, 16, planeSize);
+    memset(_planes + planeSize, 128, planeSize * 2);
+
+    NSInteger rateNumerator = llround(_frameRate * 1000), rateDenominator = 1000;
+    NSInteger rateDivisor = OECaptureGCD(rateNumerator, rateDenominator);
+
+    // The pixel aspect ratio which displays the frame at the core's aspectSize.
+    NSInteger aspectNumerator = 1, aspectDenominator = 1;
+    if (_aspectSize.width > 0 && _aspectSize.height > 0) {
+        aspectNumerator = _aspectSize.width * _outputHeight;
+        aspectDenominator = _aspectSize.height * _outputWidth;
+        NSInteger aspectDivisor = OECaptureGCD(aspectNumerator, aspectDenominator);
+        aspectNumerator /= aspectDivisor;
+        aspectDenominator /= aspectDivisor;
+    }
+
+    fprintf(_videoFile, "YUV4MPEG2 W%lu H%lu F%ld:%ld Ip A%ld:%ld C444\n",
+            (unsigned long)_outputWidth, (unsigned long)_outputHeight,
+            (long)(rateNumerator / rateDivisor), (long)(rateDenominator / rateDivisor),
+            (long)aspectNumerator, (long)aspectDenominator);
+}
+
+- (void)OE_writeLastFrame:(NSUInteger)count
+{
+    NSUInteger planeSize = _outputWidth * _outputHeight;
+    for (NSUInteger i = 0; i < count; i++) {
+        fputs("FRAME\n", _videoFile);
+        fwrite(_planes, 1, planeSize * 3, _videoFile);
+    }
+    atomic_fetch_add_explicit(&_writtenVideoFrameCount, count, memory_order_relaxed);
+}
+
+/// Converts a frame into the planes. Frames which don't have the size of
+/// the first frame are cropped or padded with black.
+- (void)OE_convertFrame:(const OECaptureVideoFrame *)frame
+{
+    NSUInteger planeSize = _outputWidth * _outputHeight;
+    NSUInteger width = MIN(frame->width, _outputWidth);
+    NSUInteger height = MIN(frame->height, _outputHeight);
+
+    for (NSUInteger y = 0; y < _outputHeight; y++) {
+        uint8_t *luma = _planes + y * _outputWidth;
+        uint8_t *cb = luma + planeSize;
+        uint8_t *cr = cb + planeSize;
+        NSUInteger converted = 0;
+        if (y < height) {
+            OEPixelConverterConvertRow(_converter, frame->pixels + y * frame->width * _bytesPerPixel, _rgbaRow, width);
+            OECaptureConvertRow(_rgbaRow, luma, cb, cr, width);
+            converted = width;
+        }
+        memset(luma + converted, 16, _outputWidth - converted);
+        memset(cb + converted, 128, _outputWidth - converted);
+        memset(cr + converted, 128, _outputWidth - converted);
+    }
+}
+
+- (void)OE_drainVideo
+{
+    uint64_t dequeued = atomic_load_explicit(&_dequeuedFrameCount, memory_order_relaxed);
+    uint64_t queued = atomic_load_explicit(&_queuedFrameCount, memory_order_acquire);
+    for (; dequeued < queued; dequeued++) {
+        const OECaptureVideoFrame *frame = &_videoFrames[dequeued % _videoFrameCount];
+        if (_planes == NULL)
+            [self OE_writeVideoHeaderForFrame:frame];
+
+        [self OE_writeLastFrame:frame->repeatCount];
+        [self OE_convertFrame:frame];
+        [self OE_writeLastFrame:1];
+
+        atomic_store_explicit(&_dequeuedFrameCount, dequeued + 1, memory_order_release);
+    }
+}
+
+#pragma mark - Finishing
+
+- (BOOL)isFinished
+{
+    return atomic_load_explicit(&_finishing, memory_order_relaxed);
+}
+
+- (void)finishWriting
+{
+    if (atomic_exchange(&_finishing, YES))
+        return;
+
+    // The writer thread can release the last reference to the writer.
+    if (_thread != nil && NSThread.currentThread != _thread) {
+        dispatch_semaphore_signal(_wakeSemaphore);
+        dispatch_semaphore_wait(_doneSemaphore, DISPATCH_TIME_FOREVER);
+    }
+
+    [self OE_drain];
+
+    if (_audioFile != NULL) {
+        [self OE_writeSilence:atomic_exchange(&_pendingSilenceLength, 0)];
+        [self OE_writeWAVHeader];
+        fclose(_audioFile);
+        _audioFile = NULL;
+    }
+
+    if (_videoFile != NULL) {
+        // Without a single frame, the size of the video is unknown.
+        if (_planes != NULL)
+            [self OE_writeLastFrame:atomic_exchange(&_pendingRepeatCount, 0)];
+        fclose(_videoFile);
+        _videoFile = NULL;
+    }
+}
+
+static void OECaptureWriteLE(FILE *file, uint32_t value, size_t size)
+{
+    uint8_t bytes[4] = { value, value >> 8, value >> 16, value >> 24 };
+    fwrite(bytes, 1, size, file);
+}
+
+- (void)OE_writeWAVHeader
+{
+    uint64_t dataLength = atomic_load(&_writtenAudioBytes);
+    uint32_t blockAlign = (uint32_t)(_audioChannelCount * _audioBitDepth / 8);
+    uint32_t sampleRate = (uint32_t)lround(_audioSampleRate);
+
+    fseek(_audioFile, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, _audioFile);
+    OECaptureWriteLE(_audioFile, (uint32_t)MIN(dataLength + 36, UINT32_MAX), 4);
+    fwrite("WAVEfmt ", 1, 8, _audioFile);
+    OECaptureWriteLE(_audioFile, 16, 4);
+    OECaptureWriteLE(_audioFile, 1, 2); // PCM
+    OECaptureWriteLE(_audioFile, (uint32_t)_audioChannelCount, 2);
+    OECaptureWriteLE(_audioFile, sampleRate, 4);
+    OECaptureWriteLE(_audioFile, sampleRate * blockAlign, 4);
+    OECaptureWriteLE(_audioFile, blockAlign, 2);
+    OECaptureWriteLE(_audioFile, (uint32_t)_audioBitDepth, 2);
+    fwrite("data", 1, 4, _audioFile);
+    OECaptureWriteLE(_audioFile, (uint32_t)MIN(dataLength, UINT32_MAX), 4);
+}
+
+#pragma mark - Counters
+
+- (NSUInteger)writtenVideoFrameCount
+{
+    return atomic_load_explicit(&_writtenVideoFrameCount, memory_order_relaxed);
+}
+
+- (NSUInteger)droppedVideoFrameCount
+{
+    return atomic_load_explicit(&_droppedVideoFrameCount, memory_order_relaxed);
+}
+
+- (NSUInteger)writtenAudioFrameCount
+{
+    NSUInteger bytesPerFrame = _audioChannelCount * _audioBitDepth / 8;
+    return bytesPerFrame > 0 ? atomic_load_explicit(&_writtenAudioBytes, memory_order_relaxed) / bytesPerFrame : 0;
+}
+
+- (NSUInteger)droppedAudioFrameCount
+{
+    NSUInteger bytesPerFrame = _audioChannelCount * _audioBitDepth / 8;
+    return bytesPerFrame > 0 ? atomic_load_explicit(&_droppedAudioBytes, memory_order_relaxed) / bytesPerFrame : 0;
+}
+
+@end
@@ -0,0 +1,163 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OECommandQueue.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define OE_CACHE_LINE_SIZE 128
+
+typedef struct {
+    _Atomic(size_t) sequence;
+    OECommand command;
+} OECommandQueueCell;
+
+struct OECommandQueue {
+    OECommandQueueCell *cells;
+    size_t mask;
+
+    _Alignas(OE_CACHE_LINE_SIZE) _Atomic(size_t) enqueuePosition;
+    _Alignas(OE_CACHE_LINE_SIZE) _Atomic(size_t) dequeuePosition;
+};
+
+OECommandQueue *OECommandQueueCreate(size_t capacity)
+{
+    size_t size = 2;
+    while(size < capacity)
+        size <<= 1;
+
+    OECommandQueue *queue;
+    if(posix_memalign((void **)&queue, OE_CACHE_LINE_SIZE, sizeof(OECommandQueue)) != 0)
+        return NULL;
+
+    queue->cells = calloc(size, sizeof(OECommandQueueCell));
+    if(queue->cells == NULL)
+    {
+        free(queue);
+        return NULL;
+    }
+
+    queue->mask = size - 1;
+    for(size_t i = 0; i < size; i++)
+        atomic_init(&queue->cells[i].sequence, i);
+    atomic_init(&queue->enqueuePosition, 0);
+    atomic_init(&queue->dequeuePosition, 0);
+
+    return queue;
+}
+
+void OECommandQueueDestroy(OECommandQueue *queue)
+{
+    if(queue == NULL) return;
+
+    OECommand command;
+    while(OECommandQueuePop(queue, &command))
+        if(command.releaseContext != NULL)
+            command.releaseContext(command.context);
+
+    free(queue->cells);
+    free(queue);
+}
+
+bool OECommandQueuePush(OECommandQueue *queue, const OECommand *command)
+{
+    size_t position = atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+    OECommandQueueCell *cell;
+
+    for(;;)
+    {
+        cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if(difference == 0)
+        {
+            // The cell is free for this lap; claim it.
+            if(atomic_compare_exchange_weak_explicit(&queue->enqueuePosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if(difference < 0)
+        {
+            // The consumer hasn't freed the cell from the previous lap yet.
+            return false;
+        }
+        else
+        {
+            position = atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+        }
+    }
+
+    cell->command = *command;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+    return true;
+}
+
+bool OECommandQueuePop(OECommandQueue *queue, OECommand *outCommand)
+{
+    // Single consumer: nobody else moves the dequeue position.
+    size_t position = atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+    OECommandQueueCell *cell = &queue->cells[position & queue->mask];
+    size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+
+    // A producer may have claimed the cell without having filled it yet.
+    if(sequence != position + 1)
+        return false;
+
+    *outCommand = cell->command;
+    atomic_store_explicit(&queue->dequeuePosition, position + 1, memory_order_relaxed);
+    atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+    return true;
+}
+
+size_t OECommandQueueDrain(OECommandQueue *queue)
+{
+    size_t end = atomic_load_explicit(&queue->enqueuePosition, memory_order_acquire);
+    size_t count = 0;
+    OECommand command;
+
+    while(atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed) != end && OECommandQueuePop(queue, &command))
+    {
+        if(command.function != NULL)
+            command.function(&command);
+        if(command.releaseContext != NULL)
+            command.releaseContext(command.context);
+        count++;
+    }
+
+    return count;
+}
+
+size_t OECommandQueueCount(OECommandQueue *queue)
+{
+    size_t enqueue = atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+    size_t dequeue = atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+    return enqueue - dequeue;
+}
+
+size_t OECommandQueueCapacity(OECommandQueue *queue)
+{
+    return queue->mask + 1;
+}
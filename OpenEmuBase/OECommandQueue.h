@@ -0,0 +1,111 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OECommandQueue_h
+#define OECommandQueue_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A bounded, lock-free, multiple producer single consumer queue of small
+ * fixed-size commands.
+ *
+ * Any thread may push commands; a single thread pops them. Pushing never
+ * blocks and never allocates: when the queue is full, the push fails and
+ * the producer decides what to do. Based on Dmitry Vyukov's bounded queue,
+ * each slot carries a sequence number, so producers only contend on a
+ * single compare-and-swap of the enqueue position.
+ *
+ * The implementation only relies on C11 atomics, and on POSIX for
+ * cache-line aligned allocation.
+ */
+
+typedef struct OECommand OECommand;
+
+typedef void (*OECommandFunction)(const OECommand *command);
+
+typedef uint32_t OECommandTag;
+enum {
+    OECommandTagBlock              = 1,
+    OECommandTagPressKey           = 2,
+    OECommandTagReleaseKey         = 3,
+    OECommandTagChangeAnalogKey    = 4,
+    /// First tag available for commands defined outside of OpenEmuBase.
+    OECommandTagUser               = 0x1000,
+};
+
+struct OECommand {
+    /// Called on the consumer thread when the command is drained.
+    OECommandFunction function;
+    void *context;
+    /// Called with the context once the command has been performed or dropped. Optional.
+    void (*releaseContext)(void *context);
+    OECommandTag tag;
+    uint32_t player;
+    uint32_t key;
+    float value;
+};
+
+typedef struct OECommandQueue OECommandQueue;
+
+/// Creates a queue holding up to capacity commands, rounded up to a power of 2.
+OECommandQueue *OECommandQueueCreate(size_t capacity);
+
+/// Destroys the queue. Commands still in the queue are dropped without being performed,
+/// but their contexts are released.
+void OECommandQueueDestroy(OECommandQueue *queue);
+
+/// Adds a command to the queue. Safe to call from any thread.
+/// @returns false if the queue is full.
+bool OECommandQueuePush(OECommandQueue *queue, const OECommand *command);
+
+/// Removes the oldest command from the queue. Must only be called from the consumer thread.
+/// The caller takes over the context of the command.
+/// @returns false if the queue is empty.
+bool OECommandQueuePop(OECommandQueue *queue, OECommand *outCommand);
+
+/// Performs every command pushed so far, in order. Commands pushed while
+/// draining are left for the next drain, so a producer can't starve the consumer.
+/// Must only be called from the consumer thread.
+/// @returns The number of commands performed.
+size_t OECommandQueueDrain(OECommandQueue *queue);
+
+/// The approximate number of commands in the queue.
+size_t OECommandQueueCount(OECommandQueue *queue);
+
+size_t OECommandQueueCapacity(OECommandQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OECommandQueue_h */
@@ -0,0 +1,96 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEGeometry.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OEFrameChangeDetector
+ * @abstract Finds the tiles of a bitmap frame which differ from the previous frame.
+ * @discussion
+ * Keeps a copy of the previous frame and compares each row against it,
+ * with the vectorized memcmp of the system. Rows which are unchanged, the
+ * common case, are skipped after one comparison; rows which differ are
+ * compared and copied tile by tile. The result is exact, unlike hashing,
+ * and each frame is read only once more than uploading it would.
+ *
+ * Hosts can skip uploading and presenting unchanged frames, e.g. repeated
+ * frames of 30 fps games, menus and pauses, or upload only the dirty
+ * tiles or dirtyRect. OEGameCore runs a detector on the frames it publishes
+ * to its videoTripleBuffer when frameChangeDetector is set.
+ *
+ * Not thread safe; use from one thread at a time.
+ */
+@interface OEFrameChangeDetector : NSObject
+
+/// Creates a detector with 16x16 pixel tiles.
+- (instancetype)init;
+- (instancetype)initWithTileSize:(OEIntSize)tileSize NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) OEIntSize tileSize;
+
+/*!
+ * @method detectChangesInFrame:bytesPerRow:bytesPerPixel:rect:
+ * @abstract Compares rect of a frame with the rect of the previous frame.
+ * @discussion
+ * The first frame, and frames whose rect or bytesPerPixel differ from the
+ * previous frame, are entirely dirty.
+ * @returns YES if any pixel changed.
+ */
+- (BOOL)detectChangesInFrame:(const void *)pixels bytesPerRow:(NSUInteger)bytesPerRow bytesPerPixel:(NSUInteger)bytesPerPixel rect:(OEIntRect)rect;
+
+/// Makes the next frame entirely dirty, e.g. when the host lost its copy of the frame.
+- (void)reset;
+
+#pragma mark - Last Frame
+
+/// YES if the last frame differs from the one before.
+@property (readonly, getter=isChanged) BOOL changed;
+
+/// The bounding rectangle of the dirty tiles of the last frame, clipped to its rect. In the coordinates of the frame, like rect. Empty if unchanged.
+@property (readonly) OEIntRect dirtyRect;
+
+/// The number of tile columns and rows covering the rect of the last frame. Tiles on the right and bottom edges may be partial.
+@property (readonly) OEIntSize tileGridSize;
+
+/// The number of dirty tiles in the last frame.
+@property (readonly) NSUInteger dirtyTileCount;
+
+/// Returns YES if the tile at the given column and row of the grid changed in the last frame.
+- (BOOL)isTileDirtyAtColumn:(NSUInteger)column row:(NSUInteger)row;
+
+#pragma mark - Statistics
+
+/// The number of frames compared so far.
+@property (readonly) NSUInteger frameCount;
+/// The number of frames which were identical to the previous one.
+@property (readonly) NSUInteger unchangedFrameCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
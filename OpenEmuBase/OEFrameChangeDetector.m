@@ -0,0 +1,172 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEFrameChangeDetector.h"
+
+@implementation OEFrameChangeDetector
+{
+    // The rect of the previous frame, packed.
+    uint8_t *_previousFrame;
+    OEIntRect _previousRect;
+    NSUInteger _bytesPerPixel;
+    BOOL _hasPreviousFrame;
+
+    // One byte per tile, row by row.
+    uint8_t *_dirtyTiles;
+    NSUInteger _tileCapacity;
+}
+
+- (instancetype)init
+{
+    return [self initWithTileSize:OEIntSizeMake(16, 16)];
+}
+
+- (instancetype)initWithTileSize:(OEIntSize)tileSize
+{
+    if ((self = [super init])) {
+        _tileSize = OEIntSizeMake(MAX(tileSize.width, 1), MAX(tileSize.height, 1));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_previousFrame);
+    free(_dirtyTiles);
+}
+
+- (void)reset
+{
+    _hasPreviousFrame = NO;
+}
+
+- (BOOL)OE_prepareForRect:(OEIntRect)rect bytesPerPixel:(NSUInteger)bytesPerPixel
+{
+    _tileGridSize = OEIntSizeMake((rect.size.width + _tileSize.width - 1) / _tileSize.width,
+                                  (rect.size.height + _tileSize.height - 1) / _tileSize.height);
+    NSUInteger tileCount = (NSUInteger)_tileGridSize.width * _tileGridSize.height;
+    if (tileCount > _tileCapacity) {
+        free(_dirtyTiles);
+        _dirtyTiles = malloc(tileCount);
+        _tileCapacity = _dirtyTiles != NULL ? tileCount : 0;
+    }
+
+    if (_hasPreviousFrame && OEIntRectEqualToRect(rect, _previousRect) && bytesPerPixel == _bytesPerPixel)
+        return YES;
+
+    free(_previousFrame);
+    _previousFrame = malloc((size_t)rect.size.width * rect.size.height * bytesPerPixel);
+    _previousRect = rect;
+    _bytesPerPixel = bytesPerPixel;
+    return NO;
+}
+
+- (BOOL)detectChangesInFrame:(const void *)pixels bytesPerRow:(NSUInteger)bytesPerRow bytesPerPixel:(NSUInteger)bytesPerPixel rect:(OEIntRect)rect
+{
+    _frameCount++;
+
+    BOOL comparable = [self OE_prepareForRect:rect bytesPerPixel:bytesPerPixel];
+    NSUInteger width = rect.size.width, height = rect.size.height;
+    NSUInteger rowLength = width * bytesPerPixel;
+    NSUInteger tileLength = _tileSize.width * bytesPerPixel;
+    NSUInteger columns = _tileGridSize.width;
+    const uint8_t *source = (const uint8_t *)pixels + rect.origin.y * bytesPerRow + rect.origin.x * bytesPerPixel;
+
+    if (_previousFrame == NULL || _dirtyTiles == NULL) {
+        // Out of memory; report everything as changed.
+        _hasPreviousFrame = NO;
+        _changed = YES;
+        _dirtyRect = rect;
+        _dirtyTileCount = (NSUInteger)_tileGridSize.width * _tileGridSize.height;
+        if (_dirtyTiles != NULL)
+            memset(_dirtyTiles, 1, _dirtyTileCount);
+        return YES;
+    }
+
+    if (!comparable) {
+        for (NSUInteger y = 0; y < height; y++)
+            memcpy(_previousFrame + y * rowLength, source + y * bytesPerRow, rowLength);
+        _hasPreviousFrame = YES;
+        _changed = YES;
+        _dirtyRect = rect;
+        _dirtyTileCount = (NSUInteger)_tileGridSize.width * _tileGridSize.height;
+        memset(_dirtyTiles, 1, _dirtyTileCount);
+        return YES;
+    }
+
+    memset(_dirtyTiles, 0, (NSUInteger)_tileGridSize.width * _tileGridSize.height);
+    NSUInteger dirtyTileCount = 0;
+    NSUInteger minColumn = columns, maxColumn = 0, minRow = _tileGridSize.height, maxRow = 0;
+
+    for (NSUInteger y = 0; y < height; y++) {
+        const uint8_t *row = source + y * bytesPerRow;
+        uint8_t *previousRow = _previousFrame + y * rowLength;
+        if (memcmp(row, previousRow, rowLength) == 0)
+            continue;
+
+        // The row differs somewhere; find the tiles, and bring them up to date.
+        NSUInteger tileRow = y / _tileSize.height;
+        uint8_t *dirtyTiles = _dirtyTiles + tileRow * columns;
+        for (NSUInteger column = 0; column < columns; column++) {
+            NSUInteger offset = column * tileLength;
+            NSUInteger length = MIN(tileLength, rowLength - offset);
+            if (memcmp(row + offset, previousRow + offset, length) == 0)
+                continue;
+
+            memcpy(previousRow + offset, row + offset, length);
+            if (!dirtyTiles[column]) {
+                dirtyTiles[column] = 1;
+                dirtyTileCount++;
+                minColumn = MIN(minColumn, column);
+                maxColumn = MAX(maxColumn, column);
+                minRow = MIN(minRow, tileRow);
+                maxRow = MAX(maxRow, tileRow);
+            }
+        }
+    }
+
+    _dirtyTileCount = dirtyTileCount;
+    _changed = dirtyTileCount > 0;
+    if (!_changed) {
+        _unchangedFrameCount++;
+        _dirtyRect = OEIntRectMake(rect.origin.x, rect.origin.y, 0, 0);
+        return NO;
+    }
+
+    NSUInteger x = minColumn * _tileSize.width, top = minRow * _tileSize.height;
+    NSUInteger right = MIN((maxColumn + 1) * _tileSize.width, width), bottom = MIN((maxRow + 1) * _tileSize.height, height);
+    _dirtyRect = OEIntRectMake(rect.origin.x + (int)x, rect.origin.y + (int)top, (int)(right - x), (int)(bottom - top));
+    return YES;
+}
+
+- (BOOL)isTileDirtyAtColumn:(NSUInteger)column row:(NSUInteger)row
+{
+    if (_dirtyTiles == NULL || column >= (NSUInteger)_tileGridSize.width || row >= (NSUInteger)_tileGridSize.height)
+        return NO;
+    return _dirtyTiles[row * _tileGridSize.width + column] != 0;
+}
+
+@end
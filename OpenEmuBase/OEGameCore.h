@@ -33,6 +33,8 @@
 #import <OpenEmuBase/OESystemResponderClient.h>
 #import <OpenEmuBase/OEGeometry.h>
 #import <OpenEmuBase/OEDiffQueue.h>
+#import <OpenEmuBase/OEAudioConversion.h>
+#import <OpenEmuBase/OEPixelConversion.h>
 
 #ifndef DLog
 
@@ -64,28 +66,6 @@
 
 #pragma mark -
 
-// Return values for -pixelFormat
-#define OEPixelFormat_LUMINANCE   0x1909 // GL_LUMINANCE
-#define OEPixelFormat_RGB         0x1907 // GL_RGB
-#define OEPixelFormat_BGR         0x80E0 // GL_BGR
-#define OEPixelFormat_RGBA        0x1908 // GL_RGBA
-#define OEPixelFormat_BGRA        0x80E1 // GL_BGRA
-
-// Return values for -pixelType
-#define OEPixelType_UNSIGNED_BYTE                 0x1401 // GL_UNSIGNED_BYTE
-#define OEPixelType_UNSIGNED_SHORT_5_6_5          0x8363 // GL_UNSIGNED_SHORT_5_6_5
-#define OEPixelType_UNSIGNED_SHORT_5_6_5_REV      0x8364 // GL_UNSIGNED_SHORT_5_6_5_REV
-#define OEPixelType_UNSIGNED_SHORT_4_4_4_4        0x8033 // GL_UNSIGNED_SHORT_4_4_4_4
-#define OEPixelType_UNSIGNED_SHORT_4_4_4_4_REV    0x8365 // GL_UNSIGNED_SHORT_4_4_4_4_REV
-#define OEPixelType_UNSIGNED_SHORT_5_5_5_1        0x8034 // GL_UNSIGNED_SHORT_5_5_5_1
-#define OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV    0x8366 // GL_UNSIGNED_SHORT_1_5_5_5_REV
-#define OEPixelType_UNSIGNED_INT_8_8_8_8          0x8035 // GL_UNSIGNED_INT_8_8_8_8
-#define OEPixelType_UNSIGNED_INT_8_8_8_8_REV      0x8367 // GL_UNSIGNED_INT_8_8_8_8_REV
-#define OEPixelType_UNSIGNED_INT_10_10_10_2       0x8036 // GL_UNSIGNED_INT_10_10_10_2
-#define OEPixelType_UNSIGNED_INT_2_10_10_10_REV   0x8368 // GL_UNSIGNED_INT_2_10_10_10_REV
- 
-#pragma mark -
-
 NS_ASSUME_NONNULL_BEGIN
 
 extern NSString *const OEGameCoreErrorDomain;
@@ -97,6 +77,7 @@ typedef NS_ERROR_ENUM(OEGameCoreErrorDomain, OEGameCoreErrorCodes) {
     OEGameCoreStateHasWrongSizeError = -4,
     OEGameCoreCouldNotSaveStateError = -5,
     OEGameCoreDoesNotSupportSaveStatesError = -6,
+    OEGameCoreCouldNotTakeSnapshotError = -7,
 };
 
 /*!
@@ -115,6 +96,17 @@ typedef NS_ENUM(NSUInteger, OEGameCoreRendering) {
     OEGameCoreRenderingMetal2Video  NS_SWIFT_UNAVAILABLE("Use .metal2 instead")  NS_DEPRECATED_WITH_REPLACEMENT_MAC("OEGameCoreRenderingMetal2",  10.7, 10.14.4) = OEGameCoreRenderingMetal2 ,
 };
 
+/*!
+ * @enum OESnapshotFormat
+ * @abstract How -takeSnapshotWithFormat:size:completionHandler: encodes the picture.
+ */
+typedef NS_ENUM(NSInteger, OESnapshotFormat) {
+    OESnapshotFormatBGRA8,          //!< Packed 8-bit BGRA pixels, 4 * width bytes per row.
+    OESnapshotFormatPNG,            //!< A PNG file.
+};
+
+@class OEFrameChangeDetector;
+
 @protocol OERenderDelegate <NSObject>
 @required
 
@@ -159,6 +151,36 @@ typedef NS_ENUM(NSUInteger, OEGameCoreRendering) {
 - (void)didExecute;
 - (void)suspendFPSLimiting;
 - (void)resumeFPSLimiting;
+
+@optional
+
+/*!
+ * @method willExecuteSkippedFrame
+ * @discussion
+ * Called instead of -willExecute for frames which will not be displayed,
+ * for example because the core is running behind. The core still executes
+ * the frame and may still render into the current context, but the result
+ * should not be presented.
+ * If not implemented, -willExecute and -didExecute are called as usual.
+ */
+- (void)willExecuteSkippedFrame;
+
+/*!
+ * @method didExecuteSkippedFrame
+ * @discussion
+ * Called instead of -didExecute for frames which will not be displayed.
+ */
+- (void)didExecuteSkippedFrame;
+
+/*!
+ * @method didExecuteWithFrameChanges:
+ * @discussion
+ * Called after -didExecute when the core has an OEGameCore.frameChangeDetector,
+ * with the detector holding the tiles which changed in the frame. If the
+ * frame is unchanged, it isn't published and can be neither uploaded nor
+ * presented again.
+ */
+- (void)didExecuteWithFrameChanges:(OEFrameChangeDetector *)changes;
 @end
 
 @protocol OEGameCoreDelegate <NSObject>
@@ -195,8 +217,37 @@ typedef NS_ENUM(NSUInteger, OEGameCoreRendering) {
 @end
 
 @class OERingBuffer;
+@class OEGameCoreScheduler;
+@class OEGameCoreWatchdog;
+@class OEInputMovieRecorder;
+@class OEInputMoviePlayer;
+@class OECaptureWriter;
+@class OETripleBuffer;
 @protocol OEAudioBuffer;
 
+/*!
+ * @enum OEGameCorePhase
+ * @abstract What the core thread is doing, as reported to OEGameCoreWatchdog.
+ */
+typedef NS_ENUM(NSInteger, OEGameCorePhase) {
+    /// Between frames, e.g. running the frame callback.
+    OEGameCorePhaseIdle,
+    /// Performing commands and blocks sent to the core.
+    OEGameCorePhaseCommands,
+    /// Serializing a rewind snapshot.
+    OEGameCorePhaseSerialize,
+    /// Pushing a rewind snapshot to the rewind queue.
+    OEGameCorePhasePush,
+    /// Popping and restoring a rewind snapshot.
+    OEGameCorePhaseRewind,
+    /// Inside -executeFrame.
+    OEGameCorePhaseExecute,
+    /// Waiting for the next frame.
+    OEGameCorePhaseWait,
+    /// Parked while paused.
+    OEGameCorePhaseParked,
+};
+
 #pragma mark -
 
 OE_EXPORTED_CLASS
@@ -250,6 +301,32 @@ OE_EXPORTED_CLASS
 
 - (void)setupEmulationWithCompletionHandler:(void(^)(void))completionHandler;
 - (void)startEmulationWithCompletionHandler:(void(^)(void))completionHandler;
+
+/*!
+ * @property scheduler
+ * @abstract The scheduler which runs the game loop, or nil to run it on a dedicated thread.
+ * @discussion Must be set before -startEmulationWithCompletionHandler:.
+ * Defaults to nil. See OEGameCoreScheduler.
+ */
+@property (nonatomic, strong, nullable) OEGameCoreScheduler *scheduler;
+
+/*!
+ * @property schedulerAffinity
+ * @abstract Index of the scheduler thread the core should preferably run on.
+ * @discussion The index is taken modulo the scheduler's thread count.
+ * Defaults to NSNotFound, which spreads cores across threads in order.
+ */
+@property (nonatomic) NSUInteger schedulerAffinity;
+
+/*!
+ * @property watchdog
+ * @abstract The watchdog monitoring the core thread for slow and stalled frames.
+ * @discussion Defaults to nil. See OEGameCoreWatchdog.
+ */
+@property (nonatomic, strong, nullable) OEGameCoreWatchdog *watchdog;
+
+/// What the core thread is currently doing. Safe to read from any thread.
+@property (readonly) OEGameCorePhase currentPhase;
 - (void)resetEmulationWithCompletionHandler:(void(^)(void))completionHandler;
 
 #pragma mark - Stopping
@@ -291,6 +368,19 @@ OE_EXPORTED_CLASS
  */
 @property (nonatomic, assign) float rate;
 
+/*!
+ * @property parksWhenPaused
+ * @abstract Whether the core thread should sleep while the core is paused.
+ * @discussion
+ * When YES and the rate is 0, the core thread blocks until it is given
+ * something to do (-performBlock:, a rate change or a frame step) instead of
+ * running its loop at 1x rate. This keeps idle paused instances from using
+ * any CPU, but -gameCoreWillBeginFrame: and -gameCoreWillEndFrame: are not
+ * called while the thread is parked.
+ * Defaults to NO.
+ */
+@property (nonatomic) BOOL parksWhenPaused;
+
 /*!
  * @method executeFrame
  * @discussion
@@ -315,6 +405,168 @@ OE_EXPORTED_CLASS
 - (void)beginPausedExecution;
 - (void)endPausedExecution;
 
+/*!
+ * @method pushCommand:
+ * @abstract Queues a command to be performed on the core thread before the next frame.
+ * @discussion
+ * Commands are drained in order at a fixed point of the game loop, right
+ * before -executeFrame. Pushing is lock-free and doesn't allocate, which makes
+ * it suitable for high-frequency producers like input devices.
+ * -performBlock: is built on top of this method.
+ * Safe to call from any thread.
+ * @returns NO if the command queue is full. The context of the command is not released in that case.
+ */
+- (BOOL)pushCommand:(const OECommand *)command;
+
+#pragma mark - Frame Skipping
+
+/*!
+ * @property maximumFrameSkip
+ * @abstract The maximum number of consecutive frames which may be executed
+ * without being presented when the core is running behind.
+ * @discussion 3 is a good value for most cores. Defaults to 0, which disables frame skipping.
+ */
+@property (nonatomic) NSUInteger maximumFrameSkip;
+
+/*!
+ * @property frameSkipThreshold
+ * @abstract How late, in frames, the core must be on average before frames are skipped.
+ * @discussion Defaults to 0.5.
+ */
+@property (nonatomic) double frameSkipThreshold;
+
+/*!
+ * @property frameSkipWindow
+ * @abstract The number of frames over which lateness is averaged.
+ * @discussion Smaller values react faster to slowdowns but skip frames more
+ * eagerly after a single slow frame. Defaults to 8.
+ */
+@property (nonatomic) NSUInteger frameSkipWindow;
+
+/*!
+ * @property maximumFrameLateness
+ * @abstract How far behind, in seconds, the game loop may fall before it gives
+ * up catching up and resynchronizes to the current time.
+ * @discussion Defaults to 0.25.
+ */
+@property (nonatomic) NSTimeInterval maximumFrameLateness;
+
+/*!
+ * @property decimatesFastForward
+ * @abstract Whether to only present frames at the normal frame rate while fast-forwarding.
+ * @discussion
+ * When YES and the rate is above 1, only one in every 'rate' frames is
+ * presented; the others are reported as skipped frames. Unless audio is
+ * time stretched (see stretchesAudio), the audio produced by the skipped
+ * frames is dropped as well, so the audio buffers hold real-time length
+ * audio instead of overflowing.
+ * Defaults to NO.
+ */
+@property (nonatomic) BOOL decimatesFastForward;
+
+/*!
+ * @property stretchesAudio
+ * @abstract Whether audio keeps its pitch when the rate is not 1.
+ * @discussion
+ * When YES, the buffers returned by -ringBufferAtIndex: play the audio the
+ * core produces faster or slower than real time through an
+ * OEAudioTimeStretcher, and keep the audio of frames skipped by
+ * decimatesFastForward. Only applies to 16-bit audio, and to buffers
+ * created after it is set. Defaults to NO.
+ */
+@property (nonatomic) BOOL stretchesAudio;
+
+/*!
+ * @property adaptsAudioBufferLength
+ * @abstract Whether audio latency adapts to what the machine sustains.
+ * @discussion
+ * When YES, the buffers returned by -ringBufferAtIndex: grow after the host
+ * runs out of audio and shrink back once it hasn't for a while, between
+ * half and four times their initial length. See the adaptsLength property
+ * of OERingBuffer. Only applies to buffers created after it is set.
+ * Defaults to NO.
+ */
+@property (nonatomic) BOOL adaptsAudioBufferLength;
+
+/*!
+ * @property skippingFrame
+ * @abstract YES if the frame currently being executed will not be displayed.
+ * @discussion Only meaningful inside -executeFrame. Cores which can cheaply
+ * skip rendering (but not emulation) may check this property to do so.
+ */
+@property (nonatomic, readonly, getter=isSkippingFrame) BOOL skippingFrame;
+
+/// The number of frames which were executed but not presented.
+@property (readonly) NSUInteger skippedFrameCount;
+/// The number of frames which finished after their deadline.
+@property (readonly) NSUInteger lateFrameCount;
+/// The number of times the game loop fell too far behind and resynchronized.
+@property (readonly) NSUInteger resynchronizationCount;
+
+#pragma mark - Frame Delay
+
+/*!
+ * @property usesFrameDelay
+ * @abstract Whether to start each frame as late as safely possible before its deadline.
+ * @discussion
+ * Normally a frame is executed as soon as its time slot begins, so the input
+ * it reads is up to a full frame old when the frame is shown. With frame
+ * delay, the core thread sleeps into the slot by frameDelay, then performs
+ * queued commands (including input) and executes the frame right away.
+ * The delay is tuned automatically from the 95th percentile of recent frame
+ * execution times and halved whenever a frame misses its deadline.
+ * Only applies at a rate of 1. Defaults to NO.
+ */
+@property (nonatomic) BOOL usesFrameDelay;
+
+/*!
+ * @property frameDelaySafetyMargin
+ * @abstract Time kept free at the end of each frame slot for scheduling jitter.
+ * @discussion Defaults to 2 ms.
+ */
+@property (nonatomic) NSTimeInterval frameDelaySafetyMargin;
+
+/// The delay currently applied to the start of each frame.
+@property (readonly) NSTimeInterval frameDelay;
+/// The 95th percentile of the time taken by recent frames, including -executeFrame and rewind snapshots.
+@property (readonly) NSTimeInterval frameExecutionTime;
+/// The number of frames which missed their deadline because of frame delay.
+@property (readonly) NSUInteger frameDelayMissCount;
+
+#pragma mark - Input Movies
+
+/*!
+ * @property inputMovieRecorder
+ * @abstract Receives frame boundaries and save points while an input movie is recorded.
+ * @discussion Must be set on the core thread, e.g. from -performBlock:.
+ */
+@property (nonatomic, strong, nullable) OEInputMovieRecorder *inputMovieRecorder;
+
+/*!
+ * @property inputMoviePlayer
+ * @abstract Drives the core's inputs from a recorded input movie.
+ * @discussion Must be set on the core thread, e.g. from -performBlock:.
+ */
+@property (nonatomic, strong, nullable) OEInputMoviePlayer *inputMoviePlayer;
+
+/*!
+ * @property runsUncapped
+ * @abstract Whether frames are executed back to back instead of at the frame rate.
+ * @discussion Meant for replaying input movies and benchmarking. Defaults to NO.
+ */
+@property (nonatomic) BOOL runsUncapped;
+
+#pragma mark - Capture
+
+/*!
+ * @property captureWriter
+ * @abstract Records the audio and video produced by the core.
+ * @discussion Must be set on the core thread, e.g. from -performBlock:.
+ * Setting it to nil stops feeding the writer without finishing it.
+ * See OECaptureWriter.
+ */
+@property (nonatomic, strong, nullable) OECaptureWriter *captureWriter;
+
 #pragma mark - Video
 
 /*!
@@ -329,6 +581,33 @@ OE_EXPORTED_CLASS
  */
 - (const void *)getVideoBufferWithHint:(void *)hint;
 
+/*!
+ * @property videoTripleBuffer
+ * @abstract Frames drawn by a bitmap core, for presenting without synchronizing with the core thread.
+ * @discussion
+ * When set, the core calls -getVideoBufferWithHint: itself before each
+ * frame, with the buffer's write buffer as the hint, and publishes every
+ * frame which isn't skipped after -[OERenderDelegate didExecute]. Frames
+ * drawn into another buffer are copied. The render delegate then doesn't
+ * call -getVideoBufferWithHint:, and reads frames with
+ * -[OETripleBuffer acquireLatestFrame] from any one thread.
+ * The buffer must hold bytesPerRow * bufferSize.height bytes.
+ * Must be set on the core thread, e.g. from -performBlock:.
+ */
+@property (nonatomic, strong, nullable) OETripleBuffer *videoTripleBuffer;
+
+/*!
+ * @property frameChangeDetector
+ * @abstract Compares the frames published to videoTripleBuffer with the previous frame.
+ * @discussion
+ * Unchanged frames are not copied or published, and the published frames
+ * carry the dirtyRect of the changes. The render delegate is told with
+ * -[OERenderDelegate didExecuteWithFrameChanges:]. Only used while
+ * videoTripleBuffer is set, which tells the core where the frames are.
+ * Must be set on the core thread, e.g. from -performBlock:.
+ */
+@property (nonatomic, strong, nullable) OEFrameChangeDetector *frameChangeDetector;
+
 /*!
  * @method tryToResizeVideoTo:
  * @discussion
@@ -427,6 +706,26 @@ OE_EXPORTED_CLASS
  */
 @property(readonly) NSInteger   bytesPerRow;
 
+#pragma mark - Snapshots
+
+/*!
+ * @method takeSnapshotWithFormat:size:completionHandler:
+ * @abstract Captures the displayed picture without holding up the core.
+ * @param size The size of the picture. Zero for the screenRect corrected for aspectSize.
+ * @param handler Called on a background queue with the picture and its size, or an error.
+ * @discussion
+ * May be called from any thread. At the next frame boundary, the core
+ * thread copies the screenRect of the frame last published to
+ * videoTripleBuffer into a pooled buffer, which is all the core waits for.
+ * Conversion, scaling and encoding happen on a background queue. Pictures
+ * are scaled by area averaging when shrinking and bilinear interpolation
+ * when enlarging, so snapshots suit thumbnails as well as screenshots.
+ *
+ * Needs videoTripleBuffer, which tells the core where its frames are, and
+ * a published frame; otherwise fails with OEGameCoreCouldNotTakeSnapshotError.
+ */
+- (void)takeSnapshotWithFormat:(OESnapshotFormat)format size:(OEIntSize)size completionHandler:(void(^)(NSData *_Nullable data, OEIntSize size, NSError *_Nullable error))handler;
+
 #pragma mark - Metal 3D
 
 // The methods and properties in this section require OpenEmu 2.4.
@@ -439,11 +738,25 @@ OE_EXPORTED_CLASS
 // TODO: Should this return void? What does it do?
 - (void)getAudioBuffer:(void *)buffer frameCount:(NSUInteger)frameCount bufferIndex:(NSUInteger)index;
 
+/**
+ * Reads audio frames from an audio track, converted to the given format.
+ * @discussion Samples are converted in a single pass from the track's
+ *      audioBitDepth and channel count to the requested sample type, layout
+ *      and channel count. When the track is backed by an OERingBuffer, they
+ *      are converted straight out of the ring buffer's memory. Must only be
+ *      called from one thread per track, e.g. the audio device's.
+ * @param buffers One buffer for interleaved formats, or one per channel for planar formats.
+ * @param index The audio track index.
+ * @returns The number of frames read.
+ */
+- (NSUInteger)readAudioFrames:(NSUInteger)frameCount intoBuffers:(void * const _Nonnull * _Nonnull)buffers format:(OEAudioFormat)format bufferIndex:(NSUInteger)index;
+
 /**
  * Returns the OEAudioBuffer associated to the specified audio track.
  * @discussion A concrete game core can override this method to customize
  *      its audio buffering system. OpenEmu never calls the -write:maxLength: method
- *      of a buffer returned by this method.
+ *      of a buffer returned by this method. Cores can render samples straight
+ *      into the buffer with -reserveWriteRegion: and -commitWrite:.
  * @param index The audio track index.
  * @returns The audio buffer from which to read audio samples.
  */
@@ -476,8 +789,54 @@ OE_EXPORTED_CLASS
  */
 - (NSUInteger)audioBufferSizeForBuffer:(NSUInteger)buffer;
 
+/*!
+ * @property controlsAudioRate
+ * @abstract Whether the emulation rate is adjusted to keep the first audio
+ * buffer at targetAudioBufferFill.
+ * @discussion
+ * The game loop runs on the system clock while audio is consumed on the
+ * audio device clock, so the audio buffer slowly fills up or drains until
+ * samples are dropped or silence is inserted. When enabled, the game loop
+ * runs up to maximumAudioRateAdjustment faster or slower to compensate.
+ * Only applies to the buffers returned by -ringBufferAtIndex:, at a rate of 1,
+ * and does nothing for cores without audio buffers. Hosts which would rather
+ * keep the emulation speed fixed can leave this off and drive the
+ * rateAdjustment of an OEAudioResampler reading the buffer instead.
+ * Defaults to NO.
+ */
+@property (nonatomic) BOOL controlsAudioRate;
+
+/*!
+ * @property targetAudioBufferFill
+ * @abstract The fraction of the audio buffer which should be filled on average.
+ * @discussion Defaults to 0.5.
+ */
+@property (nonatomic) double targetAudioBufferFill;
+
+/*!
+ * @property maximumAudioRateAdjustment
+ * @abstract The largest relative change of the emulation rate made to control the audio buffer fill.
+ * @discussion Defaults to 0.005, which is not audible as a pitch change.
+ */
+@property (nonatomic) double maximumAudioRateAdjustment;
+
+/*!
+ * @property audioRateAdjustment
+ * @abstract The factor currently applied to the emulation rate by audio rate control, e.g. 1.002.
+ * @discussion Audio resamplers may apply the same factor to their ratio.
+ */
+@property (readonly) double audioRateAdjustment;
+
 #pragma mark - Save States
 
+/*!
+ * @method saveStateToFileAtPath:completionHandler:
+ * @discussion
+ * Cores which implement -serializeStateWithError: and
+ * -deserializeState:withError: don't need to override this or
+ * -loadStateFromFileAtPath:completionHandler:. By default, states are
+ * written and read in the background by OESaveStateWriter.sharedWriter.
+ */
 - (void)saveStateToFileAtPath:(NSString *)fileName completionHandler:(void(^)(BOOL success, NSError *_Nullable error))block NS_SWIFT_ASYNC_THROWS_ON_FALSE(1);
 
 - (void)loadStateFromFileAtPath:(NSString *)fileName completionHandler:(void(^)(BOOL success, NSError *_Nullable error))block NS_SWIFT_ASYNC_THROWS_ON_FALSE(1);
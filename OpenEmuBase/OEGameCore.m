@@ -27,13 +27,23 @@
 #import <TargetConditionals.h>
 
 #import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
 #import "OEGameCoreController.h"
 #import "OEAbstractAdditions.h"
 #import "OEAudioBuffer.h"
 #import "OERingBuffer.h"
+#import "OERingBuffer_Internal.h"
+#import "OEAudioTimeStretcher.h"
+#import "OETripleBuffer.h"
+#import "OEFrameChangeDetector.h"
+#import "OEPixelScaler.h"
+#import "OESaveStateWriter.h"
 #import "OETimingUtils.h"
 #import "OELogging.h"
+#import <ImageIO/ImageIO.h>
+#import <os/lock.h>
 #import <os/signpost.h>
+#import <stdatomic.h>
 
 #ifndef BOOL_STR
 #define BOOL_STR(b) ((b) ? "YES" : "NO")
@@ -44,12 +54,27 @@ NSString *const OEGameCoreErrorDomain = @"org.openemu.GameCore.ErrorDomain";
 @implementation OEGameCore
 {
     NSThread *_gameCoreThread;
+    // Retained, and only set and cleared under the lock, so other threads
+    // can retain them before the core thread exits and releases them.
     CFRunLoopRef _gameCoreRunLoop;
+    CFRunLoopSourceRef _wakeUpSource;
+    os_unfair_lock _wakeUpLock;
+
+    OECommandQueue *_commandQueue;
+    atomic_bool _coreThreadParked;
 
     void (^_stopEmulationHandler)(void);
     void (^_frameCallback)(NSTimeInterval frameInterval);
+    void (^_startEmulationHandler)(void);
+
+    // Blocks which overflowed the command queue while driven by a scheduler.
+    NSMutableArray<void (^)(void)> *_scheduledBlocks;
+    os_unfair_lock _scheduledBlocksLock;
+    BOOL parkedOnScheduler;
 
     OERingBuffer __strong **ringBuffers;
+    // Converters used by -readAudioFrames:intoBuffers:format:bufferIndex:, one per audio buffer.
+    OEAudioConverter      **audioConverters;
 
     OEDiffQueue            *rewindQueue;
     NSUInteger              rewindCounter;
@@ -62,6 +87,33 @@ NSString *const OEGameCoreErrorDomain = @"org.openemu.GameCore.ErrorDomain";
     NSTimeInterval          lastRate;
 
     NSUInteger frameCounter;
+
+    NSTimeInterval          averageLateness;
+    NSUInteger              consecutiveSkippedFrames;
+    BOOL                    skipNextFrame;
+    double                  fastForwardPhase;
+
+    double                  averageAudioFill;
+    // The rate the ring buffers were last scaled for.
+    double                  audioBufferRate;
+
+    // Recent frame execution times, for frame delay.
+    NSTimeInterval          executionTimes[64];
+    NSUInteger              executionTimeCount;
+    NSUInteger              frameDelayCooldown;
+
+    // Heartbeat and phase, read by the watchdog thread.
+    atomic_ulong            _heartbeat;
+    atomic_long             _phase;
+    _Atomic(NSTimeInterval) _frameStartTime;
+    NSTimeInterval          _phaseStartTime;
+    OEGameCorePhase         _slowestPhase;
+    NSTimeInterval          _slowestPhaseDuration;
+
+    // Copies of the screenRect waiting to be encoded, reused by later snapshots.
+    NSMutableArray<NSMutableData *> *_snapshotBuffers;
+    os_unfair_lock          _snapshotBuffersLock;
+    dispatch_queue_t        _snapshotQueue;
 }
 
 @synthesize nextFrameTime;
@@ -83,6 +135,24 @@ static Class GameCoreClass = Nil;
     {
         NSUInteger count = [self audioBufferCount];
         ringBuffers = (__strong OERingBuffer **)calloc(count, sizeof(OERingBuffer *));
+        audioConverters = calloc(count, sizeof(OEAudioConverter *));
+        _commandQueue = OECommandQueueCreate(1024);
+
+        _frameSkipThreshold = 0.5;
+        _frameSkipWindow = 8;
+        _maximumFrameLateness = 0.25;
+        audioBufferRate = 1;
+        _targetAudioBufferFill = 0.5;
+        _maximumAudioRateAdjustment = 0.005;
+        _audioRateAdjustment = 1;
+        averageAudioFill = -1;
+        _frameDelaySafetyMargin = 0.002;
+        _schedulerAffinity = NSNotFound;
+        _scheduledBlocksLock = OS_UNFAIR_LOCK_INIT;
+        _wakeUpLock = OS_UNFAIR_LOCK_INIT;
+        _snapshotBuffers = [NSMutableArray array];
+        _snapshotBuffersLock = OS_UNFAIR_LOCK_INIT;
+        _snapshotQueue = dispatch_queue_create("org.openemu.core-snapshots", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
     }
     return self;
 }
@@ -90,9 +160,15 @@ static Class GameCoreClass = Nil;
 - (void)dealloc
 {
     for(NSUInteger i = 0, count = [self audioBufferCount]; i < count; i++)
+    {
         ringBuffers[i] = nil;
+        if(audioConverters[i] != NULL)
+            OEAudioConverterDestroy(audioConverters[i]);
+    }
 
     free(ringBuffers);
+    free(audioConverters);
+    OECommandQueueDestroy(_commandQueue);
 }
 
 - (NSString *)pluginName
@@ -152,20 +228,99 @@ static Class GameCoreClass = Nil;
     _frameCallback = block;
 }
 
+static void OEPerformBlockCommand(const OECommand *command)
+{
+    ((__bridge void (^)(void))command->context)();
+}
+
+static void OEReleaseBlockCommandContext(void *context)
+{
+    (void)(__bridge_transfer id)context;
+}
+
+- (BOOL)pushCommand:(const OECommand *)command
+{
+    if (!OECommandQueuePush(_commandQueue, command))
+        return NO;
+
+    // A running core drains the queue every frame anyway; only a parked one needs a wake-up.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (self.OE_schedulerSlot != nil || atomic_load(&_coreThreadParked))
+        [self OE_wakeUpCoreThread];
+    return YES;
+}
+
+/// Returns the run loop of the core thread and optionally its wake-up
+/// source, retained, or NULL if the thread isn't running.
+static CFRunLoopRef OECopyCoreRunLoop(OEGameCore *self, CFRunLoopSourceRef *outSource)
+{
+    os_unfair_lock_lock(&self->_wakeUpLock);
+    CFRunLoopRef runLoop = self->_gameCoreRunLoop;
+    if (runLoop != NULL) {
+        CFRetain(runLoop);
+        if (outSource != NULL)
+            *outSource = (CFRunLoopSourceRef)CFRetain(self->_wakeUpSource);
+    }
+    os_unfair_lock_unlock(&self->_wakeUpLock);
+    return runLoop;
+}
+
 - (void)performBlock:(void(^)(void))block
 {
-    if (_gameCoreRunLoop == nil) {
+    if (_gameCoreRunLoop == nil && self.OE_schedulerSlot == nil) {
         block();
         return;
     }
 
-    CFRunLoopPerformBlock(_gameCoreRunLoop, kCFRunLoopCommonModes, block);
+    OECommand command = {
+        .function = OEPerformBlockCommand,
+        .context = (__bridge_retained void *)[block copy],
+        .releaseContext = OEReleaseBlockCommandContext,
+        .tag = OECommandTagBlock,
+    };
+    if ([self pushCommand:&command])
+        return;
+
+    OEReleaseBlockCommandContext(command.context);
+    os_log_debug(OE_LOG_DEFAULT, "Command queue full, falling back to the slow path");
+
+    if (self.OE_schedulerSlot != nil) {
+        os_unfair_lock_lock(&_scheduledBlocksLock);
+        if (_scheduledBlocks == nil)
+            _scheduledBlocks = [NSMutableArray array];
+        [_scheduledBlocks addObject:[block copy]];
+        os_unfair_lock_unlock(&_scheduledBlocksLock);
+
+        [self OE_wakeUpCoreThread];
+        return;
+    }
+
+    CFRunLoopRef runLoop = OECopyCoreRunLoop(self, NULL);
+    if (runLoop == NULL) {
+        block();
+        return;
+    }
+
+    CFRunLoopPerformBlock(runLoop, kCFRunLoopCommonModes, block);
+    CFRelease(runLoop);
+    [self OE_wakeUpCoreThread];
+}
+
+static void OEWakeUpSourcePerform(void *info)
+{
+    // Nothing to do, signalling the source is enough to return from the run loop.
 }
 
 - (void)_gameCoreThreadWithStartEmulationCompletionHandler:(void (^)(void))startCompletionHandler
 {
     @autoreleasepool {
-        _gameCoreRunLoop = CFRunLoopGetCurrent();
+        CFRunLoopSourceContext context = { .perform = OEWakeUpSourcePerform };
+        CFRunLoopSourceRef wakeUpSource = CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &context);
+        CFRunLoopAddSource(CFRunLoopGetCurrent(), wakeUpSource, kCFRunLoopCommonModes);
+        os_unfair_lock_lock(&_wakeUpLock);
+        _wakeUpSource = wakeUpSource;
+        _gameCoreRunLoop = (CFRunLoopRef)CFRetain(CFRunLoopGetCurrent());
+        os_unfair_lock_unlock(&_wakeUpLock);
 
         [self startEmulation];
 
@@ -174,10 +329,105 @@ static Class GameCoreClass = Nil;
 
         [self runGameLoop:nil];
 
-        _gameCoreRunLoop = nil;
+        os_unfair_lock_lock(&_wakeUpLock);
+        CFRunLoopRef runLoop = _gameCoreRunLoop;
+        _gameCoreRunLoop = NULL;
+        _wakeUpSource = NULL;
+        os_unfair_lock_unlock(&_wakeUpLock);
+
+        CFRunLoopSourceInvalidate(wakeUpSource);
+        CFRelease(wakeUpSource);
+        CFRelease(runLoop);
     }
 }
 
+/// Wakes up the core thread if it is parked. Safe to call from any thread.
+- (void)OE_wakeUpCoreThread
+{
+    if (self.OE_schedulerSlot != nil) {
+        [_scheduler OE_wakeUpGameCore:self];
+        return;
+    }
+
+    CFRunLoopSourceRef source;
+    CFRunLoopRef runLoop = OECopyCoreRunLoop(self, &source);
+    if (runLoop == NULL)
+        return;
+
+    CFRunLoopSourceSignal(source);
+    CFRunLoopWakeUp(runLoop);
+    CFRelease(source);
+    CFRelease(runLoop);
+}
+
+- (BOOL)OE_shouldPark
+{
+    return _parksWhenPaused && _rate == 0 && !singleFrameStep && !isPausedExecution && !shouldStop;
+}
+
+/// Starts a new heartbeat for the watchdog. The start time is stored first
+/// and published by the heartbeat and phase, so the watchdog never pairs
+/// them with the start time of an earlier frame.
+static void OEBeginFramePhases(OEGameCore *self, NSTimeInterval now)
+{
+    atomic_store_explicit(&self->_frameStartTime, now, memory_order_relaxed);
+    atomic_fetch_add_explicit(&self->_heartbeat, 1, memory_order_release);
+    atomic_store_explicit(&self->_phase, OEGameCorePhaseCommands, memory_order_release);
+    self->_phaseStartTime = now;
+    self->_slowestPhase = OEGameCorePhaseCommands;
+    self->_slowestPhaseDuration = 0;
+}
+
+/// Records what the core thread is doing, and which phase of the frame took the longest.
+static void OESetPhase(OEGameCore *self, OEGameCorePhase phase)
+{
+    NSTimeInterval now = OEMonotonicTime();
+    NSTimeInterval elapsed = now - self->_phaseStartTime;
+    if (elapsed > self->_slowestPhaseDuration) {
+        self->_slowestPhaseDuration = elapsed;
+        self->_slowestPhase = atomic_load_explicit(&self->_phase, memory_order_relaxed);
+    }
+    self->_phaseStartTime = now;
+    atomic_store_explicit(&self->_phase, phase, memory_order_release);
+}
+
+/// Ends a heartbeat which performed commands without running a frame.
+- (void)OE_finishCommandsStartedAt:(NSTimeInterval)startTime phase:(OEGameCorePhase)phase
+{
+    OESetPhase(self, phase);
+    [_watchdog OE_gameCore:self didFinishFrame:self.OE_heartbeat duration:OEMonotonicTime() - startTime budget:1.0 / self.frameInterval slowestPhase:_slowestPhase];
+}
+
+- (void)OE_drainCommandsWhileParked
+{
+    // Commands count as a frame for the watchdog, so a stuck one is still detected.
+    NSTimeInterval startTime = OEMonotonicTime();
+    OEBeginFramePhases(self, startTime);
+    OECommandQueueDrain(_commandQueue);
+    [self OE_finishCommandsStartedAt:startTime phase:OEGameCorePhaseParked];
+}
+
+- (void)OE_parkCoreThread
+{
+    os_log_debug(OE_LOG_DEFAULT, "Parking core thread");
+
+    // Commands sent while parked are run right away, and may unpark us.
+    // The flag is raised before the queue is checked, so a producer either
+    // sees it and wakes us up, or pushed early enough for the drain to see it.
+    atomic_store(&_coreThreadParked, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    while([self OE_drainCommandsWhileParked], [self OE_shouldPark])
+        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 1.0e10, true);
+    atomic_store(&_coreThreadParked, false);
+    OESetPhase(self, OEGameCorePhaseIdle);
+
+    os_log_debug(OE_LOG_DEFAULT, "Unparking core thread");
+
+    // Don't try to catch up on the time spent sleeping.
+    nextFrameTime = OEMonotonicTime();
+    averageLateness = 0;
+}
+
 // GameCores that render direct to OpenGL rather than a buffer should override this and return YES
 // If the GameCore subclass returns YES, the renderDelegate will set the appropriate GL Context
 // So the GameCore subclass can just draw to OpenGL
@@ -203,6 +453,16 @@ static Class GameCoreClass = Nil;
 
 - (void)startEmulationWithCompletionHandler:(void (^)(void))completionHandler
 {
+    if (_scheduler != nil) {
+        if (self.OE_canBeScheduled) {
+            _startEmulationHandler = [completionHandler copy];
+            [_scheduler OE_scheduleGameCore:self];
+            return;
+        }
+
+        os_log_info(OE_LOG_DEFAULT, "%{public}@ cannot be scheduled, running on its own thread", NSStringFromClass([self class]));
+    }
+
     _gameCoreThread = [[NSThread alloc] initWithTarget:self selector:@selector(_gameCoreThreadWithStartEmulationCompletionHandler:) object:completionHandler];
     _gameCoreThread.name = @"org.openemu.core-thread";
     _gameCoreThread.qualityOfService = NSQualityOfServiceUserInteractive;
@@ -240,6 +500,12 @@ static Class GameCoreClass = Nil;
     {
     @autoreleasepool
     {
+        if([self OE_shouldPark])
+        {
+            [self OE_parkCoreThread];
+            continue;
+        }
+
 #if 0
         gameTime += 1. / [self frameInterval];
         if(wasZero && gameTime >= 1)
@@ -253,91 +519,392 @@ static Class GameCoreClass = Nil;
         }
 #endif
         
-        BOOL executing = _rate > 0 || singleFrameStep || isPausedExecution;
+        if(![self OE_runFrame])
+            continue;
+
+        OESetPhase(self, OEGameCorePhaseWait);
+        OEWaitUntil(nextFrameTime + _frameDelay);
+        OESetPhase(self, OEGameCorePhaseIdle);
+        
+        if (_frameCallback)
+            _frameCallback(1.0 / self.frameInterval);
+
+        // Service the run loop exactly once, for timers, sources added by the
+        // core and blocks which overflowed the command queue.
+        // If paused and parksWhenPaused is NO, this still runs at 1x rate.
+        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, 0);
+    }
+    }
 
-        [_delegate gameCoreWillBeginFrame: executing];
+    [[self delegate] gameCoreDidFinishFrameRefreshThread:self];
+}
+
+#pragma mark - Capture
+
+- (void)setCaptureWriter:(OECaptureWriter *)captureWriter
+{
+    if(_captureWriter == captureWriter)
+        return;
+
+    [_captureWriter OE_detachFromGameCore:self];
+    _captureWriter = captureWriter;
+    [_captureWriter OE_attachToGameCore:self];
+}
+
+#pragma mark - Snapshots
+
+// Buffers beyond this many are freed instead of pooled.
+static const NSUInteger OESnapshotBufferPoolCapacity = 2;
+
+static NSData *OEEncodePNG(NSData *bgra, OEIntSize size)
+{
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)bgra);
+    CGImageRef image = CGImageCreate(size.width, size.height, 8, 32, (size_t)size.width * 4, colorSpace,
+                                     kCGBitmapByteOrder32Little | kCGImageAlphaNoneSkipFirst,
+                                     provider, NULL, false, kCGRenderingIntentDefault);
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
+    if(image == NULL)
+        return nil;
+
+    NSMutableData *png = [NSMutableData data];
+    BOOL finalized = NO;
+    CGImageDestinationRef destination = CGImageDestinationCreateWithData((__bridge CFMutableDataRef)png, CFSTR("public.png"), 1, NULL);
+    if(destination != NULL)
+    {
+        CGImageDestinationAddImage(destination, image, NULL);
+        finalized = CGImageDestinationFinalize(destination);
+        CFRelease(destination);
+    }
+    CGImageRelease(image);
+    return finalized ? png : nil;
+}
+
+/// Scales packed pixels to size and encodes them, or returns nil if the pixel format isn't supported.
+static NSData *OEEncodeSnapshot(const void *pixels, size_t bytesPerRow, uint32_t pixelFormat, uint32_t pixelType, OEIntSize sourceSize, OEIntSize size, OESnapshotFormat format)
+{
+    OEPixelScalingMode mode = OEPixelScalingModeBilinear;
+    if(OEIntSizeEqualToSize(sourceSize, size))
+        mode = OEPixelScalingModeNearest;
+    else if(size.width <= sourceSize.width && size.height <= sourceSize.height)
+        mode = OEPixelScalingModeArea;
+
+    OEPixelScaler *scaler = OEPixelScalerCreate(pixelFormat, pixelType, sourceSize.width, sourceSize.height, size.width, size.height, mode);
+    if(scaler == NULL)
+        return nil;
+
+    NSMutableData *bgra = [NSMutableData dataWithLength:(size_t)size.width * size.height * 4];
+    OEPixelScalerScale(scaler, pixels, bytesPerRow, 0, 0, bgra.mutableBytes, (size_t)size.width * 4);
+    OEPixelScalerDestroy(scaler);
+
+    if(format == OESnapshotFormatPNG)
+        return OEEncodePNG(bgra, size);
+    return bgra;
+}
+
+- (void)takeSnapshotWithFormat:(OESnapshotFormat)format size:(OEIntSize)size completionHandler:(void(^)(NSData *data, OEIntSize size, NSError *error))handler
+{
+    handler = [handler copy];
+    [self performBlock:^{
+        [self OE_takeSnapshotWithFormat:format size:size completionHandler:handler];
+    }];
+}
+
+/// Copies the screenRect of the last published frame on the core thread, and leaves the rest to the snapshot queue.
+- (void)OE_takeSnapshotWithFormat:(OESnapshotFormat)format size:(OEIntSize)size completionHandler:(void(^)(NSData *data, OEIntSize size, NSError *error))handler
+{
+    OETripleBuffer *tripleBuffer = _videoTripleBuffer;
+    OETripleBufferFrame frame = tripleBuffer.publishedFrame;
+    uint32_t pixelFormat = tripleBuffer != nil ? self.pixelFormat : 0;
+    uint32_t pixelType = tripleBuffer != nil ? self.pixelType : 0;
+    size_t bytesPerPixel = OEPixelBytesPerPixel(pixelFormat, pixelType);
+    OEIntRect rect = frame.screenRect;
+    if(frame.frameNumber == 0 || bytesPerPixel == 0 || OEIntRectIsEmpty(rect))
+    {
+        dispatch_async(_snapshotQueue, ^{
+            handler(nil, (OEIntSize){}, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreCouldNotTakeSnapshotError userInfo:nil]);
+        });
+        return;
+    }
+
+    size_t bytesPerRow = self.bytesPerRow;
+    size_t rowLength = rect.size.width * bytesPerPixel;
+    NSMutableData *pixels = [self OE_dequeueSnapshotBufferWithLength:rowLength * rect.size.height];
+    const uint8_t *source = (const uint8_t *)frame.bytes + rect.origin.y * bytesPerRow + rect.origin.x * bytesPerPixel;
+    uint8_t *destination = pixels.mutableBytes;
+    for(int y = 0; y < rect.size.height; y++)
+        memcpy(destination + y * rowLength, source + y * bytesPerRow, rowLength);
+
+    if(OEIntSizeIsEmpty(size))
+        size = OECorrectScreenSizeForAspectSize(rect.size, frame.aspectSize);
+
+    dispatch_async(_snapshotQueue, ^{
+        NSData *data = OEEncodeSnapshot(pixels.bytes, rowLength, pixelFormat, pixelType, rect.size, size, format);
+        [self OE_enqueueSnapshotBuffer:pixels];
+        if(data != nil)
+            handler(data, size, nil);
+        else
+            handler(nil, (OEIntSize){}, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreCouldNotTakeSnapshotError userInfo:nil]);
+    });
+}
+
+- (NSMutableData *)OE_dequeueSnapshotBufferWithLength:(NSUInteger)length
+{
+    os_unfair_lock_lock(&_snapshotBuffersLock);
+    NSMutableData *buffer = _snapshotBuffers.lastObject;
+    if(buffer != nil)
+        [_snapshotBuffers removeLastObject];
+    os_unfair_lock_unlock(&_snapshotBuffersLock);
+
+    if(buffer == nil)
+        return [NSMutableData dataWithLength:length];
+    buffer.length = length;
+    return buffer;
+}
+
+- (void)OE_enqueueSnapshotBuffer:(NSMutableData *)buffer
+{
+    os_unfair_lock_lock(&_snapshotBuffersLock);
+    if(_snapshotBuffers.count < OESnapshotBufferPoolCapacity)
+        [_snapshotBuffers addObject:buffer];
+    os_unfair_lock_unlock(&_snapshotBuffersLock);
+}
+
+#pragma mark - Watchdog
 
-        if(executing && isRewinding)
+- (void)setWatchdog:(OEGameCoreWatchdog *)watchdog
+{
+    if (_watchdog == watchdog)
+        return;
+
+    [_watchdog OE_removeGameCore:self];
+    _watchdog = watchdog;
+    [_watchdog OE_addGameCore:self];
+}
+
+- (OEGameCorePhase)currentPhase
+{
+    return atomic_load_explicit(&_phase, memory_order_acquire);
+}
+
+- (NSUInteger)OE_heartbeat
+{
+    return atomic_load_explicit(&_heartbeat, memory_order_acquire);
+}
+
+- (NSTimeInterval)OE_frameStartTime
+{
+    return atomic_load_explicit(&_frameStartTime, memory_order_relaxed);
+}
+
+/// Performs pending commands, then runs one iteration of the game loop unless
+/// a command stopped emulation. Returns NO in that case.
+- (BOOL)OE_runFrame
+{
+    NSTimeInterval startTime = OEMonotonicTime();
+    OEBeginFramePhases(self, startTime);
+
+    // The single point where commands are performed, before anything else in the frame.
+    OECommandQueueDrain(_commandQueue);
+    if(shouldStop)
+    {
+        [self OE_finishCommandsStartedAt:startTime phase:OEGameCorePhaseIdle];
+        return NO;
+    }
+
+    [self OE_runFrameStartedAt:startTime];
+    return YES;
+}
+
+/// Runs one iteration of the game loop, once commands have been performed,
+/// and computes the time of the next one.
+- (void)OE_runFrameStartedAt:(NSTimeInterval)startTime
+{
+    BOOL executing = _rate > 0 || singleFrameStep || isPausedExecution;
+
+    if(_rate > 0 && _rate != audioBufferRate)
+        [self OE_scaleAudioBuffersForRate];
+
+    [_delegate gameCoreWillBeginFrame: executing];
+
+    if(executing && isRewinding)
+    {
+        if (singleFrameStep) {
+            singleFrameStep = isRewinding = NO;
+        }
+
+        OESetPhase(self, OEGameCorePhaseRewind);
+        os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "pop");
+        NSData *state = [[self rewindQueue] pop];
+        os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "pop");
+        if(state)
         {
-            if (singleFrameStep) {
-                singleFrameStep = isRewinding = NO;
-            }
+            [self OE_executeFrame]; // Core callout
 
-            os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "pop");
-            NSData *state = [[self rewindQueue] pop];
-            os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "pop");
+            OESetPhase(self, OEGameCorePhaseRewind);
+            os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "deserializeState");
+            [self deserializeState:state withError:nil];
+            os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "deserializeState");
+        }
+        
+    }
+    else if(executing)
+    {
+        singleFrameStep = NO;
+
+        // The player may restore a save point, so it goes before the rewind snapshot.
+        [_inputMoviePlayer OE_gameCoreWillExecuteFrame:self];
+        [_inputMovieRecorder OE_gameCoreWillExecuteFrame:self];
+
+        if([self supportsRewinding] && rewindCounter == 0)
+        {
+            OESetPhase(self, OEGameCorePhaseSerialize);
+            os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
+            NSData *state = [self serializeStateWithError:nil];
+            os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
             if(state)
             {
-                [self OE_executeFrame]; // Core callout
-
-                os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "deserializeState");
-                [self deserializeState:state withError:nil];
-                os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "deserializeState");
+                OESetPhase(self, OEGameCorePhasePush);
+                os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "push");
+                [[self rewindQueue] push:state];
+                os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "push");
             }
-            
+            rewindCounter = [self rewindInterval];
         }
-        else if(executing)
+        else
         {
-            singleFrameStep = NO;
+            rewindCounter--;
+        }
 
-            if([self supportsRewinding] && rewindCounter == 0)
-            {
-                os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
-                NSData *state = [self serializeStateWithError:nil];
-                os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
-                if(state)
-                {
-                    os_signpost_interval_begin(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "push");
-                    [[self rewindQueue] push:state];
-                    os_signpost_interval_end(OE_LOG_CORE_REWIND, OS_SIGNPOST_ID_EXCLUSIVE, "push");
-                }
-                rewindCounter = [self rewindInterval];
-            }
-            else
-            {
-                rewindCounter--;
-            }
+        [self OE_executeFrame]; // Core callout
+    }
+    
+    [_delegate gameCoreWillEndFrame: executing];
 
-            [self OE_executeFrame]; // Core callout
-        }
-        
-        [_delegate gameCoreWillEndFrame: executing];
+    NSTimeInterval frameRate = self.frameInterval; // the frameInterval property is incorrectly named
+    NSTimeInterval adjustedRate = _rate ?: 1;
+    if(executing)
+        adjustedRate *= [self OE_updateAudioRateAdjustment];
+    NSTimeInterval advance = 1.0 / (frameRate * adjustedRate);
+    nextFrameTime += advance;
+    frameCounter++;
 
-        NSTimeInterval frameRate = self.frameInterval; // the frameInterval property is incorrectly named
-        NSTimeInterval adjustedRate = _rate ?: 1;
-        NSTimeInterval advance = 1.0 / (frameRate * adjustedRate);
-        nextFrameTime += advance;
-        frameCounter++;
+    NSTimeInterval realTime = OEMonotonicTime();
+    if(_runsUncapped)
+        nextFrameTime = realTime;
+    if(executing)
+        [self OE_updateFrameDelayWithExecutionTime:realTime - startTime lateness:realTime - nextFrameTime frameDuration:advance];
+    [self OE_updateFrameSkipAtTime:realTime frameDuration:advance];
 
-        // Sleep till next time.
-        NSTimeInterval realTime = OEMonotonicTime();
+    OESetPhase(self, OEGameCorePhaseIdle);
+    [_watchdog OE_gameCore:self didFinishFrame:self.OE_heartbeat duration:realTime - startTime budget:1.0 / frameRate slowestPhase:_slowestPhase];
+}
 
-        // If we are running more than a second behind, synchronize
-        NSTimeInterval timeOver = realTime - nextFrameTime;
-        if(timeOver >= 1.0)
-        {
-            os_log_debug(OE_LOG_DEFAULT, "Synchronizing because we are %g seconds behind", timeOver);
-            nextFrameTime = realTime;
+#pragma mark - Scheduling
+
+- (BOOL)OE_canBeScheduled
+{
+    if ([self methodForSelector:@selector(runGameLoop:)] != [GameCoreClass instanceMethodForSelector:@selector(runGameLoop:)])
+        return NO;
+
+    return self.gameCoreRendering == OEGameCoreRenderingBitmap && !self.hasAlternateRenderingThread;
+}
+
+- (void)OE_beginScheduledGameLoop
+{
+    [self startEmulation];
+
+    if (_startEmulationHandler != nil)
+        dispatch_async(dispatch_get_main_queue(), _startEmulationHandler);
+    _startEmulationHandler = nil;
+
+    nextFrameTime = OEMonotonicTime();
+}
+
+- (BOOL)OE_runScheduledFrame
+{
+    @autoreleasepool {
+        NSTimeInterval startTime = OEMonotonicTime();
+        OEBeginFramePhases(self, startTime);
+        OECommandQueueDrain(_commandQueue);
+
+        os_unfair_lock_lock(&_scheduledBlocksLock);
+        NSArray<void (^)(void)> *blocks = _scheduledBlocks;
+        _scheduledBlocks = nil;
+        os_unfair_lock_unlock(&_scheduledBlocksLock);
+
+        for (void (^block)(void) in blocks)
+            block();
+
+        if (!shouldStop && ![self OE_shouldPark]) {
+            // Like on a dedicated thread, don't catch up on the time spent parked.
+            if (parkedOnScheduler) {
+                nextFrameTime = OEMonotonicTime();
+                averageLateness = 0;
+                parkedOnScheduler = NO;
+            }
+
+            [self OE_runFrameStartedAt:startTime];
+
+            if (_frameCallback)
+                _frameCallback(1.0 / self.frameInterval);
+        } else {
+            [self OE_finishCommandsStartedAt:startTime phase:shouldStop ? OEGameCorePhaseIdle : OEGameCorePhaseParked];
         }
 
-        OEWaitUntil(nextFrameTime);
-        
-        if (_frameCallback)
-            _frameCallback(1.0 / frameRate);
+        if (shouldStop) {
+            [_delegate gameCoreDidFinishFrameRefreshThread:self];
+            return NO;
+        }
 
-        // Service the event loop, which may now contain HID events, exactly once.
-        // TODO: If paused, this burns CPU waiting to unpause, because it still runs at 1x rate.
-        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, 0);
+        parkedOnScheduler = [self OE_shouldPark];
+        return YES;
     }
+}
+
+- (void)OE_updateFrameSkipAtTime:(NSTimeInterval)realTime frameDuration:(NSTimeInterval)frameDuration
+{
+    NSTimeInterval lateness = realTime - nextFrameTime;
+
+    // If we are too far behind to catch up by skipping frames, synchronize
+    if(lateness >= _maximumFrameLateness)
+    {
+        os_log_debug(OE_LOG_DEFAULT, "Synchronizing because we are %g seconds behind", lateness);
+        nextFrameTime = realTime;
+        averageLateness = 0;
+        consecutiveSkippedFrames = 0;
+        skipNextFrame = NO;
+        _resynchronizationCount++;
+        return;
     }
 
-    [[self delegate] gameCoreDidFinishFrameRefreshThread:self];
+    if(lateness > 0)
+        _lateFrameCount++;
+
+    // Exponential moving average over roughly the last frameSkipWindow frames.
+    // Being early only counts as being on time, so a single fast frame doesn't
+    // hide a core which is consistently running behind.
+    averageLateness += (MAX(lateness, 0) - averageLateness) / MAX(_frameSkipWindow, 1);
+
+    BOOL behind = lateness > 0 && averageLateness > _frameSkipThreshold * frameDuration;
+    if(behind && consecutiveSkippedFrames < _maximumFrameSkip)
+    {
+        skipNextFrame = YES;
+        consecutiveSkippedFrames++;
+    }
+    else
+    {
+        skipNextFrame = NO;
+        consecutiveSkippedFrames = 0;
+    }
 }
 
 - (void)stopEmulation
 {
     [_renderDelegate suspendFPSLimiting];
     shouldStop = YES;
+    [self OE_wakeUpCoreThread];
     os_log_debug(OE_LOG_DEFAULT, "Ending thread");
     [self didStopEmulation];
 }
@@ -383,16 +950,204 @@ static Class GameCoreClass = Nil;
 - (void)OE_executeFrame
 {
     os_signpost_interval_begin(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "OE_executeFrame");
-    [_renderDelegate willExecute];
+
+    id<OERenderDelegate> renderDelegate = _renderDelegate;
+    BOOL decimated = [self OE_shouldDecimateFrame];
+    // Never skip frames the user explicitly asked for, e.g. when stepping.
+    // Frames are only skipped if the render delegate can leave them out,
+    // since cores may not render frames which are skipped.
+    BOOL skipPresentation = (skipNextFrame || decimated) && _rate > 0
+        && [renderDelegate respondsToSelector:@selector(willExecuteSkippedFrame)]
+        && [renderDelegate respondsToSelector:@selector(didExecuteSkippedFrame)];
+    _skippingFrame = skipPresentation;
+
+    if(skipPresentation)
+        [renderDelegate willExecuteSkippedFrame];
+    else
+        [renderDelegate willExecute];
+
+    OETripleBuffer *tripleBuffer = _videoTripleBuffer;
+    const void *videoBuffer = tripleBuffer != nil ? [self getVideoBufferWithHint:tripleBuffer.writeBuffer] : NULL;
     
+    if(decimated)
+        [self OE_setDiscardsAudio:YES];
+
+    OESetPhase(self, OEGameCorePhaseExecute);
     os_signpost_interval_begin(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "executeFrame");
     [self executeFrame];
     os_signpost_interval_end(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "executeFrame");
+
+    if(decimated)
+        [self OE_setDiscardsAudio:NO];
     
-    [_renderDelegate didExecute];
+    if(skipPresentation)
+        [renderDelegate didExecuteSkippedFrame];
+    else
+        [renderDelegate didExecute];
+
+    if(videoBuffer != NULL && !skipPresentation)
+        [self OE_publishVideoBuffer:videoBuffer toTripleBuffer:tripleBuffer renderDelegate:renderDelegate];
+
+    // Frames whose audio was dropped are left out of captures as well, to keep them in sync.
+    if(_captureWriter != nil && (!decimated || ([self audioBufferCount] > 0 && [ringBuffers[0] timeStretcher] != nil)))
+        [_captureWriter OE_gameCoreDidExecuteFrame:self];
+
+    if(_skippingFrame)
+        _skippedFrameCount++;
+    _skippingFrame = NO;
+
     os_signpost_interval_end(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "OE_executeFrame");
 }
 
+/// Publishes the frame the core has just drawn, copying it if the core didn't use the hint.
+/// With a frameChangeDetector, unchanged frames are left out.
+- (void)OE_publishVideoBuffer:(const void *)videoBuffer toTripleBuffer:(OETripleBuffer *)tripleBuffer renderDelegate:(id<OERenderDelegate>)renderDelegate
+{
+    OEIntRect screenRect = self.screenRect;
+    OEIntRect dirtyRect = screenRect;
+    OEFrameChangeDetector *detector = _frameChangeDetector;
+    if(detector != nil)
+    {
+        size_t bytesPerPixel = OEPixelBytesPerPixel(self.pixelFormat, self.pixelType);
+        BOOL changed = [detector detectChangesInFrame:videoBuffer bytesPerRow:self.bytesPerRow bytesPerPixel:bytesPerPixel rect:screenRect];
+        if([renderDelegate respondsToSelector:@selector(didExecuteWithFrameChanges:)])
+            [renderDelegate didExecuteWithFrameChanges:detector];
+        if(!changed)
+            return;
+        dirtyRect = detector.dirtyRect;
+    }
+
+    if(videoBuffer != tripleBuffer.writeBuffer)
+    {
+        size_t length = MIN((size_t)self.bytesPerRow * self.bufferSize.height, tripleBuffer.length);
+        memcpy(tripleBuffer.writeBuffer, videoBuffer, length);
+    }
+
+    [tripleBuffer publishWriteBufferWithScreenRect:screenRect aspectSize:self.aspectSize dirtyRect:dirtyRect];
+}
+
+static int OECompareTimeIntervals(const void *a, const void *b)
+{
+    NSTimeInterval x = *(const NSTimeInterval *)a, y = *(const NSTimeInterval *)b;
+    return (x > y) - (x < y);
+}
+
+/// Tunes frameDelay from recent execution times, backing off after a missed deadline.
+- (void)OE_updateFrameDelayWithExecutionTime:(NSTimeInterval)executionTime lateness:(NSTimeInterval)lateness frameDuration:(NSTimeInterval)frameDuration
+{
+    const NSUInteger capacity = sizeof(executionTimes) / sizeof(executionTimes[0]);
+    executionTimes[executionTimeCount++ % capacity] = executionTime;
+
+    // Sorting 64 values is cheap, but there is no need to do it every frame.
+    if(executionTimeCount % 16 == 0)
+    {
+        NSTimeInterval sorted[capacity];
+        NSUInteger count = MIN(executionTimeCount, capacity);
+        memcpy(sorted, executionTimes, count * sizeof(NSTimeInterval));
+        qsort(sorted, count, sizeof(NSTimeInterval), OECompareTimeIntervals);
+        _frameExecutionTime = sorted[(count * 95) / 100];
+    }
+
+    if(!_usesFrameDelay || _rate != 1 || _runsUncapped || executionTimeCount < 16)
+    {
+        _frameDelay = 0;
+        return;
+    }
+
+    // Back off quickly after a miss, and wait a while before trying again.
+    if(lateness > 0 && _frameDelay > 0)
+    {
+        os_log_debug(OE_LOG_DEFAULT, "Frame delay of %g ms missed the deadline by %g ms", _frameDelay * 1000, lateness * 1000);
+        _frameDelayMissCount++;
+        _frameDelay /= 2;
+        frameDelayCooldown = 120;
+        return;
+    }
+
+    NSTimeInterval target = frameDuration - _frameExecutionTime - _frameDelaySafetyMargin;
+    target = MIN(MAX(target, 0), frameDuration * 0.9);
+
+    if(target < _frameDelay)
+        _frameDelay = target;
+    else if(frameDelayCooldown > 0)
+        frameDelayCooldown--;
+    else
+        _frameDelay = MIN(target, _frameDelay + frameDuration / 64);
+}
+
+/// Nudges the emulation rate so the first audio buffer stays around targetAudioBufferFill.
+- (double)OE_updateAudioRateAdjustment
+{
+    OERingBuffer *ringBuffer = [self audioBufferCount] > 0 ? ringBuffers[0] : nil;
+    if(!_controlsAudioRate || ringBuffer == nil || _rate != 1 || _runsUncapped)
+    {
+        averageAudioFill = -1;
+        _audioRateAdjustment = 1;
+        return 1;
+    }
+
+    // The consumer reads in bursts, so the instantaneous fill is noisy.
+    double fill = (double)ringBuffer.availableBytes / ringBuffer.length;
+    if(averageAudioFill < 0)
+        averageAudioFill = fill;
+    else
+        averageAudioFill += (fill - averageAudioFill) / 16;
+
+    // Proportional control: run faster while below the target, slower while above.
+    double target = MIN(MAX(_targetAudioBufferFill, 0.05), 0.95);
+    double error = (target - averageAudioFill) / (averageAudioFill < target ? target : 1 - target);
+    _audioRateAdjustment = 1 + _maximumAudioRateAdjustment * MIN(MAX(error, -1), 1);
+    return _audioRateAdjustment;
+}
+
+/// Returns YES if the next frame is fast-forwarded and should not be presented.
+- (BOOL)OE_shouldDecimateFrame
+{
+    if(!_decimatesFastForward || _rate <= 1)
+    {
+        fastForwardPhase = 0;
+        return NO;
+    }
+
+    // Present one frame for every 'rate' frames executed, starting with the
+    // first one. Fractional rates alternate between presentation intervals.
+    fastForwardPhase -= 1.0;
+    if(fastForwardPhase > -1.0)
+        return YES;
+
+    fastForwardPhase += _rate;
+    return NO;
+}
+
+- (void)OE_setDiscardsAudio:(BOOL)discardsAudio
+{
+    // Time stretched buffers keep all the audio, and play it faster.
+    for(NSUInteger i = 0, count = [self audioBufferCount]; i < count; i++)
+        if([ringBuffers[i] timeStretcher] == nil)
+            [ringBuffers[i] setDiscardsWrites:discardsAudio];
+}
+
+/// Scales time stretched ring buffers with the rate, so they keep holding the
+/// same duration of real time while audio is produced faster than it is played.
+- (void)OE_scaleAudioBuffersForRate
+{
+    double scale = MAX(_rate, 1.0) / MAX(audioBufferRate, 1.0);
+    audioBufferRate = _rate;
+    if(scale == 1)
+        return;
+
+    for(NSUInteger i = 0, count = [self audioBufferCount]; i < count; i++)
+    {
+        OERingBuffer *buffer = ringBuffers[i];
+        if([buffer timeStretcher] == nil)
+            continue;
+
+        [buffer setMinimumLength:(NSUInteger)([buffer minimumLength] * scale)];
+        [buffer setMaximumLength:(NSUInteger)([buffer maximumLength] * scale)];
+        [buffer setLength:(NSUInteger)([buffer length] * scale)];
+    }
+}
+
 - (void)executeFrame
 {
     [self doesNotImplementSelector:_cmd];
@@ -457,47 +1212,10 @@ static Class GameCoreClass = Nil;
 - (NSInteger)bytesPerRow
 {
     // This default implementation returns bufferSize.width * bytesPerPixel
-    // Calculating bytes per pixel from the OpenGL enums needs a lot of entries.
 
     uint32_t pixelFormat = self.pixelFormat;
     uint32_t pixelType = self.pixelType;
-    int nComponents = 0, bytesPerComponent = 0, bytesPerPixel = 0;
-
-    switch (pixelFormat) {
-        case OEPixelFormat_LUMINANCE:
-            nComponents = 1;
-            break;
-        case OEPixelFormat_RGB:
-        case OEPixelFormat_BGR:
-            nComponents = 3;
-            break;
-        case OEPixelFormat_RGBA:
-        case OEPixelFormat_BGRA:
-            nComponents = 4;
-            break;
-    }
-
-    switch (pixelType) {
-        case OEPixelType_UNSIGNED_BYTE:
-            bytesPerComponent = 1;
-            break;
-        case OEPixelType_UNSIGNED_SHORT_5_6_5:
-        case OEPixelType_UNSIGNED_SHORT_5_6_5_REV:
-        case OEPixelType_UNSIGNED_SHORT_4_4_4_4:
-        case OEPixelType_UNSIGNED_SHORT_4_4_4_4_REV:
-        case OEPixelType_UNSIGNED_SHORT_5_5_5_1:
-        case OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV:
-            bytesPerPixel = 2;
-            break;
-        case OEPixelType_UNSIGNED_INT_8_8_8_8:
-        case OEPixelType_UNSIGNED_INT_8_8_8_8_REV:
-        case OEPixelType_UNSIGNED_INT_10_10_10_2:
-        case OEPixelType_UNSIGNED_INT_2_10_10_10_REV:
-            bytesPerPixel = 4;
-            break;
-    }
-
-    if (!bytesPerPixel) bytesPerPixel = nComponents * bytesPerComponent;
+    size_t bytesPerPixel = OEPixelBytesPerPixel(pixelFormat, pixelType);
     NSAssert(bytesPerPixel, @"Couldn't calculate bytesPerRow: %#x %#x", pixelFormat, pixelType);
 
     return bytesPerPixel * self.bufferSize.width;
@@ -608,9 +1326,19 @@ static Class GameCoreClass = Nil;
     return _rate == 0;
 }
 
+- (void)OE_setRateUnlessPaused:(float)rate
+{
+    if (self.isEmulationPaused) {
+        lastRate = rate;
+    } else {
+        self.rate = rate;
+    }
+}
+
 - (void)fastForwardAtSpeed:(CGFloat)fastForwardSpeed;
 {
-    // FIXME: Need implementation.
+    // The speed is an analog value, from 0 when released to 1 when fully pressed.
+    [self OE_setRateUnlessPaused:1 + 7 * MAX(0, MIN(fastForwardSpeed, 1))];
 }
 
 - (void)rewindAtSpeed:(CGFloat)rewindSpeed;
@@ -620,17 +1348,25 @@ static Class GameCoreClass = Nil;
 
 - (void)slowMotionAtSpeed:(CGFloat)slowMotionSpeed;
 {
-    // FIXME: Need implementation.
+    [self OE_setRateUnlessPaused:1 - 0.75 * MAX(0, MIN(slowMotionSpeed, 1))];
 }
 
 - (void)stepFrameForward
 {
     singleFrameStep = YES;
+    [self OE_wakeUpCoreThread];
 }
 
 - (void)stepFrameBackward
 {
     singleFrameStep = isRewinding = YES;
+    [self OE_wakeUpCoreThread];
+}
+
+- (void)setParksWhenPaused:(BOOL)parksWhenPaused
+{
+    _parksWhenPaused = parksWhenPaused;
+    [self OE_wakeUpCoreThread];
 }
 
 - (void)setRate:(float)rate
@@ -640,6 +1376,12 @@ static Class GameCoreClass = Nil;
     _rate = rate;
     if (_rate > 0.001)
       OESetThreadRealtime(1./(_rate * [self frameInterval]), .007, .03);
+
+    if (_rate > 0)
+        for (NSUInteger i = 0, count = [self audioBufferCount]; i < count; i++)
+            [[ringBuffers[i] timeStretcher] setRate:_rate];
+
+    [self OE_wakeUpCoreThread];
 }
 
 - (void)beginPausedExecution
@@ -647,6 +1389,7 @@ static Class GameCoreClass = Nil;
     if (isPausedExecution == YES) return;
 
     isPausedExecution = YES;
+    [self OE_wakeUpCoreThread];
     [_renderDelegate suspendFPSLimiting];
     [_audioDelegate pauseAudio];
 }
@@ -691,6 +1434,19 @@ static Class GameCoreClass = Nil;
         result = [[OERingBuffer alloc] initWithLength:len];
         [result setDiscardPolicy:OERingBufferDiscardPolicyOldest];
         [result setAnticipatesUnderflow:YES];
+        if(_adaptsAudioBufferLength)
+        {
+            /* let the latency settle between half and four times that,
+             * depending on what the machine sustains without dropouts */
+            [result setMinimumLength:len / 2];
+            [result setMaximumLength:len * 4];
+            [result setAdaptsLength:YES];
+        }
+        if(_stretchesAudio && [self audioBitDepth] == 16)
+        {
+            [result enableTimeStretchingWithChannelCount:channelCount sampleRate:[self audioSampleRateForBuffer:index]];
+            [[result timeStretcher] setRate:_rate > 0 ? _rate : 1];
+        }
         ringBuffers[index] = result;
     }
 
@@ -707,10 +1463,70 @@ static Class GameCoreClass = Nil;
 {
     #pragma clang diagnostic push
     #pragma clang diagnostic ignored "-Wdeprecated-declarations"
-    [[self ringBufferAtIndex:index] read:buffer maxLength:frameCount * [self channelCountForBuffer:index] * sizeof(UInt16)];
+    [[self ringBufferAtIndex:index] read:buffer maxLength:frameCount * [self channelCountForBuffer:index] * [self audioBitDepth] / 8];
     #pragma clang diagnostic pop
 }
 
+- (NSUInteger)readAudioFrames:(NSUInteger)frameCount intoBuffers:(void *const *)buffers format:(OEAudioFormat)format bufferIndex:(NSUInteger)index
+{
+    NSAssert1(index < [self audioBufferCount], @"The index %lu is too high", index);
+
+    OEAudioFormat source = {
+        .sampleType = OEAudioSampleTypeForBitDepth([self audioBitDepth]),
+        .channelCount = (uint32_t)[self channelCountForBuffer:index],
+        .planar = false,
+    };
+
+    OEAudioConverter *converter = audioConverters[index];
+    if(converter != NULL)
+    {
+        const OEAudioFormat *from = OEAudioConverterGetSourceFormat(converter);
+        const OEAudioFormat *to = OEAudioConverterGetDestinationFormat(converter);
+        if(from->sampleType != source.sampleType || from->channelCount != source.channelCount ||
+           to->sampleType != format.sampleType || to->channelCount != format.channelCount || to->planar != format.planar)
+        {
+            OEAudioConverterDestroy(converter);
+            converter = NULL;
+        }
+    }
+    if(converter == NULL)
+    {
+        converter = OEAudioConverterCreate(&source, &format);
+        audioConverters[index] = converter;
+        if(converter == NULL)
+            return 0;
+    }
+
+    id<OEAudioBuffer> audioBuffer = [self audioBufferAtIndex:index];
+    if([audioBuffer isKindOfClass:[OERingBuffer class]])
+        return [(OERingBuffer *)audioBuffer readFrames:frameCount intoBuffers:buffers converter:converter];
+
+    // Cores with their own audio buffers are read in chunks through the stack.
+    NSUInteger sourceFrameSize = OEAudioFormatBytesPerFrame(&source);
+    NSUInteger destinationFrameSize = OEAudioFormatBytesPerFrame(&format);
+    NSUInteger bufferCount = format.planar ? format.channelCount : 1;
+    uint8_t chunk[4096];
+    NSUInteger framesRead = 0;
+    while(framesRead < frameCount)
+    {
+        NSUInteger chunkFrames = MIN(frameCount - framesRead, sizeof(chunk) / sourceFrameSize);
+        NSUInteger received = [audioBuffer read:chunk maxLength:chunkFrames * sourceFrameSize] / sourceFrameSize;
+        if(received == 0)
+            break;
+
+        void *destination[bufferCount];
+        for(NSUInteger i = 0; i < bufferCount; i++)
+            destination[i] = (uint8_t *)buffers[i] + framesRead * destinationFrameSize;
+        const void *chunkBuffer = chunk;
+        OEAudioConverterConvert(converter, &chunkBuffer, destination, received);
+
+        framesRead += received;
+        if(received < chunkFrames)
+            break;
+    }
+    return framesRead;
+}
+
 - (NSUInteger)channelCount
 {
     [self doesNotImplementSelector:_cmd];
@@ -771,12 +1587,24 @@ static Class GameCoreClass = Nil;
 
 - (void)saveStateToFileAtPath:(NSString *)fileName completionHandler:(void(^)(BOOL success, NSError *error))block
 {
-    block(NO, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreDoesNotSupportSaveStatesError userInfo:nil]);
+    if([self methodForSelector:@selector(serializeStateWithError:)] == [GameCoreClass instanceMethodForSelector:@selector(serializeStateWithError:)])
+    {
+        block(NO, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreDoesNotSupportSaveStatesError userInfo:nil]);
+        return;
+    }
+
+    [OESaveStateWriter.sharedWriter saveStateOfGameCore:self toURL:[NSURL fileURLWithPath:fileName] completionHandler:block];
 }
 
 - (void)loadStateFromFileAtPath:(NSString *)fileName completionHandler:(void(^)(BOOL success, NSError *error))block
 {
-    block(NO, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreDoesNotSupportSaveStatesError userInfo:nil]);
+    if([self methodForSelector:@selector(deserializeState:withError:)] == [GameCoreClass instanceMethodForSelector:@selector(deserializeState:withError:)])
+    {
+        block(NO, [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreDoesNotSupportSaveStatesError userInfo:nil]);
+        return;
+    }
+
+    [OESaveStateWriter.sharedWriter loadStateOfGameCore:self fromURL:[NSURL fileURLWithPath:fileName] completionHandler:block];
 }
 
 #pragma mark - Cheats
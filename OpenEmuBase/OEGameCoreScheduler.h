@@ -0,0 +1,76 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OEGameCore;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OEGameCoreScheduler
+ * @abstract Runs many game cores on a fixed pool of threads.
+ * @discussion
+ * By default every OEGameCore runs its game loop on its own thread. Hosts
+ * running many instances at once (headless test runners, netplay hosts, ...)
+ * can instead assign the same scheduler to each core's scheduler property
+ * before starting emulation.
+ *
+ * Each core gets a slot ordered by the deadline of its next frame. Each
+ * worker thread owns a queue of slots; a slot returns to its preferred
+ * worker's queue after each frame, but idle workers steal frames which are
+ * due from other queues, so a frame is executed by whichever worker is free.
+ *
+ * Only bitmap cores which do not override -runGameLoop: can be scheduled.
+ * Other cores silently fall back to running on their own thread.
+ */
+@interface OEGameCoreScheduler : NSObject
+
+- (instancetype)init;
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount NS_DESIGNATED_INITIALIZER;
+
+/// The number of worker threads. Defaults to the number of active processors.
+@property (readonly) NSUInteger threadCount;
+
+/// The number of cores currently driven by the scheduler.
+@property (readonly) NSUInteger gameCoreCount;
+
+/// The number of frames executed by the scheduler.
+@property (readonly) NSUInteger executedFrameCount;
+
+/// The number of frames which were executed by a worker other than the preferred one.
+@property (readonly) NSUInteger stolenFrameCount;
+
+/*!
+ * @method invalidate
+ * @abstract Stops all worker threads once they finish their current frame.
+ * @discussion Cores still scheduled are not stopped and will not run anymore.
+ */
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,318 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <pthread.h>
+#import <os/lock.h>
+#import "OEGameCoreScheduler.h"
+#import "OEGameCore_Internal.h"
+#import "OETimingUtils.h"
+#import "OELogging.h"
+
+typedef NS_ENUM(int, OEGameCoreSlotState) {
+    OEGameCoreSlotStateQueued,
+    OEGameCoreSlotStateRunning,
+    OEGameCoreSlotStateParked,
+};
+
+@interface OEGameCoreSchedulerSlot : NSObject
+{
+@public
+    OEGameCore *gameCore;
+    NSUInteger preferredWorker;
+    BOOL started;
+    std::atomic<int> state;
+    std::atomic<bool> wakeUpPending;
+}
+@end
+
+@implementation OEGameCoreSchedulerSlot
+@end
+
+struct OEScheduledFrame
+{
+    NSTimeInterval deadline;
+    OEGameCoreSchedulerSlot *slot;
+
+    /* std::*_heap build max-heaps, we want the earliest deadline on top. */
+    bool operator<(const OEScheduledFrame& other) const { return deadline > other.deadline; }
+};
+
+struct OESchedulerWorker
+{
+    os_unfair_lock lock = OS_UNFAIR_LOCK_INIT;
+    std::vector<OEScheduledFrame> queue;
+    NSThread *thread = nil;
+};
+
+@implementation OEGameCoreScheduler
+{
+    std::vector<OESchedulerWorker> _workers;
+    std::atomic<NSUInteger> _nextWorker;
+    std::atomic<NSUInteger> _gameCoreCount;
+    std::atomic<NSUInteger> _executedFrameCount;
+    std::atomic<NSUInteger> _stolenFrameCount;
+    std::atomic<bool> _invalidated;
+
+    // Idle workers sleep on this condition until the next deadline or until
+    // a frame is queued. The generation counter avoids lost wake-ups.
+    pthread_mutex_t _idleLock;
+    pthread_cond_t _idleCondition;
+    NSUInteger _generation;
+}
+
+- (instancetype)init
+{
+    return [self initWithThreadCount:NSProcessInfo.processInfo.activeProcessorCount];
+}
+
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount
+{
+    if((self = [super init]))
+    {
+        threadCount = MAX(threadCount, 1);
+        _workers = std::vector<OESchedulerWorker>(threadCount);
+        pthread_mutex_init(&_idleLock, NULL);
+        pthread_cond_init(&_idleCondition, NULL);
+
+        for(NSUInteger i = 0; i < threadCount; i++)
+        {
+            NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(OE_workerMain:) object:@(i)];
+            thread.name = [NSString stringWithFormat:@"org.openemu.core-scheduler.%lu", (unsigned long)i];
+            thread.qualityOfService = NSQualityOfServiceUserInteractive;
+            _workers[i].thread = thread;
+        }
+
+        for(OESchedulerWorker &worker : _workers)
+            [worker.thread start];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    pthread_cond_destroy(&_idleCondition);
+    pthread_mutex_destroy(&_idleLock);
+}
+
+- (NSUInteger)threadCount
+{
+    return _workers.size();
+}
+
+- (NSUInteger)gameCoreCount
+{
+    return _gameCoreCount.load(std::memory_order_relaxed);
+}
+
+- (NSUInteger)executedFrameCount
+{
+    return _executedFrameCount.load(std::memory_order_relaxed);
+}
+
+- (NSUInteger)stolenFrameCount
+{
+    return _stolenFrameCount.load(std::memory_order_relaxed);
+}
+
+- (void)invalidate
+{
+    _invalidated = true;
+    [self OE_signalWorkers];
+}
+
+#pragma mark - Scheduling
+
+- (void)OE_scheduleGameCore:(OEGameCore *)gameCore
+{
+    OEGameCoreSchedulerSlot *slot = [[OEGameCoreSchedulerSlot alloc] init];
+    slot->gameCore = gameCore;
+
+    NSUInteger affinity = gameCore.schedulerAffinity;
+    if(affinity == NSNotFound)
+        affinity = _nextWorker.fetch_add(1, std::memory_order_relaxed);
+    slot->preferredWorker = affinity % _workers.size();
+
+    gameCore.OE_schedulerSlot = slot;
+    _gameCoreCount++;
+
+    [self OE_enqueueSlot:slot deadline:OEMonotonicTime()];
+}
+
+- (void)OE_wakeUpGameCore:(OEGameCore *)gameCore
+{
+    OEGameCoreSchedulerSlot *slot = gameCore.OE_schedulerSlot;
+    if(slot == nil)
+        return;
+
+    slot->wakeUpPending = true;
+    [self OE_unparkSlot:slot];
+}
+
+- (void)OE_unparkSlot:(OEGameCoreSchedulerSlot *)slot
+{
+    int expected = OEGameCoreSlotStateParked;
+    if(slot->state.compare_exchange_strong(expected, OEGameCoreSlotStateQueued))
+        [self OE_enqueueSlot:slot deadline:OEMonotonicTime()];
+}
+
+- (void)OE_enqueueSlot:(OEGameCoreSchedulerSlot *)slot deadline:(NSTimeInterval)deadline
+{
+    slot->state = OEGameCoreSlotStateQueued;
+
+    OESchedulerWorker &worker = _workers[slot->preferredWorker];
+    os_unfair_lock_lock(&worker.lock);
+    worker.queue.push_back({ deadline, slot });
+    std::push_heap(worker.queue.begin(), worker.queue.end());
+    os_unfair_lock_unlock(&worker.lock);
+
+    [self OE_signalWorkers];
+}
+
+- (void)OE_signalWorkers
+{
+    pthread_mutex_lock(&_idleLock);
+    _generation++;
+    pthread_cond_broadcast(&_idleCondition);
+    pthread_mutex_unlock(&_idleLock);
+}
+
+/// Pops the earliest frame of the given worker if it is due. Returns the next deadline otherwise.
+static BOOL OESchedulerPopDueFrame(OESchedulerWorker &worker, NSTimeInterval now, OEScheduledFrame *outFrame, NSTimeInterval *nextDeadline)
+{
+    BOOL popped = NO;
+
+    os_unfair_lock_lock(&worker.lock);
+    if(!worker.queue.empty())
+    {
+        if(worker.queue.front().deadline <= now)
+        {
+            std::pop_heap(worker.queue.begin(), worker.queue.end());
+            *outFrame = worker.queue.back();
+            worker.queue.pop_back();
+            popped = YES;
+        }
+        else
+            *nextDeadline = MIN(*nextDeadline, worker.queue.front().deadline);
+    }
+    os_unfair_lock_unlock(&worker.lock);
+
+    return popped;
+}
+
+- (void)OE_workerMain:(NSNumber *)index
+{
+    NSUInteger workerIndex = index.unsignedIntegerValue;
+    NSUInteger workerCount = _workers.size();
+
+    while(!_invalidated)
+    {
+        @autoreleasepool
+        {
+            pthread_mutex_lock(&_idleLock);
+            NSUInteger generation = _generation;
+            pthread_mutex_unlock(&_idleLock);
+
+            NSTimeInterval now = OEMonotonicTime();
+            NSTimeInterval nextDeadline = DBL_MAX;
+            OEScheduledFrame frame = {};
+            BOOL found = OESchedulerPopDueFrame(_workers[workerIndex], now, &frame, &nextDeadline);
+
+            // Nothing due on our own queue: steal from the others.
+            for(NSUInteger i = 1; !found && i < workerCount; i++)
+            {
+                found = OESchedulerPopDueFrame(_workers[(workerIndex + i) % workerCount], now, &frame, &nextDeadline);
+                if(found)
+                    _stolenFrameCount++;
+            }
+
+            if(found)
+            {
+                [self OE_runSlot:frame.slot];
+                continue;
+            }
+
+            pthread_mutex_lock(&_idleLock);
+            if(generation == _generation && !_invalidated)
+            {
+                if(nextDeadline == DBL_MAX)
+                    pthread_cond_wait(&_idleCondition, &_idleLock);
+                else
+                {
+                    NSTimeInterval timeout = nextDeadline - OEMonotonicTime();
+                    if(timeout > 0)
+                    {
+                        struct timespec ts = {
+                            .tv_sec  = (time_t)timeout,
+                            .tv_nsec = (long)((timeout - (time_t)timeout) * 1e9),
+                        };
+                        pthread_cond_timedwait_relative_np(&_idleCondition, &_idleLock, &ts);
+                    }
+                }
+            }
+            pthread_mutex_unlock(&_idleLock);
+        }
+    }
+}
+
+- (void)OE_runSlot:(OEGameCoreSchedulerSlot *)slot
+{
+    OEGameCore *gameCore = slot->gameCore;
+    slot->state = OEGameCoreSlotStateRunning;
+    slot->wakeUpPending = false;
+
+    if(!slot->started)
+    {
+        [gameCore OE_beginScheduledGameLoop];
+        slot->started = YES;
+    }
+
+    if(![gameCore OE_runScheduledFrame])
+    {
+        os_log_debug(OE_LOG_DEFAULT, "Unscheduling %{public}@", gameCore);
+        gameCore.OE_schedulerSlot = nil;
+        slot->gameCore = nil;
+        _gameCoreCount--;
+        return;
+    }
+
+    _executedFrameCount++;
+
+    if(gameCore.OE_shouldPark)
+    {
+        slot->state = OEGameCoreSlotStateParked;
+        // A wake-up may have come in while we were running the frame.
+        if(slot->wakeUpPending.exchange(false))
+            [self OE_unparkSlot:slot];
+        return;
+    }
+
+    [self OE_enqueueSlot:slot deadline:gameCore.nextFrameTime + gameCore.frameDelay];
+}
+
+@end
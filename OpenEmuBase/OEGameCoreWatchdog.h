@@ -0,0 +1,96 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEGameCore.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, OEGameCoreWatchdogEventType) {
+    /// A frame took longer than slowFrameMultiple frame budgets.
+    OEGameCoreWatchdogEventTypeSlowFrame,
+    /// A frame has been running for longer than stallMultiple frame budgets and hasn't finished yet.
+    OEGameCoreWatchdogEventTypeStall,
+    /// A frame previously reported as stalled has finished.
+    OEGameCoreWatchdogEventTypeRecovery,
+};
+
+@interface OEGameCoreWatchdogEvent : NSObject
+
+@property (readonly) OEGameCoreWatchdogEventType type;
+/// The phase the core thread was in when the event was detected.
+/// For slow frames and recoveries, the slowest phase of the frame.
+@property (readonly) OEGameCorePhase phase;
+/// The number of the frame, counted from the start of emulation.
+@property (readonly) NSUInteger frameNumber;
+/// How long the frame took, or for stalls how long it has been running so far.
+@property (readonly) NSTimeInterval duration;
+/// The duration of a frame at a rate of 1.
+@property (readonly) NSTimeInterval frameBudget;
+
+@end
+
+/*!
+ * @class OEGameCoreWatchdog
+ * @abstract Detects hung or pathologically slow game cores.
+ * @discussion
+ * Assign a watchdog to the watchdog property of one or more cores. Every
+ * frame, the core reports a heartbeat and the phase it is in. Slow frames
+ * are detected when they finish; a separate thread checks every
+ * checkInterval for frames which are still running past stallMultiple
+ * budgets, e.g. because -executeFrame is stuck in an infinite loop.
+ *
+ * Events are counted and passed to the eventHandler, which hosts can use to
+ * recycle wedged instances.
+ */
+@interface OEGameCoreWatchdog : NSObject
+
+/// Frames taking longer than this many frame budgets are reported as slow. Defaults to 2.
+@property (nonatomic) double slowFrameMultiple;
+/// Frames running for longer than this many frame budgets are reported as stalled. Defaults to 60.
+@property (nonatomic) double stallMultiple;
+/// How often the watchdog thread checks for stalled frames. Defaults to 0.1 seconds.
+@property (nonatomic) NSTimeInterval checkInterval;
+
+/// Called on handlerQueue for every event.
+@property (copy, nullable) void (^eventHandler)(OEGameCore *gameCore, OEGameCoreWatchdogEvent *event);
+/// The queue the event handler is called on. Defaults to a private serial queue,
+/// so events are delivered even if the main thread is blocked.
+@property (nonatomic, strong) dispatch_queue_t handlerQueue;
+
+@property (readonly) NSUInteger slowFrameCount;
+@property (readonly) NSUInteger stallCount;
+@property (readonly) NSUInteger recoveryCount;
+
+/// The cores which are currently stalled.
+@property (readonly) NSArray<OEGameCore *> *stalledGameCores;
+
+/// Stops the watchdog thread. Cores are not monitored anymore.
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
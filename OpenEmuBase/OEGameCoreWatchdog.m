@@ -0,0 +1,290 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEGameCoreWatchdog.h"
+#import "OEGameCore_Internal.h"
+#import "OETimingUtils.h"
+#import "OELogging.h"
+#import <os/lock.h>
+
+@implementation OEGameCoreWatchdogEvent
+
+- (instancetype)initWithType:(OEGameCoreWatchdogEventType)type phase:(OEGameCorePhase)phase frameNumber:(NSUInteger)frameNumber duration:(NSTimeInterval)duration frameBudget:(NSTimeInterval)frameBudget
+{
+    if((self = [super init]))
+    {
+        _type = type;
+        _phase = phase;
+        _frameNumber = frameNumber;
+        _duration = duration;
+        _frameBudget = frameBudget;
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    static NSString *const types[] = { @"slow frame", @"stall", @"recovery" };
+    return [NSString stringWithFormat:@"<%@ %p: %@ of frame %lu in phase %ld, %g ms (budget %g ms)>", self.class, self, types[_type], _frameNumber, (long)_phase, _duration * 1000, _frameBudget * 1000];
+}
+
+@end
+
+@interface OEGameCoreWatchdogEntry : NSObject
+{
+@public
+    NSTimeInterval budget;
+    NSUInteger stalledFrame;
+    NSTimeInterval stalledFrameStartTime;
+    BOOL stalled;
+}
+@end
+
+@implementation OEGameCoreWatchdogEntry
+@end
+
+@implementation OEGameCoreWatchdog
+{
+    os_unfair_lock _lock;
+    NSMapTable<OEGameCore *, OEGameCoreWatchdogEntry *> *_entries;
+    NSThread *_thread;
+    dispatch_semaphore_t _stopSemaphore;
+    BOOL _invalidated;
+}
+
+- (instancetype)init
+{
+    if((self = [super init]))
+    {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _entries = [NSMapTable weakToStrongObjectsMapTable];
+        _stopSemaphore = dispatch_semaphore_create(0);
+        _slowFrameMultiple = 2;
+        _stallMultiple = 60;
+        _checkInterval = 0.1;
+        _handlerQueue = dispatch_queue_create("org.openemu.core-watchdog.events", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self invalidate];
+}
+
+- (void)invalidate
+{
+    os_unfair_lock_lock(&_lock);
+    BOOL wasRunning = _thread != nil && !_invalidated;
+    _invalidated = YES;
+    [_entries removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+
+    if(wasRunning)
+        dispatch_semaphore_signal(_stopSemaphore);
+}
+
+#pragma mark - Counters
+
+- (NSUInteger)slowFrameCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _slowFrameCount;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)stallCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _stallCount;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)recoveryCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _recoveryCount;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSArray<OEGameCore *> *)stalledGameCores
+{
+    NSMutableArray<OEGameCore *> *result = [NSMutableArray array];
+    os_unfair_lock_lock(&_lock);
+    for(OEGameCore *gameCore in _entries)
+        if([_entries objectForKey:gameCore]->stalled)
+            [result addObject:gameCore];
+    os_unfair_lock_unlock(&_lock);
+    return result;
+}
+
+#pragma mark - Monitoring
+
+- (void)OE_addGameCore:(OEGameCore *)gameCore
+{
+    OEGameCoreWatchdogEntry *entry = [OEGameCoreWatchdogEntry new];
+    entry->budget = 1.0 / 60;
+
+    os_unfair_lock_lock(&_lock);
+    if(_invalidated)
+    {
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+    [_entries setObject:entry forKey:gameCore];
+    BOOL startThread = _thread == nil;
+    if(startThread)
+    {
+        // The thread only holds the watchdog weakly, so releasing it stops the thread.
+        __weak OEGameCoreWatchdog *weakSelf = self;
+        dispatch_semaphore_t stopSemaphore = _stopSemaphore;
+        _thread = [[NSThread alloc] initWithBlock:^{
+            OEGameCoreWatchdog *watchdog = weakSelf;
+            NSTimeInterval interval = watchdog.checkInterval;
+            watchdog = nil;
+
+            while(dispatch_semaphore_wait(stopSemaphore, dispatch_time(DISPATCH_TIME_NOW, interval * NSEC_PER_SEC)) != 0)
+            {
+                @autoreleasepool {
+                    watchdog = weakSelf;
+                    if(watchdog == nil) break;
+                    [watchdog OE_checkForStalls];
+                    interval = watchdog.checkInterval;
+                    watchdog = nil;
+                }
+            }
+        }];
+        _thread.name = @"org.openemu.core-watchdog";
+        _thread.qualityOfService = NSQualityOfServiceUserInitiated;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if(startThread)
+        [_thread start];
+}
+
+- (void)OE_removeGameCore:(OEGameCore *)gameCore
+{
+    os_unfair_lock_lock(&_lock);
+    [_entries removeObjectForKey:gameCore];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)OE_checkForStalls
+{
+    NSTimeInterval now = OEMonotonicTime();
+    NSMutableArray *events = nil;
+
+    os_unfair_lock_lock(&_lock);
+    for(OEGameCore *gameCore in _entries)
+    {
+        OEGameCoreWatchdogEntry *entry = [_entries objectForKey:gameCore];
+        // In this order, so the start time is never older than the frame
+        // the phase and heartbeat belong to, e.g. right after unparking.
+        OEGameCorePhase phase = gameCore.currentPhase;
+        NSUInteger frameNumber = gameCore.OE_heartbeat;
+        NSTimeInterval frameStartTime = gameCore.OE_frameStartTime;
+
+        // The stalled frame ended without being reported, but a later one began.
+        if(entry->stalled && entry->stalledFrame != frameNumber)
+        {
+            entry->stalled = NO;
+            _recoveryCount++;
+
+            if(events == nil) events = [NSMutableArray array];
+            [events addObject:@[gameCore, [[OEGameCoreWatchdogEvent alloc] initWithType:OEGameCoreWatchdogEventTypeRecovery phase:phase frameNumber:entry->stalledFrame duration:frameStartTime - entry->stalledFrameStartTime frameBudget:entry->budget]]];
+        }
+
+        if(phase == OEGameCorePhaseIdle || phase == OEGameCorePhaseWait || phase == OEGameCorePhaseParked)
+            continue;
+
+        if(entry->stalled)
+            continue;
+
+        NSTimeInterval duration = now - frameStartTime;
+        if(duration <= _stallMultiple * entry->budget)
+            continue;
+
+        entry->stalled = YES;
+        entry->stalledFrame = frameNumber;
+        entry->stalledFrameStartTime = frameStartTime;
+        _stallCount++;
+
+        if(events == nil) events = [NSMutableArray array];
+        [events addObject:@[gameCore, [[OEGameCoreWatchdogEvent alloc] initWithType:OEGameCoreWatchdogEventTypeStall phase:phase frameNumber:frameNumber duration:duration frameBudget:entry->budget]]];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    for(NSArray *pair in events)
+        [self OE_reportEvent:pair[1] forGameCore:pair[0]];
+}
+
+- (void)OE_gameCore:(OEGameCore *)gameCore didFinishFrame:(NSUInteger)frameNumber duration:(NSTimeInterval)duration budget:(NSTimeInterval)budget slowestPhase:(OEGameCorePhase)phase
+{
+    os_unfair_lock_lock(&_lock);
+    OEGameCoreWatchdogEntry *entry = [_entries objectForKey:gameCore];
+    if(entry == nil)
+    {
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+
+    entry->budget = budget;
+    BOOL recovered = entry->stalled && entry->stalledFrame == frameNumber;
+    if(recovered)
+    {
+        entry->stalled = NO;
+        _recoveryCount++;
+    }
+    BOOL slow = duration > _slowFrameMultiple * budget;
+    if(slow)
+        _slowFrameCount++;
+    os_unfair_lock_unlock(&_lock);
+
+    if(slow)
+        [self OE_reportEvent:[[OEGameCoreWatchdogEvent alloc] initWithType:OEGameCoreWatchdogEventTypeSlowFrame phase:phase frameNumber:frameNumber duration:duration frameBudget:budget] forGameCore:gameCore];
+    if(recovered)
+        [self OE_reportEvent:[[OEGameCoreWatchdogEvent alloc] initWithType:OEGameCoreWatchdogEventTypeRecovery phase:phase frameNumber:frameNumber duration:duration frameBudget:budget] forGameCore:gameCore];
+}
+
+- (void)OE_reportEvent:(OEGameCoreWatchdogEvent *)event forGameCore:(OEGameCore *)gameCore
+{
+    if(event.type == OEGameCoreWatchdogEventTypeSlowFrame)
+        os_log_debug(OE_LOG_CORE_RUN, "%{public}@: %{public}@", gameCore.pluginName, event);
+    else
+        os_log_error(OE_LOG_CORE_RUN, "%{public}@: %{public}@", gameCore.pluginName, event);
+
+    void (^handler)(OEGameCore *, OEGameCoreWatchdogEvent *) = self.eventHandler;
+    if(handler != nil)
+        dispatch_async(_handlerQueue, ^{
+            handler(gameCore, event);
+        });
+}
+
+@end
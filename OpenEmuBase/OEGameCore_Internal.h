@@ -0,0 +1,121 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OEGameCore.h"
+#import "OEGameCoreScheduler.h"
+#import "OEGameCoreWatchdog.h"
+#import "OEInputMovie.h"
+#import "OECaptureWriter.h"
+
+@class OEGameCoreSchedulerSlot;
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Glue between OEGameCore and OEGameCoreScheduler.
+@interface OEGameCore ()
+
+/// The slot of the core while it is driven by a scheduler, nil otherwise.
+@property (nullable) OEGameCoreSchedulerSlot *OE_schedulerSlot;
+
+/// YES if the core can run on a scheduler instead of its own thread.
+@property (nonatomic, readonly) BOOL OE_canBeScheduled;
+
+/// YES if the core has nothing to do until it is woken up.
+@property (nonatomic, readonly) BOOL OE_shouldPark;
+
+/// Called on a worker thread before the first scheduled frame.
+- (void)OE_beginScheduledGameLoop;
+
+/*!
+ * Runs pending blocks and a single iteration of the game loop on a worker thread.
+ * @returns NO once the core has stopped and should not be scheduled anymore.
+ */
+- (BOOL)OE_runScheduledFrame;
+
+@end
+
+@interface OEGameCoreScheduler ()
+
+- (void)OE_scheduleGameCore:(OEGameCore *)gameCore;
+- (void)OE_wakeUpGameCore:(OEGameCore *)gameCore;
+
+@end
+
+// Single steps of the game loop, called directly by tests.
+@interface OEGameCore ()
+
+/// Executes one frame, presenting it unless it is skipped.
+- (void)OE_executeFrame;
+
+/// Decides whether to skip the next frame, given the time the current one finished.
+- (void)OE_updateFrameSkipAtTime:(NSTimeInterval)realTime frameDuration:(NSTimeInterval)frameDuration;
+
+/// Tunes frameDelay from the execution time and lateness of the frame which just finished.
+- (void)OE_updateFrameDelayWithExecutionTime:(NSTimeInterval)executionTime lateness:(NSTimeInterval)lateness frameDuration:(NSTimeInterval)frameDuration;
+
+@end
+
+// Glue between OEGameCore and OEGameCoreWatchdog.
+@interface OEGameCore ()
+
+/// The number of the frame in progress, or of the last frame. Safe to read from any thread.
+@property (readonly) NSUInteger OE_heartbeat;
+
+/// When the frame in progress started, in OEMonotonicTime(). Safe to read from
+/// any thread; read after currentPhase or OE_heartbeat, it is at least as
+/// recent as the frame they belong to.
+@property (readonly) NSTimeInterval OE_frameStartTime;
+
+@end
+
+@interface OEGameCoreWatchdog ()
+
+- (void)OE_addGameCore:(OEGameCore *)gameCore;
+- (void)OE_removeGameCore:(OEGameCore *)gameCore;
+
+/// Called on the core thread at the end of every frame.
+- (void)OE_gameCore:(OEGameCore *)gameCore didFinishFrame:(NSUInteger)frameNumber duration:(NSTimeInterval)duration budget:(NSTimeInterval)budget slowestPhase:(OEGameCorePhase)phase;
+
+@end
+
+// Called on the core thread before every executed frame.
+@interface OEInputMovieRecorder ()
+- (void)OE_gameCoreWillExecuteFrame:(OEGameCore *)gameCore;
+@end
+
+@interface OEInputMoviePlayer ()
+- (void)OE_gameCoreWillExecuteFrame:(OEGameCore *)gameCore;
+@end
+
+// Glue between OEGameCore and OECaptureWriter, called on the core thread.
+@interface OECaptureWriter ()
+- (void)OE_attachToGameCore:(OEGameCore *)gameCore;
+- (void)OE_detachFromGameCore:(OEGameCore *)gameCore;
+/// Called after every executed frame whose audio was kept.
+- (void)OE_gameCoreDidExecuteFrame:(OEGameCore *)gameCore;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,121 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OEGameCore;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @typedef OEInputMovieEventHandler
+ * @abstract Delivers a recorded input to the core.
+ * @param player The player number, as in OESystemKey.
+ * @param key The key index, as in OESystemKey.
+ * @param value 1.0 for pressed digital keys, 0.0 for released ones, or the analog value.
+ * @param analog YES if the key is analog.
+ */
+typedef void (^OEInputMovieEventHandler)(NSUInteger player, NSUInteger key, double value, BOOL analog);
+
+/*!
+ * @class OEInputMovieRecorder
+ * @abstract Records every input delivered to a core to an append-only file.
+ * @discussion
+ * The file is a stream of records, each tagged with the number of frames
+ * since the previous record, so an hour of typical gameplay takes a few
+ * hundred kilobytes. Every savePointInterval frames, a save state of the
+ * core and the set of held inputs are embedded as seek points.
+ *
+ * Assign the recorder both to OEGameCore.inputMovieRecorder, which tells it
+ * about frame boundaries, and to OESystemResponder.inputMovieRecorder, which
+ * feeds it inputs. All methods except -init must be called on the core thread.
+ * Rewinding while recording is not supported.
+ */
+@interface OEInputMovieRecorder : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (nullable instancetype)initWithURL:(NSURL *)url error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) NSURL *URL;
+
+/// The number of frames between two save points. 0 disables save points
+/// except the initial one. Defaults to 600.
+@property (nonatomic) NSUInteger savePointInterval;
+
+/// The number of frames recorded so far.
+@property (readonly) NSUInteger frameCount;
+/// The number of input events recorded so far.
+@property (readonly) NSUInteger eventCount;
+/// The number of save points recorded so far.
+@property (readonly) NSUInteger savePointCount;
+
+- (void)recordValue:(double)value forKey:(NSUInteger)key player:(NSUInteger)player analog:(BOOL)analog;
+
+/// Writes any buffered data and closes the file. Further events are ignored.
+- (void)finishRecording;
+
+@end
+
+/*!
+ * @class OEInputMoviePlayer
+ * @abstract Replays a movie recorded by OEInputMovieRecorder.
+ * @discussion
+ * Assign the player to OEGameCore.inputMoviePlayer. Before each frame, the
+ * player sends the inputs recorded for that frame to its eventHandler
+ * (see -[OESystemResponder playInputMovie:]). When the movie starts, the
+ * core is restored to the initial save point so replays are deterministic.
+ */
+@interface OEInputMoviePlayer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (nullable instancetype)initWithURL:(NSURL *)url error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+@property (copy, nullable) OEInputMovieEventHandler eventHandler;
+
+/// Whether the core runs frames back to back while the movie plays. Defaults to YES.
+@property (nonatomic) BOOL uncapped;
+
+/// The number of frames in the movie.
+@property (readonly) NSUInteger frameCount;
+/// The frames at which save points were recorded.
+@property (readonly) NSArray<NSNumber *> *savePointFrames;
+/// The next frame to be played.
+@property (readonly) NSUInteger currentFrame;
+@property (readonly, getter=isFinished) BOOL finished;
+
+/// Called on the main queue when the last frame has been played.
+@property (copy, nullable) void (^completionHandler)(void);
+
+/*!
+ * @method seekToFrame:
+ * @abstract Restarts playback from the last save point at or before the given frame.
+ * @discussion Takes effect before the next frame executed by the core.
+ */
+- (void)seekToFrame:(NSUInteger)frame;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,466 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <map>
+#include <utility>
+#include <vector>
+#import <libkern/OSByteOrder.h>
+#import "OEInputMovie.h"
+#import "OEGameCore_Internal.h"
+#import "OELogging.h"
+
+/* File layout:
+ *   header:  'OEIM' u8 version, 3 bytes reserved
+ *   records: u8 tag, varint frames since previous record, then
+ *     press/release: varint player, varint key
+ *     analog:        varint player, varint key, f32 value
+ *     save point:    varint held count, held count * (varint player, varint key, u8 analog, f32 value),
+ *                    varint state length, state bytes
+ *     end:           nothing, marks the frame count of a finished recording
+ * All multi-byte values are little endian. A truncated last record is ignored.
+ */
+
+static const char OEInputMovieMagic[4] = { 'O', 'E', 'I', 'M' };
+static const uint8_t OEInputMovieVersion = 1;
+static const NSUInteger OEInputMovieFlushThreshold = 64 * 1024;
+
+typedef NS_ENUM(uint8_t, OEInputMovieTag) {
+    OEInputMovieTagPress     = 1,
+    OEInputMovieTagRelease   = 2,
+    OEInputMovieTagAnalog    = 3,
+    OEInputMovieTagSavePoint = 4,
+    OEInputMovieTagEnd       = 5,
+};
+
+typedef std::pair<uint32_t, uint32_t> OEInputMovieKey; // player, key
+
+struct OEInputMovieValue
+{
+    float value;
+    bool analog;
+};
+
+static void OEAppendVarint(NSMutableData *data, uint64_t value)
+{
+    uint8_t bytes[10];
+    size_t n = 0;
+    do {
+        uint8_t b = value & 0x7F;
+        value >>= 7;
+        bytes[n++] = b | (value ? 0x80 : 0);
+    } while(value);
+    [data appendBytes:bytes length:n];
+}
+
+static void OEAppendFloat(NSMutableData *data, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = OSSwapHostToLittleInt32(bits);
+    [data appendBytes:&bits length:sizeof(bits)];
+}
+
+static BOOL OEReadVarint(const uint8_t **p, const uint8_t *end, uint64_t *outValue)
+{
+    uint64_t value = 0;
+    for(int shift = 0; shift < 64 && *p < end; shift += 7)
+    {
+        uint8_t b = *(*p)++;
+        value |= (uint64_t)(b & 0x7F) << shift;
+        if(!(b & 0x80))
+        {
+            *outValue = value;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+static BOOL OEReadFloat(const uint8_t **p, const uint8_t *end, float *outValue)
+{
+    if(end - *p < 4) return NO;
+    uint32_t bits;
+    memcpy(&bits, *p, sizeof(bits));
+    bits = OSSwapLittleToHostInt32(bits);
+    memcpy(outValue, &bits, sizeof(bits));
+    *p += 4;
+    return YES;
+}
+
+#pragma mark - Recorder
+
+@implementation OEInputMovieRecorder
+{
+    NSFileHandle *_fileHandle;
+    dispatch_queue_t _writeQueue;
+    NSMutableData *_buffer;
+
+    NSUInteger _lastRecordFrame;
+    NSUInteger _lastSavePointFrame;
+    BOOL _finished;
+
+    std::map<OEInputMovieKey, OEInputMovieValue> _heldInputs;
+}
+
+- (instancetype)initWithURL:(NSURL *)url error:(NSError **)error
+{
+    if((self = [super init]))
+    {
+        if(![NSFileManager.defaultManager createFileAtPath:url.path contents:nil attributes:nil])
+        {
+            if(error != NULL)
+                *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{ NSURLErrorKey : url }];
+            return nil;
+        }
+
+        _fileHandle = [NSFileHandle fileHandleForWritingToURL:url error:error];
+        if(_fileHandle == nil)
+            return nil;
+
+        _URL = [url copy];
+        _savePointInterval = 600;
+        _writeQueue = dispatch_queue_create("org.openemu.input-movie-writer", DISPATCH_QUEUE_SERIAL);
+
+        _buffer = [NSMutableData dataWithCapacity:OEInputMovieFlushThreshold];
+        uint8_t header[8] = { 0 };
+        memcpy(header, OEInputMovieMagic, sizeof(OEInputMovieMagic));
+        header[4] = OEInputMovieVersion;
+        [_buffer appendBytes:header length:sizeof(header)];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self finishRecording];
+}
+
+- (void)OE_appendTag:(OEInputMovieTag)tag
+{
+    [_buffer appendBytes:&tag length:1];
+    OEAppendVarint(_buffer, _frameCount - _lastRecordFrame);
+    _lastRecordFrame = _frameCount;
+}
+
+- (void)recordValue:(double)value forKey:(NSUInteger)key player:(NSUInteger)player analog:(BOOL)analog
+{
+    if(_finished) return;
+
+    OEInputMovieTag tag = analog ? OEInputMovieTagAnalog : (value != 0 ? OEInputMovieTagPress : OEInputMovieTagRelease);
+    [self OE_appendTag:tag];
+    OEAppendVarint(_buffer, player);
+    OEAppendVarint(_buffer, key);
+    if(analog)
+        OEAppendFloat(_buffer, value);
+
+    OEInputMovieKey k(player, key);
+    if(value != 0)
+        _heldInputs[k] = { analog ? (float)value : 1, (bool)analog };
+    else
+        _heldInputs.erase(k);
+
+    _eventCount++;
+    [self OE_flushIfNeeded:NO];
+}
+
+- (void)OE_gameCoreWillExecuteFrame:(OEGameCore *)gameCore
+{
+    if(_finished) return;
+
+    BOOL savePointDue = _savePointCount == 0 || (_savePointInterval != 0 && _frameCount - _lastSavePointFrame >= _savePointInterval);
+    if(savePointDue)
+        [self OE_appendSavePointForGameCore:gameCore];
+
+    _frameCount++;
+}
+
+- (void)OE_appendSavePointForGameCore:(OEGameCore *)gameCore
+{
+    NSError *error;
+    NSData *state = [gameCore serializeStateWithError:&error];
+    if(state == nil)
+    {
+        os_log_error(OE_LOG_DEFAULT, "Could not record input movie save point: %{public}@", error);
+        // Don't retry every frame.
+        _lastSavePointFrame = _frameCount;
+        if(_savePointCount == 0) _savePointCount = 1;
+        return;
+    }
+
+    [self OE_appendTag:OEInputMovieTagSavePoint];
+    OEAppendVarint(_buffer, _heldInputs.size());
+    for(const auto &held : _heldInputs)
+    {
+        OEAppendVarint(_buffer, held.first.first);
+        OEAppendVarint(_buffer, held.first.second);
+        uint8_t analog = held.second.analog;
+        [_buffer appendBytes:&analog length:1];
+        OEAppendFloat(_buffer, held.second.value);
+    }
+    OEAppendVarint(_buffer, state.length);
+    [_buffer appendData:state];
+
+    _lastSavePointFrame = _frameCount;
+    _savePointCount++;
+    [self OE_flushIfNeeded:YES];
+}
+
+- (void)OE_flushIfNeeded:(BOOL)force
+{
+    if(_buffer.length == 0 || (!force && _buffer.length < OEInputMovieFlushThreshold))
+        return;
+
+    NSData *data = _buffer;
+    _buffer = [NSMutableData dataWithCapacity:OEInputMovieFlushThreshold];
+
+    NSFileHandle *fileHandle = _fileHandle;
+    dispatch_async(_writeQueue, ^{
+        @try {
+            [fileHandle writeData:data];
+        } @catch (NSException *exception) {
+            os_log_error(OE_LOG_DEFAULT, "Could not write input movie: %{public}@", exception.reason);
+        }
+    });
+}
+
+- (void)finishRecording
+{
+    if(_finished) return;
+
+    [self OE_appendTag:OEInputMovieTagEnd];
+    [self OE_flushIfNeeded:YES];
+    _finished = YES;
+
+    NSFileHandle *fileHandle = _fileHandle;
+    dispatch_sync(_writeQueue, ^{
+        [fileHandle closeFile];
+    });
+}
+
+@end
+
+#pragma mark - Player
+
+struct OEInputMovieRecord
+{
+    uint64_t frame;
+    OEInputMovieTag tag;
+    uint32_t player;
+    uint32_t key;
+    float value;
+    /* save points only */
+    std::vector<std::pair<OEInputMovieKey, OEInputMovieValue> > held;
+    NSRange state;
+};
+
+@implementation OEInputMoviePlayer
+{
+    NSData *_data;
+    std::vector<OEInputMovieRecord> _records;
+    size_t _nextRecord;
+    BOOL _started;
+    NSInteger _pendingSeekRecord;
+
+    std::map<OEInputMovieKey, OEInputMovieValue> _appliedInputs;
+}
+
+- (instancetype)initWithURL:(NSURL *)url error:(NSError **)error
+{
+    if((self = [super init]))
+    {
+        _data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:error];
+        if(_data == nil)
+            return nil;
+
+        if(![self OE_parseWithError:error])
+            return nil;
+
+        _uncapped = YES;
+        _pendingSeekRecord = -1;
+    }
+    return self;
+}
+
+- (BOOL)OE_parseWithError:(NSError **)error
+{
+    const uint8_t *begin = (const uint8_t *)_data.bytes;
+    const uint8_t *end = begin + _data.length;
+
+    if(_data.length < 8 || memcmp(begin, OEInputMovieMagic, sizeof(OEInputMovieMagic)) != 0 || begin[4] > OEInputMovieVersion)
+    {
+        if(error != NULL)
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:nil];
+        return NO;
+    }
+
+    const uint8_t *p = begin + 8;
+    uint64_t frame = 0;
+    BOOL ended = NO;
+    NSMutableArray<NSNumber *> *savePointFrames = [NSMutableArray array];
+
+    while(p < end && !ended)
+    {
+        OEInputMovieRecord record = {};
+        uint64_t delta, player, key;
+        record.tag = (OEInputMovieTag)*p++;
+        if(!OEReadVarint(&p, end, &delta)) break;
+        record.frame = frame + delta;
+
+        if(record.tag == OEInputMovieTagSavePoint)
+        {
+            uint64_t heldCount, length;
+            if(!OEReadVarint(&p, end, &heldCount)) break;
+
+            BOOL complete = YES;
+            for(uint64_t i = 0; complete && i < heldCount; i++)
+            {
+                OEInputMovieValue value;
+                complete = OEReadVarint(&p, end, &player) && OEReadVarint(&p, end, &key) && p < end;
+                if(!complete) break;
+                value.analog = *p++ != 0;
+                complete = OEReadFloat(&p, end, &value.value);
+                record.held.push_back({ OEInputMovieKey((uint32_t)player, (uint32_t)key), value });
+            }
+            if(!complete || !OEReadVarint(&p, end, &length) || (uint64_t)(end - p) < length) break;
+
+            record.state = NSMakeRange(p - begin, (NSUInteger)length);
+            p += length;
+            [savePointFrames addObject:@(record.frame)];
+        }
+        else if(record.tag >= OEInputMovieTagPress && record.tag <= OEInputMovieTagAnalog)
+        {
+            if(!OEReadVarint(&p, end, &player) || !OEReadVarint(&p, end, &key)) break;
+            record.player = (uint32_t)player;
+            record.key = (uint32_t)key;
+            record.value = record.tag == OEInputMovieTagPress ? 1 : 0;
+            if(record.tag == OEInputMovieTagAnalog && !OEReadFloat(&p, end, &record.value)) break;
+        }
+        else if(record.tag == OEInputMovieTagEnd)
+        {
+            // The recorder marks the end one past the last frame.
+            frame = record.frame;
+            ended = YES;
+            break;
+        }
+        else
+        {
+            os_log_error(OE_LOG_DEFAULT, "Unknown input movie record %d, stopping", record.tag);
+            break;
+        }
+
+        frame = record.frame;
+        _records.push_back(std::move(record));
+    }
+
+    _frameCount = ended ? (NSUInteger)frame : (NSUInteger)frame + 1;
+    _savePointFrames = [savePointFrames copy];
+    return YES;
+}
+
+- (void)seekToFrame:(NSUInteger)frame
+{
+    NSInteger target = -1;
+    for(size_t i = 0; i < _records.size() && _records[i].frame <= frame; i++)
+        if(_records[i].tag == OEInputMovieTagSavePoint)
+            target = i;
+
+    _pendingSeekRecord = target;
+}
+
+- (void)OE_deliverValue:(float)value forKey:(OEInputMovieKey)key analog:(BOOL)analog
+{
+    if(value != 0)
+        _appliedInputs[key] = { value, (bool)analog };
+    else
+        _appliedInputs.erase(key);
+
+    OEInputMovieEventHandler handler = _eventHandler;
+    if(handler != nil)
+        handler(key.first, key.second, value, analog);
+}
+
+- (void)OE_restoreSavePoint:(size_t)index gameCore:(OEGameCore *)gameCore
+{
+    const OEInputMovieRecord &record = _records[index];
+    NSData *state = [_data subdataWithRange:record.state];
+
+    NSError *error;
+    if(![gameCore deserializeState:state withError:&error])
+        os_log_error(OE_LOG_DEFAULT, "Could not restore input movie save point: %{public}@", error);
+
+    // Release what the movie was holding, then press what was held when recording.
+    std::map<OEInputMovieKey, OEInputMovieValue> previous;
+    previous.swap(_appliedInputs);
+    for(const auto &applied : previous)
+        [self OE_deliverValue:0 forKey:applied.first analog:applied.second.analog];
+    for(const auto &held : record.held)
+        [self OE_deliverValue:held.second.value forKey:held.first analog:held.second.analog];
+
+    _currentFrame = (NSUInteger)record.frame;
+    _nextRecord = index + 1;
+}
+
+- (void)OE_gameCoreWillExecuteFrame:(OEGameCore *)gameCore
+{
+    if(_finished) return;
+
+    if(!_started)
+    {
+        _started = YES;
+        gameCore.runsUncapped = _uncapped;
+        if(_pendingSeekRecord < 0 && !_records.empty() && _records[0].tag == OEInputMovieTagSavePoint)
+            _pendingSeekRecord = 0;
+    }
+
+    if(_pendingSeekRecord >= 0)
+    {
+        [self OE_restoreSavePoint:_pendingSeekRecord gameCore:gameCore];
+        _pendingSeekRecord = -1;
+    }
+
+    for(; _nextRecord < _records.size() && _records[_nextRecord].frame <= _currentFrame; _nextRecord++)
+    {
+        const OEInputMovieRecord &record = _records[_nextRecord];
+        if(record.tag == OEInputMovieTagSavePoint)
+            continue;
+
+        [self OE_deliverValue:record.value forKey:OEInputMovieKey(record.player, record.key) analog:record.tag == OEInputMovieTagAnalog];
+    }
+
+    _currentFrame++;
+
+    if(_currentFrame >= _frameCount)
+    {
+        _finished = YES;
+        gameCore.runsUncapped = NO;
+
+        void (^completionHandler)(void) = _completionHandler;
+        if(completionHandler != nil)
+            dispatch_async(dispatch_get_main_queue(), completionHandler);
+    }
+}
+
+@end
@@ -0,0 +1,411 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OEPixelConversion.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// The number of pixels decoded to BGRA8 at a time. Small enough to stay in L1.
+#define OE_PIXEL_BLOCK_SIZE 256
+
+typedef struct {
+    /// Position and width in the pixel.
+    uint32_t shift;
+    uint32_t bits;
+    uint32_t mask;
+    /// Scales the component to 8 bits: (x * multiplier + rounding) >> expandShift.
+    /// Narrower components replicate their bits, wider ones are rounded.
+    uint32_t multiplier;
+    uint32_t rounding;
+    uint32_t expandShift;
+    /// Position in a BGRA8 pixel.
+    uint32_t bgraShift;
+} OEPixelComponent;
+
+typedef struct {
+    uint32_t bytesPerPixel;
+    uint32_t componentCount;
+    OEPixelComponent components[4];
+    /// OR'ed into decoded pixels, for formats without alpha.
+    uint32_t opaque;
+    /// Luminance decodes to gray through three identical components.
+    bool luminance;
+} OEPixelLayout;
+
+typedef struct {
+    const char *name;
+    /// Decodes pixels to BGRA8.
+    void (*decode)(const OEPixelLayout *layout, const void *source, void *destination, size_t count);
+    /// Encodes BGRA8 pixels.
+    void (*encode)(const OEPixelLayout *layout, const void *source, void *destination, size_t count);
+} OEPixelKernels;
+
+static inline uint32_t OEPixelLoad(const uint8_t *input, size_t bytesPerPixel)
+{
+    uint16_t halfword;
+    uint32_t word;
+    switch(bytesPerPixel)
+    {
+        case 1 : return input[0];
+        case 2 : memcpy(&halfword, input, 2); return halfword;
+        case 3 : return input[0] | (uint32_t)input[1] << 8 | (uint32_t)input[2] << 16;
+        default: memcpy(&word, input, 4); return word;
+    }
+}
+
+static inline void OEPixelStore(uint8_t *output, uint32_t value, size_t bytesPerPixel)
+{
+    uint16_t halfword = value;
+    switch(bytesPerPixel)
+    {
+        case 1 : output[0] = value; break;
+        case 2 : memcpy(output, &halfword, 2); break;
+        case 3 : output[0] = value; output[1] = value >> 8; output[2] = value >> 16; break;
+        default: memcpy(output, &value, 4); break;
+    }
+}
+
+static inline uint32_t OEPixelDecode(const OEPixelLayout *layout, uint32_t value)
+{
+    uint32_t result = layout->opaque;
+    for(size_t c = 0; c < layout->componentCount; c++)
+    {
+        const OEPixelComponent *component = &layout->components[c];
+        uint32_t x = (value >> component->shift) & component->mask;
+        result |= ((x * component->multiplier + component->rounding) >> component->expandShift) << component->bgraShift;
+    }
+    return result;
+}
+
+static inline uint32_t OEPixelEncode(const OEPixelLayout *layout, uint32_t value)
+{
+    if(layout->luminance)
+    {
+        uint32_t r = (value >> 16) & 0xFF, g = (value >> 8) & 0xFF, b = value & 0xFF;
+        return (r * 77 + g * 150 + b * 29 + 128) >> 8;
+    }
+
+    uint32_t result = 0;
+    for(size_t c = 0; c < layout->componentCount; c++)
+    {
+        const OEPixelComponent *component = &layout->components[c];
+        uint32_t x = (value >> component->bgraShift) & 0xFF;
+        if(component->bits < 8)
+        {
+            uint32_t t = x * component->mask + 128;
+            x = (t + (t >> 8)) >> 8;
+        }
+        else if(component->bits > 8)
+            x = (x << (component->bits - 8)) | (x >> (16 - component->bits));
+        result |= x << component->shift;
+    }
+    return result;
+}
+
+// Baseline kernels: SSE2 on x86_64, NEON on arm64.
+#define OE_KERNEL(name) OEPixelVector##name
+#define OE_KERNEL_WIDTH 4
+#define OE_KERNEL_ATTRIBUTES
+#if defined(__x86_64__)
+#define OE_KERNEL_NAME "sse2"
+#elif defined(__arm64__) || defined(__aarch64__)
+#define OE_KERNEL_NAME "neon"
+#else
+#define OE_KERNEL_NAME "vector"
+#endif
+#include "OEPixelConversionKernels.h"
+#undef OE_KERNEL
+#undef OE_KERNEL_WIDTH
+#undef OE_KERNEL_ATTRIBUTES
+#undef OE_KERNEL_NAME
+
+#if defined(__x86_64__)
+#define OE_KERNEL(name) OEPixelAVX2##name
+#define OE_KERNEL_WIDTH 8
+#define OE_KERNEL_ATTRIBUTES __attribute__((target("avx2")))
+#define OE_KERNEL_NAME "avx2"
+#include "OEPixelConversionKernels.h"
+#undef OE_KERNEL
+#undef OE_KERNEL_WIDTH
+#undef OE_KERNEL_ATTRIBUTES
+#undef OE_KERNEL_NAME
+#endif
+
+static const OEPixelKernels *OEPixelBestKernels(void)
+{
+#if defined(__x86_64__)
+    if(__builtin_cpu_supports("avx2"))
+        return &OEPixelAVX2kernels;
+#endif
+    return &OEPixelVectorkernels;
+}
+
+struct OEPixelConverter {
+    OEPixelLayout source;
+    OEPixelLayout destination;
+    const OEPixelKernels *kernels;
+    /// Both layouts are identical.
+    bool identical;
+    bool sourceIsBGRA8;
+    bool destinationIsBGRA8;
+};
+
+#pragma mark - Layouts
+
+// Positions of the components in a BGRA8 pixel.
+enum { OEPixelRed = 16, OEPixelGreen = 8, OEPixelBlue = 0, OEPixelAlpha = 24 };
+
+/// Returns the number of components of a format, and their order in *outOrder.
+static size_t OEPixelFormatComponents(uint32_t pixelFormat, const uint32_t **outOrder)
+{
+    static const uint32_t rgba[] = { OEPixelRed, OEPixelGreen, OEPixelBlue, OEPixelAlpha };
+    static const uint32_t bgra[] = { OEPixelBlue, OEPixelGreen, OEPixelRed, OEPixelAlpha };
+    switch(pixelFormat)
+    {
+        case OEPixelFormat_LUMINANCE : *outOrder = rgba; return 1;
+        case OEPixelFormat_RGB       : *outOrder = rgba; return 3;
+        case OEPixelFormat_BGR       : *outOrder = bgra; return 3;
+        case OEPixelFormat_RGBA      : *outOrder = rgba; return 4;
+        case OEPixelFormat_BGRA      : *outOrder = bgra; return 4;
+        default                      : return 0;
+    }
+}
+
+/*
+ * Returns the number of fields of a packed type, their widths in the order
+ * of the components, and whether the first component is in the least
+ * significant bits. Returns 0 for UNSIGNED_BYTE and unknown types.
+ */
+static size_t OEPixelTypeFields(uint32_t pixelType, const uint32_t **outWidths, bool *outReversed)
+{
+    static const uint32_t w565[] = { 5, 6, 5 };
+    static const uint32_t w4444[] = { 4, 4, 4, 4 };
+    static const uint32_t w5551[] = { 5, 5, 5, 1 };
+    static const uint32_t w8888[] = { 8, 8, 8, 8 };
+    static const uint32_t w1010102[] = { 10, 10, 10, 2 };
+
+    *outReversed = false;
+    switch(pixelType)
+    {
+        case OEPixelType_UNSIGNED_SHORT_5_6_5_REV       : *outReversed = true; // fall through
+        case OEPixelType_UNSIGNED_SHORT_5_6_5           : *outWidths = w565; return 3;
+        case OEPixelType_UNSIGNED_SHORT_4_4_4_4_REV     : *outReversed = true; // fall through
+        case OEPixelType_UNSIGNED_SHORT_4_4_4_4         : *outWidths = w4444; return 4;
+        case OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV     : *outReversed = true; // fall through
+        case OEPixelType_UNSIGNED_SHORT_5_5_5_1         : *outWidths = w5551; return 4;
+        case OEPixelType_UNSIGNED_INT_8_8_8_8_REV       : *outReversed = true; // fall through
+        case OEPixelType_UNSIGNED_INT_8_8_8_8           : *outWidths = w8888; return 4;
+        case OEPixelType_UNSIGNED_INT_2_10_10_10_REV    : *outReversed = true; // fall through
+        case OEPixelType_UNSIGNED_INT_10_10_10_2        : *outWidths = w1010102; return 4;
+        default                                         : return 0;
+    }
+}
+
+size_t OEPixelBytesPerPixel(uint32_t pixelFormat, uint32_t pixelType)
+{
+    const uint32_t *order, *widths;
+    bool reversed;
+    if(pixelType == OEPixelType_UNSIGNED_BYTE)
+        return OEPixelFormatComponents(pixelFormat, &order);
+
+    size_t fieldCount = OEPixelTypeFields(pixelType, &widths, &reversed);
+    if(fieldCount == 0)
+        return 0;
+
+    uint32_t bits = 0;
+    for(size_t i = 0; i < fieldCount; i++)
+        bits += widths[i];
+    return bits / 8;
+}
+
+static bool OEPixelLayoutMake(uint32_t pixelFormat, uint32_t pixelType, OEPixelLayout *layout)
+{
+    static const uint32_t bytes[] = { 8, 8, 8, 8 };
+    const uint32_t *order, *widths;
+    bool reversed;
+
+    size_t componentCount = OEPixelFormatComponents(pixelFormat, &order);
+    size_t fieldCount;
+    if(pixelType == OEPixelType_UNSIGNED_BYTE)
+    {
+        // The first component is in the first byte, which is the least significant one.
+        widths = bytes;
+        fieldCount = componentCount;
+        reversed = true;
+    }
+    else
+        fieldCount = OEPixelTypeFields(pixelType, &widths, &reversed);
+
+    if(componentCount == 0 || fieldCount != componentCount)
+        return false;
+
+    memset(layout, 0, sizeof(*layout));
+    layout->bytesPerPixel = (uint32_t)OEPixelBytesPerPixel(pixelFormat, pixelType);
+    layout->opaque = 0xFFu << OEPixelAlpha;
+
+    uint32_t totalBits = layout->bytesPerPixel * 8, position = 0;
+    for(size_t i = 0; i < fieldCount; i++)
+    {
+        OEPixelComponent *component = &layout->components[i];
+        uint32_t bits = widths[i];
+        component->shift = reversed ? position : totalBits - position - bits;
+        component->bits = bits;
+        component->mask = (1u << bits) - 1;
+        component->bgraShift = order[i];
+        position += bits;
+
+        if(bits == 8)
+        {
+            component->multiplier = 1;
+            component->expandShift = 0;
+        }
+        else if(bits > 8)
+        {
+            // round(x * 255 / mask) with two extra bits of precision, which
+            // is exact for 10-bit components.
+            component->expandShift = bits + 2;
+            component->multiplier = ((255u << component->expandShift) + component->mask / 2) / component->mask;
+            component->rounding = 1u << (component->expandShift - 1);
+        }
+        else
+        {
+            uint32_t replicatedBits = 0;
+            for(; replicatedBits < 8; replicatedBits += bits)
+                component->multiplier |= 1u << replicatedBits;
+            component->expandShift = replicatedBits - 8;
+        }
+
+        if(order[i] == OEPixelAlpha)
+            layout->opaque = 0;
+    }
+    layout->componentCount = (uint32_t)fieldCount;
+
+    if(pixelFormat == OEPixelFormat_LUMINANCE)
+    {
+        layout->luminance = true;
+        layout->componentCount = 3;
+        for(size_t i = 1; i < 3; i++)
+        {
+            layout->components[i] = layout->components[0];
+            layout->components[i].bgraShift = order[i];
+        }
+    }
+
+    return true;
+}
+
+static bool OEPixelLayoutIsBGRA8(const OEPixelLayout *layout)
+{
+    OEPixelLayout bgra8;
+    OEPixelLayoutMake(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, &bgra8);
+    return memcmp(layout, &bgra8, sizeof(bgra8)) == 0;
+}
+
+bool OEPixelFormatIsSupported(uint32_t pixelFormat, uint32_t pixelType)
+{
+    OEPixelLayout layout;
+    return OEPixelLayoutMake(pixelFormat, pixelType, &layout);
+}
+
+#pragma mark - Converter
+
+OEPixelConverter *OEPixelConverterCreate(uint32_t sourcePixelFormat, uint32_t sourcePixelType, uint32_t destinationPixelFormat, uint32_t destinationPixelType)
+{
+    OEPixelLayout source, destination;
+    if(!OEPixelLayoutMake(sourcePixelFormat, sourcePixelType, &source) ||
+       !OEPixelLayoutMake(destinationPixelFormat, destinationPixelType, &destination))
+        return NULL;
+
+    OEPixelConverter *converter = calloc(1, sizeof(OEPixelConverter));
+    if(converter == NULL)
+        return NULL;
+
+    converter->source = source;
+    converter->destination = destination;
+    converter->kernels = OEPixelBestKernels();
+    converter->identical = memcmp(&source, &destination, sizeof(source)) == 0;
+    converter->sourceIsBGRA8 = OEPixelLayoutIsBGRA8(&source);
+    converter->destinationIsBGRA8 = OEPixelLayoutIsBGRA8(&destination);
+
+    return converter;
+}
+
+OEPixelConverter *OEPixelConverterCreateToBGRA8(uint32_t pixelFormat, uint32_t pixelType)
+{
+    return OEPixelConverterCreate(pixelFormat, pixelType, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV);
+}
+
+void OEPixelConverterDestroy(OEPixelConverter *converter)
+{
+    free(converter);
+}
+
+const char *OEPixelConverterGetKernelName(const OEPixelConverter *converter)
+{
+    return converter->kernels->name;
+}
+
+void OEPixelConverterConvertRow(const OEPixelConverter *converter, const void *source, void *destination, size_t width)
+{
+    const OEPixelKernels *kernels = converter->kernels;
+
+    if(converter->identical)
+    {
+        memcpy(destination, source, width * converter->source.bytesPerPixel);
+        return;
+    }
+    if(converter->destinationIsBGRA8)
+    {
+        kernels->decode(&converter->source, source, destination, width);
+        return;
+    }
+    if(converter->sourceIsBGRA8)
+    {
+        kernels->encode(&converter->destination, source, destination, width);
+        return;
+    }
+
+    const uint8_t *input = source;
+    uint8_t *output = destination;
+    uint32_t pixels[OE_PIXEL_BLOCK_SIZE];
+    for(size_t start = 0; start < width; start += OE_PIXEL_BLOCK_SIZE)
+    {
+        size_t length = width - start < OE_PIXEL_BLOCK_SIZE ? width - start : OE_PIXEL_BLOCK_SIZE;
+        kernels->decode(&converter->source, input + start * converter->source.bytesPerPixel, pixels, length);
+        kernels->encode(&converter->destination, pixels, output + start * converter->destination.bytesPerPixel, length);
+    }
+}
+
+void OEPixelConverterConvert(const OEPixelConverter *converter,
+                             const void *source, size_t sourceBytesPerRow, size_t x, size_t y,
+                             void *destination, size_t destinationBytesPerRow,
+                             size_t width, size_t height)
+{
+    const uint8_t *input = (const uint8_t *)source + y * sourceBytesPerRow + x * converter->source.bytesPerPixel;
+    uint8_t *output = destination;
+    for(size_t row = 0; row < height; row++)
+        OEPixelConverterConvertRow(converter, input + row * sourceBytesPerRow, output + row * destinationBytesPerRow, width);
+}
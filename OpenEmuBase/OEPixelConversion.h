@@ -0,0 +1,116 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OEPixelConversion_h
+#define OEPixelConversion_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Converts bitmaps between the pixel formats and types a core can return
+ * from -pixelFormat and -pixelType, which are the 'format' and 'type'
+ * parameters of glTexImage2D.
+ *
+ * Every pixel is decoded to 8-bit BGRA, the format hosts display, and
+ * encoded to the destination in small blocks that stay in L1. Decoding and
+ * encoding use SIMD kernels; the widest instruction set supported by the
+ * CPU is selected at run time when a converter is created. Converting to
+ * or from BGRA8 takes a single pass.
+ *
+ * Components with fewer than 8 bits are expanded by replicating their
+ * bits, so full scale stays full scale; components with more bits are
+ * scaled to 8 bits with rounding. Missing alpha is opaque. Luminance is decoded to gray and
+ * encoded from BT.601 luma.
+ */
+
+// Return values for -pixelFormat
+#define OEPixelFormat_LUMINANCE   0x1909 // GL_LUMINANCE
+#define OEPixelFormat_RGB         0x1907 // GL_RGB
+#define OEPixelFormat_BGR         0x80E0 // GL_BGR
+#define OEPixelFormat_RGBA        0x1908 // GL_RGBA
+#define OEPixelFormat_BGRA        0x80E1 // GL_BGRA
+
+// Return values for -pixelType
+#define OEPixelType_UNSIGNED_BYTE                 0x1401 // GL_UNSIGNED_BYTE
+#define OEPixelType_UNSIGNED_SHORT_5_6_5          0x8363 // GL_UNSIGNED_SHORT_5_6_5
+#define OEPixelType_UNSIGNED_SHORT_5_6_5_REV      0x8364 // GL_UNSIGNED_SHORT_5_6_5_REV
+#define OEPixelType_UNSIGNED_SHORT_4_4_4_4        0x8033 // GL_UNSIGNED_SHORT_4_4_4_4
+#define OEPixelType_UNSIGNED_SHORT_4_4_4_4_REV    0x8365 // GL_UNSIGNED_SHORT_4_4_4_4_REV
+#define OEPixelType_UNSIGNED_SHORT_5_5_5_1        0x8034 // GL_UNSIGNED_SHORT_5_5_5_1
+#define OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV    0x8366 // GL_UNSIGNED_SHORT_1_5_5_5_REV
+#define OEPixelType_UNSIGNED_INT_8_8_8_8          0x8035 // GL_UNSIGNED_INT_8_8_8_8
+#define OEPixelType_UNSIGNED_INT_8_8_8_8_REV      0x8367 // GL_UNSIGNED_INT_8_8_8_8_REV
+#define OEPixelType_UNSIGNED_INT_10_10_10_2       0x8036 // GL_UNSIGNED_INT_10_10_10_2
+#define OEPixelType_UNSIGNED_INT_2_10_10_10_REV   0x8368 // GL_UNSIGNED_INT_2_10_10_10_REV
+
+/// Returns the size of one pixel of the given type, in bytes, or 0 for unknown values.
+/// Only the type is checked for packed types, the format for UNSIGNED_BYTE.
+size_t OEPixelBytesPerPixel(uint32_t pixelFormat, uint32_t pixelType);
+
+/// Returns true if pixels of the given format and type can be converted.
+/// Packed types need as many components as the format has; luminance is only supported as UNSIGNED_BYTE.
+bool OEPixelFormatIsSupported(uint32_t pixelFormat, uint32_t pixelType);
+
+typedef struct OEPixelConverter OEPixelConverter;
+
+/// Creates a converter. Returns NULL if either format and type isn't supported.
+OEPixelConverter *OEPixelConverterCreate(uint32_t sourcePixelFormat, uint32_t sourcePixelType, uint32_t destinationPixelFormat, uint32_t destinationPixelType);
+
+/// Creates a converter to 8-bit BGRA (OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV).
+OEPixelConverter *OEPixelConverterCreateToBGRA8(uint32_t pixelFormat, uint32_t pixelType);
+
+void OEPixelConverterDestroy(OEPixelConverter *converter);
+
+/// Returns the name of the instruction set used by the converter's kernels, e.g. "avx2".
+const char *OEPixelConverterGetKernelName(const OEPixelConverter *converter);
+
+/*
+ * Converts width pixels. Never allocates memory.
+ */
+void OEPixelConverterConvertRow(const OEPixelConverter *converter, const void *source, void *destination, size_t width);
+
+/*
+ * Converts a width x height rectangle whose top left pixel is at column x
+ * and row y of the source, e.g. a core's screenRect, to the top left of
+ * the destination. Rows are sourceBytesPerRow and destinationBytesPerRow
+ * bytes apart, e.g. a core's bytesPerRow. Never allocates memory.
+ */
+void OEPixelConverterConvert(const OEPixelConverter *converter,
+                             const void *source, size_t sourceBytesPerRow, size_t x, size_t y,
+                             void *destination, size_t destinationBytesPerRow,
+                             size_t width, size_t height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OEPixelConversion_h */
@@ -0,0 +1,167 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Pixel decoding and encoding kernels, included by OEPixelConversion.c once
+// per instruction set. The includer defines:
+//   OE_KERNEL(name)       the name of a kernel for this instruction set
+//   OE_KERNEL_WIDTH       the number of pixels in a vector
+//   OE_KERNEL_ATTRIBUTES  attributes enabling the instruction set, if any
+//
+// Pixels are processed a vector at a time as 32-bit lanes. 1 and 3 byte
+// pixels are gathered into lanes by scalar code.
+
+typedef uint32_t OE_KERNEL(UInt32) __attribute__((vector_size(OE_KERNEL_WIDTH * 4)));
+typedef uint16_t OE_KERNEL(UInt16) __attribute__((vector_size(OE_KERNEL_WIDTH * 2)));
+
+static inline __attribute__((always_inline)) OE_KERNEL_ATTRIBUTES
+OE_KERNEL(UInt32) OE_KERNEL(load)(const uint8_t *input, size_t bytesPerPixel)
+{
+    OE_KERNEL(UInt32) value;
+    if(bytesPerPixel == 4)
+        memcpy(&value, input, sizeof(value));
+    else if(bytesPerPixel == 2)
+    {
+        OE_KERNEL(UInt16) packed;
+        memcpy(&packed, input, sizeof(packed));
+        value = __builtin_convertvector(packed, OE_KERNEL(UInt32));
+    }
+    else
+    {
+        for(int i = 0; i < OE_KERNEL_WIDTH; i++)
+            value[i] = OEPixelLoad(input + i * bytesPerPixel, bytesPerPixel);
+    }
+    return value;
+}
+
+static inline __attribute__((always_inline)) OE_KERNEL_ATTRIBUTES
+void OE_KERNEL(store)(uint8_t *output, OE_KERNEL(UInt32) value, size_t bytesPerPixel)
+{
+    if(bytesPerPixel == 4)
+        memcpy(output, &value, sizeof(value));
+    else if(bytesPerPixel == 2)
+    {
+        OE_KERNEL(UInt16) packed = __builtin_convertvector(value, OE_KERNEL(UInt16));
+        memcpy(output, &packed, sizeof(packed));
+    }
+    else
+    {
+        for(int i = 0; i < OE_KERNEL_WIDTH; i++)
+            OEPixelStore(output + i * bytesPerPixel, value[i], bytesPerPixel);
+    }
+}
+
+#pragma mark Decoding
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(decode)(const OEPixelLayout *layout, const void *source, void *destination, size_t count)
+{
+    const uint8_t *input = source;
+    uint8_t *output = destination;
+    size_t bytesPerPixel = layout->bytesPerPixel;
+
+    // Copied out of the layout, so they stay in registers. Missing
+    // components have an empty mask.
+    uint32_t shift[4], mask[4], multiplier[4], rounding[4], expandShift[4], bgraShift[4];
+    for(size_t c = 0; c < 4; c++)
+    {
+        const OEPixelComponent *component = &layout->components[c];
+        shift[c] = component->shift;
+        mask[c] = c < layout->componentCount ? component->mask : 0;
+        multiplier[c] = component->multiplier;
+        rounding[c] = component->rounding;
+        expandShift[c] = component->expandShift;
+        bgraShift[c] = component->bgraShift;
+    }
+    uint32_t opaque = layout->opaque;
+
+    size_t i = 0;
+    for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+    {
+        OE_KERNEL(UInt32) value = OE_KERNEL(load)(input + i * bytesPerPixel, bytesPerPixel);
+        OE_KERNEL(UInt32) result = value * 0 + opaque;
+        for(size_t c = 0; c < 4; c++)
+        {
+            OE_KERNEL(UInt32) x = (value >> shift[c]) & mask[c];
+            result |= ((x * multiplier[c] + rounding[c]) >> expandShift[c]) << bgraShift[c];
+        }
+        memcpy(output + i * 4, &result, sizeof(result));
+    }
+    for(; i < count; i++)
+    {
+        uint32_t pixel = OEPixelDecode(layout, OEPixelLoad(input + i * bytesPerPixel, bytesPerPixel));
+        memcpy(output + i * 4, &pixel, sizeof(pixel));
+    }
+}
+
+#pragma mark Encoding
+
+static OE_KERNEL_ATTRIBUTES void OE_KERNEL(encode)(const OEPixelLayout *layout, const void *source, void *destination, size_t count)
+{
+    const uint8_t *input = source;
+    uint8_t *output = destination;
+    size_t bytesPerPixel = layout->bytesPerPixel;
+    size_t i = 0;
+    for(; i + OE_KERNEL_WIDTH <= count; i += OE_KERNEL_WIDTH)
+    {
+        OE_KERNEL(UInt32) value;
+        memcpy(&value, input + i * 4, sizeof(value));
+        OE_KERNEL(UInt32) result = value * 0;
+        if(layout->luminance)
+        {
+            OE_KERNEL(UInt32) r = (value >> 16) & 0xFF, g = (value >> 8) & 0xFF, b = value & 0xFF;
+            result = (r * 77 + g * 150 + b * 29 + 128) >> 8;
+        }
+        else
+        {
+            for(size_t c = 0; c < layout->componentCount; c++)
+            {
+                const OEPixelComponent *component = &layout->components[c];
+                OE_KERNEL(UInt32) x = (value >> component->bgraShift) & 0xFF;
+                if(component->bits < 8)
+                {
+                    // x * mask / 255, rounded.
+                    OE_KERNEL(UInt32) t = x * component->mask + 128;
+                    x = (t + (t >> 8)) >> 8;
+                }
+                else if(component->bits > 8)
+                    x = (x << (component->bits - 8)) | (x >> (16 - component->bits));
+                result |= x << component->shift;
+            }
+        }
+        OE_KERNEL(store)(output + i * bytesPerPixel, result, bytesPerPixel);
+    }
+    for(; i < count; i++)
+    {
+        uint32_t pixel;
+        memcpy(&pixel, input + i * 4, sizeof(pixel));
+        OEPixelStore(output + i * bytesPerPixel, OEPixelEncode(layout, pixel), bytesPerPixel);
+    }
+}
+
+static const OEPixelKernels OE_KERNEL(kernels) = {
+    .name = OE_KERNEL_NAME,
+    .decode = OE_KERNEL(decode),
+    .encode = OE_KERNEL(encode),
+};
@@ -0,0 +1,394 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OEPixelScaler.h"
+#include "OEPixelConversion.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// The four channels of a BGRA8 pixel, one per lane.
+typedef uint8_t  OEScalerChannels8  __attribute__((vector_size(4)));
+typedef uint16_t OEScalerChannels16 __attribute__((vector_size(8)));
+
+/// Filter weights are fractions of 256.
+#define OE_SCALER_ONE 256
+
+/*
+ * Maps destination pixels to source pixels in one direction. Bilinear
+ * filtering uses starts[i] and starts[i] + 1 with weights[i] as the weight
+ * of the second; area averaging uses counts[i] pixels from starts[i], with
+ * the weights at offsets[i].
+ */
+typedef struct {
+    uint32_t *starts;
+    uint32_t *counts;
+    uint32_t *offsets;
+    uint16_t *weights;
+    size_t sourceLength;
+} OEScalerTable;
+
+struct OEPixelScaler {
+    OEPixelConverter *converter;
+    OEPixelScalingMode mode;
+    size_t bytesPerPixel;
+    size_t sourceWidth;
+    size_t sourceHeight;
+    size_t destinationWidth;
+    size_t destinationHeight;
+    /// Where the source lands in the destination. Only smaller than the destination in integer mode.
+    size_t contentX;
+    size_t contentY;
+    size_t contentWidth;
+    size_t contentHeight;
+    OEScalerTable columns;
+    OEScalerTable rows;
+
+    /// The last decoded source row, as BGRA8.
+    uint32_t *decodedRow;
+    size_t decodedRowIndex;
+    /// Horizontally filtered source rows in 8.8 fixed point, by the parity of their index.
+    OEScalerChannels16 *filteredRows[2];
+    size_t filteredRowIndices[2];
+    /// Area averaging sums for one destination row, per channel.
+    uint32_t *sums;
+};
+
+#pragma mark - Tables
+
+static void OEScalerTableDestroy(OEScalerTable *table)
+{
+    free(table->starts);
+    free(table->counts);
+    free(table->offsets);
+    free(table->weights);
+}
+
+/// Maps each destination pixel to the source pixel under its center.
+static bool OEScalerTableMakeNearest(OEScalerTable *table, size_t sourceLength, size_t destinationLength)
+{
+    table->sourceLength = sourceLength;
+    table->starts = malloc(destinationLength * sizeof(uint32_t));
+    if(table->starts == NULL)
+        return false;
+
+    for(size_t i = 0; i < destinationLength; i++)
+        table->starts[i] = (uint32_t)((2 * i + 1) * sourceLength / (2 * destinationLength));
+    return true;
+}
+
+/// Maps each destination pixel to the two source pixels around its center.
+static bool OEScalerTableMakeBilinear(OEScalerTable *table, size_t sourceLength, size_t destinationLength)
+{
+    table->sourceLength = sourceLength;
+    table->starts = malloc(destinationLength * sizeof(uint32_t));
+    table->weights = malloc(destinationLength * sizeof(uint16_t));
+    if(table->starts == NULL || table->weights == NULL)
+        return false;
+
+    int64_t last = (int64_t)(sourceLength - 1) * OE_SCALER_ONE;
+    for(size_t i = 0; i < destinationLength; i++)
+    {
+        // The center of the pixel in source pixels, minus half a pixel, rounded to 1/256.
+        int64_t position = (int64_t)((2 * i + 1) * sourceLength * OE_SCALER_ONE + destinationLength) / (int64_t)(2 * destinationLength) - OE_SCALER_ONE / 2;
+        position = position < 0 ? 0 : position > last ? last : position;
+        table->starts[i] = (uint32_t)(position / OE_SCALER_ONE);
+        table->weights[i] = (uint16_t)(position % OE_SCALER_ONE);
+    }
+    return true;
+}
+
+/// Maps each destination pixel to the source pixels it covers, weighted by coverage.
+static bool OEScalerTableMakeArea(OEScalerTable *table, size_t sourceLength, size_t destinationLength)
+{
+    table->sourceLength = sourceLength;
+    table->starts = malloc(destinationLength * sizeof(uint32_t));
+    table->counts = malloc(destinationLength * sizeof(uint32_t));
+    table->offsets = malloc(destinationLength * sizeof(uint32_t));
+    table->weights = malloc((sourceLength + 2 * destinationLength) * sizeof(uint16_t));
+    if(table->starts == NULL || table->counts == NULL || table->offsets == NULL || table->weights == NULL)
+        return false;
+
+    // In units of 1 / destinationLength source pixels, destination pixel i
+    // covers [i * sourceLength, (i + 1) * sourceLength) and source pixel j
+    // covers [j * destinationLength, (j + 1) * destinationLength).
+    size_t offset = 0;
+    for(size_t i = 0; i < destinationLength; i++)
+    {
+        size_t low = i * sourceLength, high = (i + 1) * sourceLength;
+        size_t start = low / destinationLength, end = (high + destinationLength - 1) / destinationLength;
+        table->starts[i] = (uint32_t)start;
+        table->counts[i] = (uint32_t)(end - start);
+        table->offsets[i] = (uint32_t)offset;
+
+        // Rounding the running total makes the weights add up to exactly 1.
+        size_t covered = 0, previous = 0;
+        for(size_t j = start; j < end; j++)
+        {
+            size_t from = j * destinationLength > low ? j * destinationLength : low;
+            size_t to = (j + 1) * destinationLength < high ? (j + 1) * destinationLength : high;
+            covered += to - from;
+            size_t total = (covered * OE_SCALER_ONE + sourceLength / 2) / sourceLength;
+            table->weights[offset++] = (uint16_t)(total - previous);
+            previous = total;
+        }
+    }
+    return true;
+}
+
+#pragma mark - Pixels
+
+/// Weighted sums of pixels fit in 16 bits as long as the weights add up to at most OE_SCALER_ONE.
+static inline OEScalerChannels16 OEScalerUnpack(uint32_t pixel)
+{
+    OEScalerChannels8 channels;
+    memcpy(&channels, &pixel, sizeof(channels));
+    return __builtin_convertvector(channels, OEScalerChannels16);
+}
+
+static const uint32_t *OEScalerDecodeRow(OEPixelScaler *scaler, const uint8_t *source, size_t bytesPerRow, size_t row)
+{
+    if(scaler->decodedRowIndex != row)
+    {
+        OEPixelConverterConvertRow(scaler->converter, source + row * bytesPerRow, scaler->decodedRow, scaler->sourceWidth);
+        scaler->decodedRowIndex = row;
+    }
+    return scaler->decodedRow;
+}
+
+/// Returns a source row filtered horizontally to the content width, in 8.8 fixed point.
+static const OEScalerChannels16 *OEScalerFilterRow(OEPixelScaler *scaler, const uint8_t *source, size_t bytesPerRow, size_t row)
+{
+    OEScalerChannels16 *filtered = scaler->filteredRows[row & 1];
+    if(scaler->filteredRowIndices[row & 1] == row)
+        return filtered;
+    scaler->filteredRowIndices[row & 1] = row;
+
+    const uint32_t *pixels = OEScalerDecodeRow(scaler, source, bytesPerRow, row);
+    const OEScalerTable *columns = &scaler->columns;
+    size_t width = scaler->contentWidth;
+
+    if(scaler->mode == OEPixelScalingModeBilinear)
+    {
+        for(size_t i = 0; i < width; i++)
+        {
+            uint32_t start = columns->starts[i];
+            uint32_t weight = columns->weights[i];
+            uint32_t next = start + 1 < columns->sourceLength ? start + 1 : start;
+            filtered[i] = OEScalerUnpack(pixels[start]) * (uint16_t)(OE_SCALER_ONE - weight) + OEScalerUnpack(pixels[next]) * (uint16_t)weight;
+        }
+    }
+    else
+    {
+        for(size_t i = 0; i < width; i++)
+        {
+            const uint32_t *covered = pixels + columns->starts[i];
+            const uint16_t *weights = columns->weights + columns->offsets[i];
+            OEScalerChannels16 sum = { 0 };
+            for(uint32_t j = 0; j < columns->counts[i]; j++)
+                sum += OEScalerUnpack(covered[j]) * weights[j];
+            filtered[i] = sum;
+        }
+    }
+    return filtered;
+}
+
+#pragma mark - Scaler
+
+OEPixelScaler *OEPixelScalerCreate(uint32_t pixelFormat, uint32_t pixelType,
+                                   size_t sourceWidth, size_t sourceHeight,
+                                   size_t destinationWidth, size_t destinationHeight,
+                                   OEPixelScalingMode mode)
+{
+    if(sourceWidth == 0 || sourceHeight == 0 || destinationWidth == 0 || destinationHeight == 0)
+        return NULL;
+
+    OEPixelScaler *scaler = calloc(1, sizeof(OEPixelScaler));
+    if(scaler == NULL)
+        return NULL;
+
+    scaler->mode = mode;
+    scaler->bytesPerPixel = OEPixelBytesPerPixel(pixelFormat, pixelType);
+    scaler->sourceWidth = sourceWidth;
+    scaler->sourceHeight = sourceHeight;
+    scaler->destinationWidth = destinationWidth;
+    scaler->destinationHeight = destinationHeight;
+    scaler->contentWidth = destinationWidth;
+    scaler->contentHeight = destinationHeight;
+    if(mode == OEPixelScalingModeInteger)
+    {
+        if(destinationWidth >= sourceWidth)
+            scaler->contentWidth = destinationWidth / sourceWidth * sourceWidth;
+        if(destinationHeight >= sourceHeight)
+            scaler->contentHeight = destinationHeight / sourceHeight * sourceHeight;
+        scaler->contentX = (destinationWidth - scaler->contentWidth) / 2;
+        scaler->contentY = (destinationHeight - scaler->contentHeight) / 2;
+    }
+
+    bool made;
+    switch(mode)
+    {
+        case OEPixelScalingModeNearest :
+        case OEPixelScalingModeInteger :
+            made = OEScalerTableMakeNearest(&scaler->columns, sourceWidth, scaler->contentWidth)
+                && OEScalerTableMakeNearest(&scaler->rows, sourceHeight, scaler->contentHeight);
+            break;
+        case OEPixelScalingModeBilinear :
+            made = OEScalerTableMakeBilinear(&scaler->columns, sourceWidth, scaler->contentWidth)
+                && OEScalerTableMakeBilinear(&scaler->rows, sourceHeight, scaler->contentHeight);
+            break;
+        case OEPixelScalingModeArea :
+            made = OEScalerTableMakeArea(&scaler->columns, sourceWidth, scaler->contentWidth)
+                && OEScalerTableMakeArea(&scaler->rows, sourceHeight, scaler->contentHeight);
+            break;
+        default :
+            made = false;
+            break;
+    }
+
+    scaler->converter = OEPixelConverterCreateToBGRA8(pixelFormat, pixelType);
+    scaler->decodedRow = malloc(sourceWidth * sizeof(uint32_t));
+    if(mode == OEPixelScalingModeBilinear || mode == OEPixelScalingModeArea)
+    {
+        scaler->filteredRows[0] = malloc(scaler->contentWidth * sizeof(OEScalerChannels16));
+        scaler->filteredRows[1] = malloc(scaler->contentWidth * sizeof(OEScalerChannels16));
+        made = made && scaler->filteredRows[0] != NULL && scaler->filteredRows[1] != NULL;
+    }
+    if(mode == OEPixelScalingModeArea)
+    {
+        scaler->sums = malloc(scaler->contentWidth * 4 * sizeof(uint32_t));
+        made = made && scaler->sums != NULL;
+    }
+
+    if(!made || scaler->converter == NULL || scaler->decodedRow == NULL)
+    {
+        OEPixelScalerDestroy(scaler);
+        return NULL;
+    }
+    return scaler;
+}
+
+void OEPixelScalerDestroy(OEPixelScaler *scaler)
+{
+    if(scaler == NULL)
+        return;
+
+    if(scaler->converter != NULL)
+        OEPixelConverterDestroy(scaler->converter);
+    OEScalerTableDestroy(&scaler->columns);
+    OEScalerTableDestroy(&scaler->rows);
+    free(scaler->decodedRow);
+    free(scaler->filteredRows[0]);
+    free(scaler->filteredRows[1]);
+    free(scaler->sums);
+    free(scaler);
+}
+
+static void OEScalerFillBorders(const OEPixelScaler *scaler, uint8_t *destination, size_t bytesPerRow)
+{
+    const uint32_t black = 0xFF000000;
+    for(size_t y = 0; y < scaler->destinationHeight; y++)
+    {
+        uint32_t *row = (uint32_t *)(destination + y * bytesPerRow);
+        bool inside = y >= scaler->contentY && y < scaler->contentY + scaler->contentHeight;
+        size_t left = inside ? scaler->contentX : scaler->destinationWidth;
+        size_t right = inside ? scaler->contentX + scaler->contentWidth : scaler->destinationWidth;
+        for(size_t x = 0; x < left; x++)
+            row[x] = black;
+        for(size_t x = right; x < scaler->destinationWidth; x++)
+            row[x] = black;
+    }
+}
+
+void OEPixelScalerScale(OEPixelScaler *scaler,
+                        const void *source, size_t sourceBytesPerRow, size_t x, size_t y,
+                        void *destination, size_t destinationBytesPerRow)
+{
+    const uint8_t *input = (const uint8_t *)source + y * sourceBytesPerRow + x * scaler->bytesPerPixel;
+    uint8_t *output = (uint8_t *)destination + scaler->contentY * destinationBytesPerRow + scaler->contentX * sizeof(uint32_t);
+    size_t width = scaler->contentWidth;
+    const OEScalerTable *columns = &scaler->columns, *rows = &scaler->rows;
+
+    // The source changes between calls.
+    scaler->decodedRowIndex = SIZE_MAX;
+    scaler->filteredRowIndices[0] = scaler->filteredRowIndices[1] = SIZE_MAX;
+
+    if(scaler->contentWidth != scaler->destinationWidth || scaler->contentHeight != scaler->destinationHeight)
+        OEScalerFillBorders(scaler, destination, destinationBytesPerRow);
+
+    for(size_t i = 0; i < scaler->contentHeight; i++)
+    {
+        uint32_t *row = (uint32_t *)(output + i * destinationBytesPerRow);
+
+        switch(scaler->mode)
+        {
+            case OEPixelScalingModeNearest :
+            case OEPixelScalingModeInteger :
+            {
+                // Scaling up repeats rows.
+                if(i > 0 && rows->starts[i] == rows->starts[i - 1])
+                {
+                    memcpy(row, output + (i - 1) * destinationBytesPerRow, width * sizeof(uint32_t));
+                    break;
+                }
+                const uint32_t *pixels = OEScalerDecodeRow(scaler, input, sourceBytesPerRow, rows->starts[i]);
+                for(size_t j = 0; j < width; j++)
+                    row[j] = pixels[columns->starts[j]];
+                break;
+            }
+            case OEPixelScalingModeBilinear :
+            {
+                uint32_t start = rows->starts[i];
+                uint32_t weight = rows->weights[i];
+                uint32_t next = start + 1 < rows->sourceLength ? start + 1 : start;
+                const OEScalerChannels16 *top = OEScalerFilterRow(scaler, input, sourceBytesPerRow, start);
+                const OEScalerChannels16 *bottom = OEScalerFilterRow(scaler, input, sourceBytesPerRow, next);
+                // Channel by channel, which vectorizes across pixels.
+                const uint16_t *upper = (const uint16_t *)top, *lower = (const uint16_t *)bottom;
+                uint8_t *channels = (uint8_t *)row;
+                for(size_t j = 0; j < width * 4; j++)
+                    channels[j] = (uint8_t)((upper[j] * (OE_SCALER_ONE - weight) + lower[j] * weight + 0x8000) >> 16);
+                break;
+            }
+            case OEPixelScalingModeArea :
+            {
+                uint32_t *sums = scaler->sums;
+                memset(sums, 0, width * 4 * sizeof(uint32_t));
+                const uint16_t *weights = rows->weights + rows->offsets[i];
+                for(uint32_t k = 0; k < rows->counts[i]; k++)
+                {
+                    const uint16_t *filtered = (const uint16_t *)OEScalerFilterRow(scaler, input, sourceBytesPerRow, rows->starts[i] + k);
+                    uint32_t weight = weights[k];
+                    for(size_t j = 0; j < width * 4; j++)
+                        sums[j] += filtered[j] * weight;
+                }
+                uint8_t *channels = (uint8_t *)row;
+                for(size_t j = 0; j < width * 4; j++)
+                    channels[j] = (uint8_t)((sums[j] + 0x8000) >> 16);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OEPixelScaler_h
+#define OEPixelScaler_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Scales a core's bitmap to 8-bit BGRA on the CPU, for screenshots,
+ * save state thumbnails and previews on hosts without a GPU.
+ *
+ * The scaler reads the screenRect of the core's buffer in place, decoding
+ * source rows with OEPixelConverter only as they are needed, and writes
+ * the destination directly; there is no full-size intermediate copy.
+ * Filtering works on all four channels of a pixel at once with vector
+ * types. Tables are computed once, when the scaler is created, so scale
+ * a stream of frames with the same scaler.
+ *
+ * For aspect correct output, make the destination size
+ * OECorrectScreenSizeForAspectSize(screenRect.size, aspectSize), or a
+ * multiple of it.
+ */
+
+typedef enum OEPixelScalingMode {
+    /// Each destination pixel is the source pixel under its center.
+    OEPixelScalingModeNearest,
+    /// Nearest neighbor by the largest whole factor which fits, horizontally and vertically, centered on opaque black.
+    /// Directions in which the source doesn't fit are scaled down as in OEPixelScalingModeNearest.
+    OEPixelScalingModeInteger,
+    /// Linear interpolation between the four source pixels around the center of each destination pixel.
+    OEPixelScalingModeBilinear,
+    /// Each destination pixel is the average of the source area it covers. Best for scaling down, e.g. thumbnails.
+    OEPixelScalingModeArea,
+} OEPixelScalingMode;
+
+typedef struct OEPixelScaler OEPixelScaler;
+
+/*!
+ * Creates a scaler from sourceWidth x sourceHeight pixels of the given
+ * format and type to destinationWidth x destinationHeight BGRA8 pixels.
+ * Returns NULL if the format and type aren't supported or a size is 0.
+ */
+OEPixelScaler *OEPixelScalerCreate(uint32_t pixelFormat, uint32_t pixelType,
+                                   size_t sourceWidth, size_t sourceHeight,
+                                   size_t destinationWidth, size_t destinationHeight,
+                                   OEPixelScalingMode mode);
+
+void OEPixelScalerDestroy(OEPixelScaler *scaler);
+
+/*
+ * Scales the sourceWidth x sourceHeight rectangle whose top left pixel is
+ * at column x and row y of source, e.g. a core's screenRect, into
+ * destination. Rows are sourceBytesPerRow and destinationBytesPerRow bytes
+ * apart. Never allocates memory. A scaler can only be used by one thread
+ * at a time.
+ */
+void OEPixelScalerScale(OEPixelScaler *scaler,
+                        const void *source, size_t sourceBytesPerRow, size_t x, size_t y,
+                        void *destination, size_t destinationBytesPerRow);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OEPixelScaler_h */
@@ -27,20 +27,67 @@
 #import <Foundation/Foundation.h>
 #import <OpenEmuBase/TPCircularBuffer.h>
 #import <OpenEmuBase/OEAudioBuffer.h>
+#import <OpenEmuBase/OEAudioConversion.h>
 
 typedef NS_ENUM(NSUInteger, OERingBufferDiscardPolicy) {
+    /// Writes that do not fit are refused.
     OERingBufferDiscardPolicyNewest,
+    /// Writes that do not fit overwrite the oldest bytes. Neither side ever
+    /// blocks: a read racing with an overwrite returns only the bytes that
+    /// were not overwritten while it was copying them.
     OERingBufferDiscardPolicyOldest
 };
 
+#define OERingBufferFillHistogramBucketCount 16
+
+/** A snapshot of the health of a ring buffer. Counters accumulate since the
+ *  buffer was created or -resetStatistics was last called. */
+typedef struct {
+    /// Bytes passed to writes, including discarded ones, and bytes returned by reads.
+    uint64_t bytesWritten;
+    uint64_t bytesRead;
+
+    uint64_t writeCount;
+    /// Writes which didn't fit in the free space.
+    uint64_t overrunCount;
+    /// Bytes lost to overruns: refused writes with OERingBufferDiscardPolicyNewest,
+    /// or unread bytes overwritten with OERingBufferDiscardPolicyOldest.
+    uint64_t discardedBytes;
+
+    uint64_t readCount;
+    /// Reads which returned less than requested.
+    uint64_t underrunCount;
+    /// Reads which returned nothing because of anticipatesUnderflow.
+    uint64_t refusedReadCount;
+    /// Bytes dropped by reads because they were overwritten while being read.
+    uint64_t tornBytes;
+
+    /// The fill level seen by each read. Bucket i counts reads which found
+    /// between i/16 and (i+1)/16 of the buffer filled.
+    uint64_t fillHistogram[OERingBufferFillHistogramBucketCount];
+
+    NSUInteger availableBytes;
+    NSUInteger length;
+
+    /// The time since the previous snapshot, and the average rates over it, in bytes per second.
+    NSTimeInterval interval;
+    double producerRate;
+    double consumerRate;
+} OERingBufferStatistics;
+
 @interface OERingBuffer : NSObject <OEAudioBuffer>
 
 - (instancetype)initWithLength:(NSUInteger)length;
 
+/** Resizing keeps the unread bytes that fit and never stops the consumer,
+ *  which may keep reading during the resize. Must be called by the producer,
+ *  or before the buffer is shared, and not between -reserveWriteRegion: and
+ *  -commitWrite:. */
 @property           NSUInteger length;
 @property(readonly) NSUInteger availableBytes;
 @property(readonly) NSUInteger freeBytes;
 @property(readonly) NSUInteger bytesWritten;
+@property(readonly) NSUInteger bytesRead;
 @property(readonly) NSUInteger usedBytes __attribute__((deprecated("use -freeBytes")));
 @property           OERingBufferDiscardPolicy discardPolicy;
 
@@ -48,7 +95,42 @@ typedef NS_ENUM(NSUInteger, OERingBufferDiscardPolicy) {
  *  requested already in the buffer will be refused. */
 @property           BOOL anticipatesUnderflow;
 
+/** If set to YES, the producer grows the buffer by half after the consumer
+ *  starves, i.e. a read underruns or is refused, and shrinks it by at least a quarter
+ *  once the consumer hasn't starved for stablePeriod seconds, so the latency
+ *  settles at what the machine can sustain. Starvation while the producer is
+ *  stalled, e.g. paused, is ignored. The length stays between minimumLength
+ *  and maximumLength, which default to the initial length and four times it. */
+@property           BOOL adaptsLength;
+@property           NSUInteger minimumLength;
+@property           NSUInteger maximumLength;
+/** Defaults to 10 seconds. */
+@property           NSTimeInterval stablePeriod;
+
 - (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len;
 - (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length;
 
+/** Returns the current statistics. The rates cover the time since the
+ *  previous call, so only one thread, e.g. a monitor, should call this.
+ *  Counters are updated without locks, so the snapshot is not atomic as a
+ *  whole, but each counter is exact. */
+- (OERingBufferStatistics)statistics;
+- (void)resetStatistics;
+
+/** The producer side and the consumer side of the zero-copy API may each be
+ *  used by one thread at a time. With OERingBufferDiscardPolicyOldest,
+ *  reserving a write region never fails for lengths up to -length, and a
+ *  region reserved for reading may be overwritten while in use; -commitRead:
+ *  reports when that happened. Committing without a region reserved does
+ *  nothing, and commits at most the reserved length. */
+- (void *)reserveWriteRegion:(NSUInteger)length;
+- (void)commitWrite:(NSUInteger)length;
+- (const void *)reserveReadRegion:(NSUInteger *)length;
+- (BOOL)commitRead:(NSUInteger)length;
+
+/** Reads up to frameCount frames in the converter's source format and converts
+ *  them straight from the buffer's memory into buffers, in the converter's
+ *  destination format. Returns the number of frames read. */
+- (NSUInteger)readFrames:(NSUInteger)frameCount intoBuffers:(void *const *)buffers converter:(OEAudioConverter *)converter;
+
 @end
@@ -25,17 +25,122 @@
  */
 
 #import "OERingBuffer.h"
+#import "OERingBuffer_Internal.h"
+#import "OEAudioTimeStretcher_Internal.h"
 #import "TPCircularBuffer.h"
-#import <os/lock.h>
 #import <os/log.h>
+#import <unistd.h>
 #import "OELogging.h"
+#import "OETimingUtils.h"
+
+/*
+ * The buffer is a single producer, single consumer queue over the mirrored
+ * memory of a TPCircularBuffer. Its head, tail and fill count are not used;
+ * instead both sides keep monotonic byte positions, so no operation ever
+ * has to wait for the other side:
+ *
+ * - the consumer owns readPosition and only ever moves it forward;
+ * - the producer owns writePosition and the storage's reservePosition. With
+ *   the Oldest policy it never waits for room: it announces the end of the
+ *   bytes it is about to overwrite in reservePosition, copies, then
+ *   publishes them by advancing writePosition;
+ * - when the consumer finds that it has been lapped, it skips ahead to the
+ *   oldest byte still in the buffer. After copying, it checks reservePosition
+ *   to find bytes that were overwritten while it was copying, and drops them
+ *   instead of returning torn data.
+ *
+ * Positions don't depend on the length of the buffer, so the producer can
+ * resize it without stopping the consumer: it copies the unread bytes to
+ * a new storage at the same positions, marks the old storage as ending at
+ * writePosition, and swaps the storage pointer. A consumer still reading
+ * from the old storage reads up to its end, and picks up the new storage
+ * on its next read. The consumer increments readEpoch when it starts and
+ * when it stops using a storage, so the producer can tell when it is safe
+ * to free the old one.
+ */
+
+/// The memory of a ring buffer, which is replaced as a whole when the buffer is resized.
+typedef struct OERingBufferStorage {
+    TPCircularBuffer buffer;
+    // The position of the oldest byte copied from the storage this one replaced.
+    uint64_t startPosition;
+    _Atomic(uint64_t) reservePosition;
+    // The position at which the storage was replaced, or UINT64_MAX while it's current.
+    _Atomic(uint64_t) endPosition;
+    // Replaced storages the consumer may still be reading. Producer only.
+    struct OERingBufferStorage *next;
+    uint64_t retiredEpoch;
+} OERingBufferStorage;
+
+static OERingBufferStorage *OERingBufferStorageCreate(NSUInteger length)
+{
+    OERingBufferStorage *storage = calloc(1, sizeof(OERingBufferStorage));
+    if (storage == NULL)
+        return NULL;
+
+    if (!TPCircularBufferInit(&storage->buffer, (uint32_t)length)) {
+        free(storage);
+        return NULL;
+    }
+    atomic_init(&storage->endPosition, UINT64_MAX);
+    return storage;
+}
+
+static void OERingBufferStorageDestroy(OERingBufferStorage *storage)
+{
+    TPCircularBufferCleanup(&storage->buffer);
+    free(storage);
+}
+
+/// Starvation is ignored when the producer has not written for this long, e.g. while paused.
+static const NSTimeInterval OERingBufferProducerStallInterval = 0.25;
+/// The minimum time between two adaptive growths, to let the fill level settle.
+static const NSTimeInterval OERingBufferGrowthInterval = 1.0;
 
 @implementation OERingBuffer
 {
-    TPCircularBuffer buffer;
-    os_unfair_lock fifoLock;
-    atomic_uint bytesRead;
-    atomic_uint bytesWritten;
+    _Atomic(OERingBufferStorage *) storage;
+    // The length of the current storage, for threads which can't dereference it.
+    _Atomic(NSUInteger) capacity;
+    // Odd while the consumer uses a storage.
+    _Atomic(uint64_t) readEpoch;
+    // Newest first. Producer only.
+    OERingBufferStorage *retiredStorage;
+    _Atomic(uint64_t) readPosition;
+    _Atomic(uint64_t) writePosition;
+    // The region returned by -reserveReadRegion:. Consumer only.
+    OERingBufferStorage *reservedReadStorage;
+    uint64_t reservedReadPosition;
+    NSUInteger reservedReadLength;
+    // The region returned by -reserveWriteRegion:, NULL if there is none. Producer only.
+    void *reservedWriteRegion;
+    NSUInteger reservedWriteLength;
+    // Where reservations made while writes are discarded go. Producer only.
+    void *discardedWriteRegion;
+    NSUInteger discardedWriteRegionLength;
+    _Atomic(uint64_t) bytesRead;
+    _Atomic(uint64_t) bytesWritten;
+
+    // Statistics, always collected. Each counter is only incremented by one
+    // side, so relaxed atomics suffice.
+    _Atomic(uint64_t) writeCount;
+    _Atomic(uint64_t) overrunCount;
+    _Atomic(uint64_t) discardedBytes;
+    _Atomic(uint64_t) readCount;
+    _Atomic(uint64_t) underrunCount;
+    _Atomic(uint64_t) refusedReadCount;
+    _Atomic(uint64_t) tornBytes;
+    _Atomic(uint64_t) fillHistogram[OERingBufferFillHistogramBucketCount];
+    // Counters at the previous snapshot, for rates. Only used by -statistics.
+    uint64_t snapshotBytesWritten;
+    uint64_t snapshotBytesRead;
+    NSTimeInterval snapshotTime;
+
+    // State of the adaptive length policy. Producer only.
+    uint64_t adaptStarvedReadCount;
+    NSTimeInterval adaptWriteTime;
+    NSTimeInterval adaptGrowthTime;
+    NSTimeInterval adaptStableTime;
 #ifdef DEBUG
     BOOL suppressRepeatedLog;
 #endif
@@ -50,80 +155,325 @@
 {
     if((self = [super init]))
     {
-        TPCircularBufferInit(&buffer, (int)length);
-        fifoLock = OS_UNFAIR_LOCK_INIT;
+        OERingBufferStorage *initialStorage = OERingBufferStorageCreate(length);
+        if (initialStorage == NULL)
+            return nil;
+        atomic_init(&storage, initialStorage);
+        atomic_init(&capacity, initialStorage->buffer.length);
         _discardPolicy = OERingBufferDiscardPolicyNewest;
+        _minimumLength = initialStorage->buffer.length;
+        _maximumLength = initialStorage->buffer.length * 4;
+        _stablePeriod = 10;
+        snapshotTime = OEMonotonicTime();
+        adaptStableTime = snapshotTime;
     }
     return self;
 }
 
 - (void)dealloc
 {
-    TPCircularBufferCleanup(&buffer);
+    while (retiredStorage != NULL) {
+        OERingBufferStorage *next = retiredStorage->next;
+        OERingBufferStorageDestroy(retiredStorage);
+        retiredStorage = next;
+    }
+    OERingBufferStorageDestroy(atomic_load_explicit(&storage, memory_order_relaxed));
+    free(discardedWriteRegion);
 }
 
 - (NSUInteger)length
 {
-    return buffer.length;
+    return atomic_load_explicit(&capacity, memory_order_relaxed);
+}
+
+/// Frees the replaced storages the consumer is done with.
+static void OERingBufferReclaimStorage(OERingBuffer *buf)
+{
+    if (buf->retiredStorage == NULL)
+        return;
+
+    // A storage replaced while the consumer was using one is freed once the
+    // consumer has moved on; it picks up the current storage next time.
+    uint64_t epoch = atomic_load_explicit(&buf->readEpoch, memory_order_acquire);
+    OERingBufferStorage **link = &buf->retiredStorage;
+    while (*link != NULL) {
+        OERingBufferStorage *retired = *link;
+        if (retired->retiredEpoch == epoch) {
+            link = &retired->next;
+            continue;
+        }
+        *link = retired->next;
+        OERingBufferStorageDestroy(retired);
+    }
+}
+
+/// Replaces the storage with one of the given length, keeping the unread
+/// bytes which fit. Must be called by the producer, outside of a write.
+static BOOL OERingBufferResize(OERingBuffer *buf, NSUInteger length)
+{
+    OERingBufferStorage *oldStorage = atomic_load_explicit(&buf->storage, memory_order_relaxed);
+    OERingBufferStorage *newStorage = OERingBufferStorageCreate(length);
+    if (newStorage == NULL) {
+        os_log_error(OE_LOG_AUDIO_WRITE, "Could not resize ring buffer to %lu bytes", length);
+        return NO;
+    }
+
+    uint64_t oldCapacity = oldStorage->buffer.length;
+    uint64_t newCapacity = newStorage->buffer.length;
+    uint64_t writePos = atomic_load_explicit(&buf->writePosition, memory_order_relaxed);
+    uint64_t readPos = atomic_load_explicit(&buf->readPosition, memory_order_acquire);
+
+    // Bytes keep their positions. The consumer may read further meanwhile,
+    // but never before readPos, so everything it can still ask for is copied.
+    uint64_t unread = MIN(writePos - MAX(readPos, oldStorage->startPosition), oldCapacity);
+    uint64_t keep = MIN(unread, newCapacity);
+    uint64_t start = writePos - keep;
+    newStorage->startPosition = start;
+    memcpy(newStorage->buffer.buffer + start % newCapacity, oldStorage->buffer.buffer + start % oldCapacity, keep);
+
+    if (unread > keep) {
+        #ifdef DEBUG
+        os_log_error(OE_LOG_AUDIO_WRITE, "discarding %llu bytes which don't fit in the resized buffer", unread - keep);
+        #endif
+        atomic_fetch_add_explicit(&buf->discardedBytes, unread - keep, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&oldStorage->endPosition, writePos, memory_order_relaxed);
+    atomic_store(&buf->storage, newStorage);
+    atomic_store_explicit(&buf->capacity, newCapacity, memory_order_relaxed);
+
+    // If the consumer is not using a storage now, the next one it uses is the new one.
+    uint64_t epoch = atomic_load(&buf->readEpoch);
+    if (epoch % 2 == 0) {
+        OERingBufferStorageDestroy(oldStorage);
+    } else {
+        oldStorage->retiredEpoch = epoch;
+        oldStorage->next = buf->retiredStorage;
+        buf->retiredStorage = oldStorage;
+    }
+    return YES;
 }
 
 - (void)setLength:(NSUInteger)length
 {
-    TPCircularBufferCleanup(&buffer);
-    TPCircularBufferInit(&buffer, (int)length);
+    OERingBufferReclaimStorage(self);
+    OERingBufferResize(self, length);
+    adaptGrowthTime = adaptStableTime = OEMonotonicTime();
 }
 
-- (NSUInteger)write:(const void *)inBuffer maxLength:(NSUInteger)length
+/// Grows the buffer when the consumer starved since the previous write, and
+/// shrinks it when it has not for stablePeriod.
+static void OERingBufferAdaptLength(OERingBuffer *buf, NSUInteger writeLength)
 {
-    NSUInteger res;
+    NSTimeInterval now = OEMonotonicTime();
+    uint64_t starvedReadCount = atomic_load_explicit(&buf->underrunCount, memory_order_relaxed) + atomic_load_explicit(&buf->refusedReadCount, memory_order_relaxed);
+    BOOL starved = starvedReadCount > buf->adaptStarvedReadCount;
+    buf->adaptStarvedReadCount = starvedReadCount;
 
+    // Starving while nothing was written, or before anything was read,
+    // says nothing about the latency the consumer needs.
+    if (now - buf->adaptWriteTime > OERingBufferProducerStallInterval || atomic_load_explicit(&buf->bytesRead, memory_order_relaxed) == 0)
+        starved = NO;
+    buf->adaptWriteTime = now;
+
+    NSUInteger length = atomic_load_explicit(&buf->capacity, memory_order_relaxed);
+    if (starved) {
+        buf->adaptStableTime = now;
+        if (length < buf->_maximumLength && now - buf->adaptGrowthTime >= OERingBufferGrowthInterval) {
+            buf->adaptGrowthTime = now;
+            OERingBufferResize(buf, MIN(length * 3 / 2, buf->_maximumLength));
+        }
+        return;
+    }
+
+    if (length <= buf->_minimumLength || now - buf->adaptStableTime < buf->_stablePeriod)
+        return;
+
+    // Lengths are rounded up to whole pages, so shrink by at least one.
+    NSUInteger pageSize = getpagesize();
+    NSUInteger target = MAX(MIN(length * 3 / 4, length - pageSize), buf->_minimumLength);
+    if ((target + pageSize - 1) / pageSize * pageSize >= length)
+        return;
+
+    // Wait until the unread bytes and this write fit, so nothing is dropped.
+    uint64_t writePos = atomic_load_explicit(&buf->writePosition, memory_order_relaxed);
+    uint64_t readPos = atomic_load_explicit(&buf->readPosition, memory_order_relaxed);
+    if (MIN(writePos - readPos, length) + writeLength > target)
+        return;
+
+    buf->adaptStableTime = now;
+    OERingBufferResize(buf, target);
+}
+
+/// Called by the producer before each write, while it is safe to resize.
+static void OERingBufferPrepareWrite(OERingBuffer *buf, NSUInteger length)
+{
+    OERingBufferReclaimStorage(buf);
+    if (buf->_adaptsLength)
+        OERingBufferAdaptLength(buf, length);
+}
+
+/// Returns where the next length bytes are to be written, or NULL if they
+/// don't fit and the oldest bytes may not be overwritten.
+static void *OERingBufferReserve(OERingBuffer *buf, NSUInteger length, BOOL overwrites)
+{
+    OERingBufferStorage *storage = atomic_load_explicit(&buf->storage, memory_order_relaxed);
+    uint64_t capacity = storage->buffer.length;
+    atomic_fetch_add_explicit(&buf->writeCount, 1, memory_order_relaxed);
+    if (length > capacity) {
+        atomic_fetch_add_explicit(&buf->overrunCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&buf->discardedBytes, length, memory_order_relaxed);
+        return NULL;
+    }
+
+    uint64_t writePos = atomic_load_explicit(&buf->writePosition, memory_order_relaxed);
+    uint64_t readPos = atomic_load_explicit(&buf->readPosition, memory_order_acquire);
+    uint64_t used = MIN(writePos - readPos, capacity);
+
+    if (used + length > capacity) {
+        #ifdef DEBUG
+        os_log_error(OE_LOG_AUDIO_WRITE, "Tried to write %lu bytes, but only %llu bytes free (%llu used)", length, capacity - used, used);
+        #endif
+
+        atomic_fetch_add_explicit(&buf->overrunCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&buf->discardedBytes, overwrites ? used + length - capacity : length, memory_order_relaxed);
+        if (!overwrites)
+            return NULL;
+
+        // Announce the overwrite before touching the bytes, so that a
+        // consumer copying them at the same time can tell.
+        atomic_store_explicit(&storage->reservePosition, writePos + length, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+
+    return storage->buffer.buffer + writePos % capacity;
+}
+
+static void OERingBufferPublish(OERingBuffer *buf, NSUInteger length)
+{
+    uint64_t writePos = atomic_load_explicit(&buf->writePosition, memory_order_relaxed);
+    atomic_store_explicit(&buf->writePosition, writePos + length, memory_order_release);
+}
+
+- (NSUInteger)write:(const void *)inBuffer maxLength:(NSUInteger)length
+{
     atomic_fetch_add(&bytesWritten, length);
-    
-    res = TPCircularBufferProduceBytes(&buffer, inBuffer, (int)length);
-    if (!res) {
+
+    if (_discardsWrites)
+        return length;
+
+    OERingBufferPrepareWrite(self, length);
+
+    // The tap may release its owner, which removes the tap while it runs.
+    void (^writeTap)(const void *, NSUInteger) = _writeTap;
+    if (writeTap != nil)
+        writeTap(inBuffer, length);
+
+    NSUInteger bufferLength = self.length;
+    BOOL overwrites = _discardPolicy == OERingBufferDiscardPolicyOldest;
+    if (overwrites && length > bufferLength) {
+        NSUInteger discard = length - bufferLength;
         #ifdef DEBUG
-        NSUInteger freeBytes = self.freeBytes;
-        os_log_error(OE_LOG_AUDIO_WRITE, "Tried to write %lu bytes, but only %lu bytes free (%lu used)", length, freeBytes, self.availableBytes);
+        os_log_error(OE_LOG_AUDIO_WRITE, "discarding %lu bytes because buffer is too small (%lu bytes used)", discard, self.availableBytes);
         #endif
+        atomic_fetch_add_explicit(&discardedBytes, discard, memory_order_relaxed);
+        length = bufferLength;
+        inBuffer += discard;
     }
-    
-    if (!res && _discardPolicy == OERingBufferDiscardPolicyOldest) {
-        os_unfair_lock_lock(&fifoLock);
 
-        if (length > buffer.length) {
-            NSUInteger discard = length - buffer.length;
-            #ifdef DEBUG
-            os_log_error(OE_LOG_AUDIO_WRITE, "discarding %lu bytes because buffer is too small (%lu bytes used)", discard, self.availableBytes);
-            #endif
-            length = buffer.length;
-            inBuffer += discard;
+    void *region = OERingBufferReserve(self, length, overwrites);
+    if (region == NULL)
+        return 0;
+
+    memcpy(region, inBuffer, length);
+    OERingBufferPublish(self, length);
+
+    return length;
+}
+
+- (void *)reserveWriteRegion:(NSUInteger)length
+{
+    // Like -write:maxLength:, discarded writes never touch the buffer. They
+    // go to memory of their own, which only grows, so it is rarely allocated.
+    if (_discardsWrites) {
+        if (length > discardedWriteRegionLength) {
+            free(discardedWriteRegion);
+            discardedWriteRegion = malloc(length);
+            discardedWriteRegionLength = discardedWriteRegion != NULL ? length : 0;
         }
-        
-        NSInteger overflow = MAX(0, (buffer.fillCount + length) - buffer.length);
-        if (overflow > 0)
-            TPCircularBufferConsume(&buffer, (uint32_t)overflow);
-        res = TPCircularBufferProduceBytes(&buffer, inBuffer, (int)length);
-        
-        os_unfair_lock_unlock(&fifoLock);
+        reservedWriteRegion = discardedWriteRegion;
+    } else {
+        OERingBufferPrepareWrite(self, length);
+        reservedWriteRegion = OERingBufferReserve(self, length, _discardPolicy == OERingBufferDiscardPolicyOldest);
     }
 
-    return res;
+    // A refused write counts as written, as with -write:maxLength:.
+    if (reservedWriteRegion == NULL)
+        atomic_fetch_add(&bytesWritten, length);
+    reservedWriteLength = reservedWriteRegion != NULL ? length : 0;
+    return reservedWriteRegion;
+}
+
+- (void)commitWrite:(NSUInteger)length
+{
+    void *region = reservedWriteRegion;
+    if (region == NULL)
+        return;
+
+    length = MIN(length, reservedWriteLength);
+    reservedWriteRegion = NULL;
+    reservedWriteLength = 0;
+    atomic_fetch_add(&bytesWritten, length);
+
+    if (region == discardedWriteRegion)
+        return;
+
+    void (^writeTap)(const void *, NSUInteger) = _writeTap;
+    if (writeTap != nil)
+        writeTap(region, length);
+    OERingBufferPublish(self, length);
 }
 
-static NSUInteger readBuffer(OERingBuffer *buf, void *outBuffer, NSUInteger len)
+/// Returns the storage the consumer reads from until OERingBufferEndRead().
+static OERingBufferStorage *OERingBufferBeginRead(OERingBuffer *buf)
 {
-    uint32_t availableBytes = 0;
-    OERingBufferDiscardPolicy discardPolicy = buf->_discardPolicy;
-    if (discardPolicy == OERingBufferDiscardPolicyOldest)
-        os_unfair_lock_lock(&buf->fifoLock);
-    
-    void *head = TPCircularBufferTail(&buf->buffer, &availableBytes);
+    atomic_fetch_add(&buf->readEpoch, 1);
+    return atomic_load(&buf->storage);
+}
+
+static void OERingBufferEndRead(OERingBuffer *buf)
+{
+    atomic_fetch_add_explicit(&buf->readEpoch, 1, memory_order_release);
+}
+
+/// Returns the number of bytes which can be read from storage, up to len,
+/// and where they start, skipping what the producer has already overwritten.
+static uint64_t OERingBufferReadable(OERingBuffer *buf, OERingBufferStorage *storage, NSUInteger len, uint64_t *outReadPos)
+{
+    uint64_t capacity = storage->buffer.length;
+    uint64_t readPos = atomic_load_explicit(&buf->readPosition, memory_order_relaxed);
+    uint64_t writePos = atomic_load_explicit(&buf->writePosition, memory_order_acquire);
+
+    // Bytes written after a resize are only in the new storage.
+    writePos = MIN(writePos, atomic_load_explicit(&storage->endPosition, memory_order_relaxed));
+
+    // Catch up if the producer has lapped us.
+    if (writePos - readPos > capacity)
+        readPos = writePos - capacity;
+    readPos = MAX(readPos, storage->startPosition);
+
+    uint64_t availableBytes = writePos - readPos;
+
+    atomic_fetch_add_explicit(&buf->readCount, 1, memory_order_relaxed);
+    NSUInteger bucket = (NSUInteger)MIN(availableBytes * OERingBufferFillHistogramBucketCount / capacity, OERingBufferFillHistogramBucketCount - 1);
+    atomic_fetch_add_explicit(&buf->fillHistogram[bucket], 1, memory_order_relaxed);
 
     if (buf->_anticipatesUnderflow) {
         if (availableBytes < 2*len) {
+            atomic_fetch_add_explicit(&buf->refusedReadCount, 1, memory_order_relaxed);
             #ifdef DEBUG
             if (!buf->suppressRepeatedLog) {
-                os_log_info(OE_LOG_AUDIO_READ, "available bytes %d <= requested %lu bytes * 2; not returning any byte", availableBytes, len);
+                os_log_info(OE_LOG_AUDIO_READ, "available bytes %llu <= requested %lu bytes * 2; not returning any byte", availableBytes, len);
                 buf->suppressRepeatedLog = YES;
             }
             #endif
@@ -134,9 +484,10 @@ static NSUInteger readBuffer(OERingBuffer *buf, void *outBuffer, NSUInteger len)
             #endif
         }
     } else if (availableBytes < len) {
+        atomic_fetch_add_explicit(&buf->underrunCount, 1, memory_order_relaxed);
         #ifdef DEBUG
         if (!buf->suppressRepeatedLog) {
-            os_log_error(OE_LOG_AUDIO_READ, "tried to consume %lu bytes, but only %d available; will not be logged again until next underflow", len, availableBytes);
+            os_log_error(OE_LOG_AUDIO_READ, "tried to consume %lu bytes, but only %llu available; will not be logged again until next underflow", len, availableBytes);
             buf->suppressRepeatedLog = YES;
         }
         #endif
@@ -146,32 +497,179 @@ static NSUInteger readBuffer(OERingBuffer *buf, void *outBuffer, NSUInteger len)
         #endif
     }
 
-    availableBytes = MIN(availableBytes, (int)len);
-    memcpy(outBuffer, head, availableBytes);
-    TPCircularBufferConsume(&buf->buffer, availableBytes);
-    
-    if (discardPolicy == OERingBufferDiscardPolicyOldest)
-        os_unfair_lock_unlock(&buf->fifoLock);
+    *outReadPos = readPos;
+    return MIN(availableBytes, len);
+}
+
+/// Marks bytes up to readPos + length as read. Returns the number of bytes
+/// at readPos the producer started overwriting since they were made readable.
+static uint64_t OERingBufferConsume(OERingBuffer *buf, OERingBufferStorage *storage, uint64_t readPos, uint64_t length)
+{
+    uint64_t capacity = storage->buffer.length;
+
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t reservePos = atomic_load_explicit(&storage->reservePosition, memory_order_relaxed);
+    uint64_t overwritten = 0;
+    if (reservePos > readPos + capacity)
+        overwritten = MIN(reservePos - capacity - readPos, length);
+
+    atomic_store_explicit(&buf->readPosition, readPos + length, memory_order_release);
+    if (overwritten > 0)
+        atomic_fetch_add_explicit(&buf->tornBytes, overwritten, memory_order_relaxed);
+    return overwritten;
+}
+
+/// Moves the frames following the first dropCount converted frames to the start of buffers.
+static void OEAudioDropFrames(OEAudioConverter *converter, void *const *buffers, NSUInteger dropCount, NSUInteger keepCount)
+{
+    const OEAudioFormat *format = OEAudioConverterGetDestinationFormat(converter);
+    NSUInteger frameSize = OEAudioFormatBytesPerFrame(format);
+    NSUInteger bufferCount = format->planar ? format->channelCount : 1;
+    for (NSUInteger i = 0; i < bufferCount; i++)
+        memmove(buffers[i], buffers[i] + dropCount * frameSize, keepCount * frameSize);
+}
+
+/// Reads up to len bytes. With a converter, len is rounded down to whole
+/// frames, which are converted into buffers instead of being copied.
+static NSUInteger readBuffer(OERingBuffer *buf, void *const *buffers, NSUInteger len, OEAudioConverter *converter)
+{
+    NSUInteger frameSize = converter ? OEAudioFormatBytesPerFrame(OEAudioConverterGetSourceFormat(converter)) : 1;
+    OERingBufferStorage *storage = OERingBufferBeginRead(buf);
+    uint64_t readPos;
+    uint64_t availableBytes = OERingBufferReadable(buf, storage, len, &readPos);
+
+    availableBytes = availableBytes / frameSize * frameSize;
+    if (availableBytes == 0) {
+        OERingBufferEndRead(buf);
+        return 0;
+    }
+
+    const void *tail = storage->buffer.buffer + readPos % storage->buffer.length;
+    if (converter)
+        OEAudioConverterConvert(converter, &tail, buffers, availableBytes / frameSize);
+    else
+        memcpy(buffers[0], tail, availableBytes);
+
+    // Drop whatever the producer started overwriting while we were copying.
+    uint64_t overwritten = OERingBufferConsume(buf, storage, readPos, availableBytes);
+    OERingBufferEndRead(buf);
+
+    if (overwritten > 0) {
+        #ifdef DEBUG
+        os_log_error(OE_LOG_AUDIO_READ, "dropping %llu bytes overwritten while reading", overwritten);
+        #endif
+        overwritten = (overwritten + frameSize - 1) / frameSize * frameSize;
+        availableBytes -= overwritten;
+        if (converter)
+            OEAudioDropFrames(converter, buffers, overwritten / frameSize, availableBytes / frameSize);
+        else
+            memmove(buffers[0], buffers[0] + overwritten, availableBytes);
+    }
 
     atomic_fetch_add(&buf->bytesRead, availableBytes);
     return availableBytes;
 }
 
+/// Reads frames through the time stretcher in chunks, converting each one.
+static NSUInteger OERingBufferReadStretchedFrames(OERingBuffer *buf, NSUInteger frameCount, void *const *buffers, OEAudioConverter *converter)
+{
+    const OEAudioFormat *format = OEAudioConverterGetDestinationFormat(converter);
+    NSUInteger sourceFrameSize = OEAudioFormatBytesPerFrame(OEAudioConverterGetSourceFormat(converter));
+    NSUInteger destinationFrameSize = OEAudioFormatBytesPerFrame(format);
+    NSUInteger bufferCount = format->planar ? format->channelCount : 1;
+    uint8_t chunk[4096];
+    NSUInteger framesRead = 0;
+
+    while (framesRead < frameCount) {
+        NSUInteger chunkFrames = MIN(frameCount - framesRead, sizeof(chunk) / sourceFrameSize);
+        NSUInteger received = [buf->_timeStretcher read:chunk maxLength:chunkFrames * sourceFrameSize] / sourceFrameSize;
+        if (received == 0)
+            break;
+
+        void *destination[bufferCount];
+        for (NSUInteger i = 0; i < bufferCount; i++)
+            destination[i] = (uint8_t *)buffers[i] + framesRead * destinationFrameSize;
+        const void *chunkBuffer = chunk;
+        OEAudioConverterConvert(converter, &chunkBuffer, destination, received);
+
+        framesRead += received;
+        if (received < chunkFrames)
+            break;
+    }
+    return framesRead;
+}
+
+- (void)enableTimeStretchingWithChannelCount:(NSUInteger)channelCount sampleRate:(double)sampleRate
+{
+    // The buffer owns the stretcher, so it doesn't need to be retained.
+    __unsafe_unretained OERingBuffer *unretainedSelf = self;
+    _timeStretcher = [[OEAudioTimeStretcher alloc] initWithReadBlock:^NSUInteger(void *buffer, NSUInteger len) {
+        return readBuffer(unretainedSelf, &buffer, len, NULL);
+    } channelCount:channelCount sampleRate:sampleRate];
+}
+
 - (NSUInteger)read:(void *)outBuffer maxLength:(NSUInteger)len
 {
-    return readBuffer(self, outBuffer, len);
+    if (_timeStretcher != nil)
+        return [_timeStretcher read:outBuffer maxLength:len];
+    return readBuffer(self, &outBuffer, len, NULL);
+}
+
+- (NSUInteger)readFrames:(NSUInteger)frameCount intoBuffers:(void *const *)buffers converter:(OEAudioConverter *)converter
+{
+    if (_timeStretcher != nil && !_timeStretcher.passesThrough)
+        return OERingBufferReadStretchedFrames(self, frameCount, buffers, converter);
+
+    NSUInteger frameSize = OEAudioFormatBytesPerFrame(OEAudioConverterGetSourceFormat(converter));
+    return readBuffer(self, buffers, frameCount * frameSize, converter) / frameSize;
+}
+
+- (const void *)reserveReadRegion:(NSUInteger *)length
+{
+    OERingBufferStorage *readStorage = OERingBufferBeginRead(self);
+    uint64_t readPos;
+    uint64_t availableBytes = OERingBufferReadable(self, readStorage, *length, &readPos);
+    *length = availableBytes;
+    if (availableBytes == 0) {
+        OERingBufferEndRead(self);
+        return NULL;
+    }
+
+    // The storage stays in use until -commitRead:.
+    reservedReadStorage = readStorage;
+    reservedReadPosition = readPos;
+    reservedReadLength = (NSUInteger)availableBytes;
+    return readStorage->buffer.buffer + readPos % readStorage->buffer.length;
+}
+
+- (BOOL)commitRead:(NSUInteger)length
+{
+    if (reservedReadStorage == NULL)
+        return YES;
+
+    length = MIN(length, reservedReadLength);
+    uint64_t overwritten = OERingBufferConsume(self, reservedReadStorage, reservedReadPosition, length);
+    reservedReadStorage = NULL;
+    OERingBufferEndRead(self);
+    atomic_fetch_add(&bytesRead, length);
+    return overwritten == 0;
 }
 
 - (OEAudioBufferReadBlock)readBlock
 {
+    if (_timeStretcher != nil)
+        return [_timeStretcher readBlock];
+
     return ^(void *buffer, NSUInteger len){
-        return readBuffer(self, buffer, len);
+        return readBuffer(self, &buffer, len, NULL);
     };
 }
 
 - (NSUInteger)availableBytes
 {
-    return buffer.fillCount;
+    uint64_t readPos = atomic_load_explicit(&readPosition, memory_order_acquire);
+    uint64_t writePos = atomic_load_explicit(&writePosition, memory_order_acquire);
+    return MIN(writePos - readPos, self.length);
 }
 
 - (NSUInteger)bytesWritten
@@ -179,14 +677,66 @@ static NSUInteger readBuffer(OERingBuffer *buf, void *outBuffer, NSUInteger len)
     return atomic_load(&bytesWritten);
 }
 
+- (NSUInteger)bytesRead
+{
+    return atomic_load(&bytesRead);
+}
+
+- (OERingBufferStatistics)statistics
+{
+    OERingBufferStatistics statistics = {
+        .bytesWritten = atomic_load_explicit(&bytesWritten, memory_order_relaxed),
+        .bytesRead = atomic_load_explicit(&bytesRead, memory_order_relaxed),
+        .writeCount = atomic_load_explicit(&writeCount, memory_order_relaxed),
+        .overrunCount = atomic_load_explicit(&overrunCount, memory_order_relaxed),
+        .discardedBytes = atomic_load_explicit(&discardedBytes, memory_order_relaxed),
+        .readCount = atomic_load_explicit(&readCount, memory_order_relaxed),
+        .underrunCount = atomic_load_explicit(&underrunCount, memory_order_relaxed),
+        .refusedReadCount = atomic_load_explicit(&refusedReadCount, memory_order_relaxed),
+        .tornBytes = atomic_load_explicit(&tornBytes, memory_order_relaxed),
+        .availableBytes = self.availableBytes,
+        .length = self.length,
+    };
+    for (NSUInteger i = 0; i < OERingBufferFillHistogramBucketCount; i++)
+        statistics.fillHistogram[i] = atomic_load_explicit(&fillHistogram[i], memory_order_relaxed);
+
+    NSTimeInterval now = OEMonotonicTime();
+    statistics.interval = now - snapshotTime;
+    if (statistics.interval > 0) {
+        statistics.producerRate = (statistics.bytesWritten - snapshotBytesWritten) / statistics.interval;
+        statistics.consumerRate = (statistics.bytesRead - snapshotBytesRead) / statistics.interval;
+    }
+    snapshotBytesWritten = statistics.bytesWritten;
+    snapshotBytesRead = statistics.bytesRead;
+    snapshotTime = now;
+
+    return statistics;
+}
+
+- (void)resetStatistics
+{
+    atomic_store(&writeCount, 0);
+    atomic_store(&overrunCount, 0);
+    atomic_store(&discardedBytes, 0);
+    atomic_store(&readCount, 0);
+    atomic_store(&underrunCount, 0);
+    atomic_store(&refusedReadCount, 0);
+    atomic_store(&tornBytes, 0);
+    for (NSUInteger i = 0; i < OERingBufferFillHistogramBucketCount; i++)
+        atomic_store(&fillHistogram[i], 0);
+    snapshotBytesWritten = atomic_load(&bytesWritten);
+    snapshotBytesRead = atomic_load(&bytesRead);
+    snapshotTime = OEMonotonicTime();
+}
+
 - (NSUInteger)freeBytes
 {
-    return buffer.length - buffer.fillCount;
+    return self.length - self.availableBytes;
 }
 
 - (NSUInteger)usedBytes
 {
-    return buffer.length - buffer.fillCount;
+    return self.length - self.availableBytes;
 }
 
 @end
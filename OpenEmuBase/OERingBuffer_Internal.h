@@ -0,0 +1,50 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import "OERingBuffer.h"
+
+@class OEAudioTimeStretcher;
+
+@interface OERingBuffer ()
+
+/** If set to YES, writes are accepted but their contents are dropped.
+ *  Used by OEGameCore to decimate audio while fast-forwarding. */
+@property BOOL discardsWrites;
+
+/** Called with the bytes of every write which isn't discarded, before they
+ *  are published. Must be set on the producer thread. Used by
+ *  OECaptureWriter to record audio without consuming it. */
+@property (nonatomic, copy) void (^writeTap)(const void *bytes, NSUInteger length);
+
+/** Set by -enableTimeStretchingWithChannelCount:sampleRate:. Reads through
+ *  -read:maxLength:, -readBlock and -readFrames:intoBuffers:converter: then
+ *  return the output of the stretcher, which reads the buffer's contents.
+ *  The zero-copy read API bypasses it. */
+@property (readonly) OEAudioTimeStretcher *timeStretcher;
+
+/** Must be called before the buffer is read from. Used by OEGameCore to keep
+ *  the pitch of audio produced faster or slower than real time. */
+- (void)enableTimeStretchingWithChannelCount:(NSUInteger)channelCount sampleRate:(double)sampleRate;
+
+@end
@@ -0,0 +1,81 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OEGameCore;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @class OESaveStateWriter
+ * @abstract Saves and loads core states without holding up the core thread.
+ * @discussion
+ * Saving serializes the core with -[OEGameCore serializeStateWithError:]
+ * at the next frame boundary and copies the state into a pooled buffer,
+ * which is all the core waits for. Compression, writing a temporary file
+ * next to the destination, flushing it to storage and renaming it over
+ * the destination happen on a serial I/O queue, so the destination holds
+ * either the old state or the new one, even after a crash or power loss.
+ *
+ * Loading reads and decompresses the file on the I/O queue, after the
+ * saves queued before it, and deserializes it at a frame boundary.
+ *
+ * The default OEGameCore save state methods use the shared writer for
+ * cores which implement -serializeStateWithError:.
+ */
+@interface OESaveStateWriter : NSObject
+
+@property (class, readonly) OESaveStateWriter *sharedWriter;
+
+/// Whether saved states are compressed with LZFSE. Defaults to YES.
+/// Compressed and uncompressed files are loaded either way.
+@property (atomic) BOOL compressesStates;
+
+/*!
+ * @method saveStateOfGameCore:toURL:completionHandler:
+ * @abstract Serializes the core at the next frame boundary and writes the state to url in the background.
+ * @discussion May be called from any thread. The handler is called on the I/O queue.
+ */
+- (void)saveStateOfGameCore:(OEGameCore *)gameCore toURL:(NSURL *)url completionHandler:(nullable void(^)(BOOL success, NSError *_Nullable error))handler;
+
+/*!
+ * @method loadStateOfGameCore:fromURL:completionHandler:
+ * @abstract Reads the state at url in the background and deserializes it into the core at a frame boundary.
+ * @discussion May be called from any thread. The handler is called on the
+ * core thread after deserializing, or on the I/O queue if the file can't be read.
+ */
+- (void)loadStateOfGameCore:(OEGameCore *)gameCore fromURL:(NSURL *)url completionHandler:(nullable void(^)(BOOL success, NSError *_Nullable error))handler;
+
+/// Reads a state file, decompressing it if needed. Blocks the calling thread.
+/// Files without a valid compressed state header, or which don't decompress
+/// to the length it gives, are returned as they are, for the core to accept
+/// or reject. Only fails if the file can't be read.
++ (nullable NSData *)stateWithContentsOfURL:(NSURL *)url error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,321 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OESaveStateWriter.h"
+#import "OEGameCore.h"
+#import "OELogging.h"
+#import <compression.h>
+#import <fcntl.h>
+#import <os/lock.h>
+#import <os/signpost.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+#pragma mark - File Format
+
+// Compressed states start with this header, followed by the LZFSE stream:
+// the magic, a version byte, three flag bytes which are zero and the length
+// of the uncompressed state as a little-endian 64-bit integer at offset 8.
+// Anything else, including a state whose header doesn't check out or whose
+// stream doesn't decode to that length, is loaded as an uncompressed state,
+// since uncompressed states may start with the magic too.
+static const char OESaveStateMagic[4] = { 'O', 'E', 'S', 'S' };
+static const uint8_t OESaveStateVersion = 1;
+#define OE_SAVE_STATE_HEADER_LENGTH 16
+
+// Bounds on the length a header may claim, so that loading a damaged or
+// foreign file doesn't allocate an outsized buffer. States beyond them are
+// written uncompressed.
+static const uint64_t OESaveStateMaximumLength = 1ULL << 30;
+static const uint64_t OESaveStateMaximumCompressionRatio = 4096;
+
+// Buffers beyond this many are freed instead of pooled.
+static const NSUInteger OESaveStateBufferPoolCapacity = 2;
+
+static void OEWriteSaveStateHeader(uint8_t header[OE_SAVE_STATE_HEADER_LENGTH], uint64_t stateLength)
+{
+    memset(header, 0, OE_SAVE_STATE_HEADER_LENGTH);
+    memcpy(header, OESaveStateMagic, sizeof(OESaveStateMagic));
+    header[4] = OESaveStateVersion;
+    OSWriteLittleInt64(header, 8, stateLength);
+}
+
+/// Returns the uncompressed length given by a valid header, or 0.
+static uint64_t OEReadSaveStateHeader(const uint8_t *bytes, size_t length)
+{
+    if (length <= OE_SAVE_STATE_HEADER_LENGTH || memcmp(bytes, OESaveStateMagic, sizeof(OESaveStateMagic)) != 0)
+        return 0;
+    if (bytes[4] != OESaveStateVersion || bytes[5] != 0 || bytes[6] != 0 || bytes[7] != 0)
+        return 0;
+
+    uint64_t stateLength = OSReadLittleInt64(bytes, 8);
+    uint64_t compressedLength = length - OE_SAVE_STATE_HEADER_LENGTH;
+    if (stateLength > OESaveStateMaximumLength || stateLength > compressedLength * OESaveStateMaximumCompressionRatio)
+        return 0;
+    return stateLength;
+}
+
+static BOOL OEWriteAll(int fd, const void *bytes, size_t length)
+{
+    const uint8_t *p = bytes;
+    while (length > 0) {
+        ssize_t written = write(fd, p, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return NO;
+        }
+        p += written;
+        length -= written;
+    }
+    return YES;
+}
+
+/// Writes the header and bytes to a temporary file in the directory of url,
+/// flushes it to storage and renames it over url.
+static BOOL OEWriteFileAtomically(NSURL *url, const void *header, size_t headerLength, const void *bytes, size_t length, NSError **error)
+{
+    NSString *path = url.path;
+    NSString *directory = path.stringByDeletingLastPathComponent;
+    NSString *template = [directory stringByAppendingPathComponent:[NSString stringWithFormat:@".%@.XXXXXX", path.lastPathComponent]];
+    char *temporaryPath = strdup(template.fileSystemRepresentation);
+
+    int fd = mkstemp(temporaryPath);
+    // F_FULLFSYNC also flushes the drive's cache; not all file systems support it.
+    BOOL success = fd >= 0
+        && fchmod(fd, 0644) == 0
+        && OEWriteAll(fd, header, headerLength)
+        && OEWriteAll(fd, bytes, length)
+        && (fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0);
+    int savedErrno = errno;
+
+    if (fd >= 0 && close(fd) != 0 && success) {
+        success = NO;
+        savedErrno = errno;
+    }
+    if (success && rename(temporaryPath, path.fileSystemRepresentation) != 0) {
+        success = NO;
+        savedErrno = errno;
+    }
+    if (!success && fd >= 0)
+        unlink(temporaryPath);
+    free(temporaryPath);
+
+    if (!success) {
+        if (error != NULL)
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:savedErrno userInfo:@{ NSURLErrorKey : url }];
+        return NO;
+    }
+
+    // Make the rename itself durable.
+    int directoryFD = open(directory.fileSystemRepresentation, O_RDONLY);
+    if (directoryFD >= 0) {
+        fsync(directoryFD);
+        close(directoryFD);
+    }
+    return YES;
+}
+
+#pragma mark -
+
+@implementation OESaveStateWriter
+{
+    dispatch_queue_t _ioQueue;
+
+    // Copies of serialized states waiting to be written.
+    NSMutableArray<NSMutableData *> *_stateBuffers;
+    os_unfair_lock _stateBuffersLock;
+
+    // I/O queue only.
+    NSMutableData *_compressedBuffer;
+    void *_scratchBuffer;
+}
+
++ (OESaveStateWriter *)sharedWriter
+{
+    static OESaveStateWriter *sharedWriter;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedWriter = [[OESaveStateWriter alloc] init];
+    });
+    return sharedWriter;
+}
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        _compressesStates = YES;
+        _ioQueue = dispatch_queue_create("org.openemu.save-state-writer", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+        _stateBuffers = [NSMutableArray array];
+        _stateBuffersLock = OS_UNFAIR_LOCK_INIT;
+        _compressedBuffer = [NSMutableData data];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_scratchBuffer);
+}
+
+#pragma mark - Buffer Pool
+
+- (NSMutableData *)OE_dequeueStateBufferWithLength:(NSUInteger)length
+{
+    os_unfair_lock_lock(&_stateBuffersLock);
+    NSMutableData *buffer = _stateBuffers.lastObject;
+    if (buffer != nil)
+        [_stateBuffers removeLastObject];
+    os_unfair_lock_unlock(&_stateBuffersLock);
+
+    if (buffer == nil)
+        return [NSMutableData dataWithLength:length];
+    buffer.length = length;
+    return buffer;
+}
+
+- (void)OE_enqueueStateBuffer:(NSMutableData *)buffer
+{
+    os_unfair_lock_lock(&_stateBuffersLock);
+    if (_stateBuffers.count < OESaveStateBufferPoolCapacity)
+        [_stateBuffers addObject:buffer];
+    os_unfair_lock_unlock(&_stateBuffersLock);
+}
+
+#pragma mark - Saving
+
+- (void)saveStateOfGameCore:(OEGameCore *)gameCore toURL:(NSURL *)url completionHandler:(void(^)(BOOL success, NSError *error))handler
+{
+    handler = [handler copy];
+    url = [url copy];
+    [gameCore performBlock:^{
+        os_signpost_interval_begin(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
+        NSError *error;
+        NSData *state = [gameCore serializeStateWithError:&error];
+        os_signpost_interval_end(OE_LOG_CORE_RUN, OS_SIGNPOST_ID_EXCLUSIVE, "serializeState");
+        if (state == nil) {
+            if (error == nil)
+                error = [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreCouldNotSaveStateError userInfo:nil];
+            dispatch_async(self->_ioQueue, ^{
+                if (handler != nil)
+                    handler(NO, error);
+            });
+            return;
+        }
+
+        // Cores may return data backed by memory they keep changing.
+        NSMutableData *buffer = [self OE_dequeueStateBufferWithLength:state.length];
+        memcpy(buffer.mutableBytes, state.bytes, state.length);
+        BOOL compresses = self.compressesStates;
+
+        dispatch_async(self->_ioQueue, ^{
+            NSError *error;
+            BOOL success = [self OE_writeState:buffer toURL:url compressed:compresses error:&error];
+            [self OE_enqueueStateBuffer:buffer];
+            if (!success)
+                os_log_error(OE_LOG_DEFAULT, "Could not write save state to %{public}@: %{public}@", url.path, error);
+            if (handler != nil)
+                handler(success, error);
+        });
+    }];
+}
+
+- (BOOL)OE_writeState:(NSData *)state toURL:(NSURL *)url compressed:(BOOL)compressed error:(NSError **)error
+{
+    if (!compressed || state.length == 0 || state.length > OESaveStateMaximumLength)
+        return OEWriteFileAtomically(url, NULL, 0, state.bytes, state.length, error);
+
+    if (_scratchBuffer == NULL)
+        _scratchBuffer = malloc(compression_encode_scratch_buffer_size(COMPRESSION_LZFSE));
+
+    // States which don't shrink, or shrink more than loading accepts, are
+    // written uncompressed.
+    _compressedBuffer.length = state.length;
+    size_t compressedLength = compression_encode_buffer(_compressedBuffer.mutableBytes, _compressedBuffer.length,
+                                                        state.bytes, state.length,
+                                                        _scratchBuffer, COMPRESSION_LZFSE);
+    if (compressedLength == 0 || state.length > compressedLength * OESaveStateMaximumCompressionRatio)
+        return OEWriteFileAtomically(url, NULL, 0, state.bytes, state.length, error);
+
+    uint8_t header[OE_SAVE_STATE_HEADER_LENGTH];
+    OEWriteSaveStateHeader(header, state.length);
+    return OEWriteFileAtomically(url, header, sizeof(header), _compressedBuffer.bytes, compressedLength, error);
+}
+
+#pragma mark - Loading
+
+- (void)loadStateOfGameCore:(OEGameCore *)gameCore fromURL:(NSURL *)url completionHandler:(void(^)(BOOL success, NSError *error))handler
+{
+    handler = [handler copy];
+    url = [url copy];
+    // Goes through the core thread first, so saves queued before are written first.
+    [gameCore performBlock:^{
+        dispatch_async(self->_ioQueue, ^{
+            NSError *error;
+            NSData *state = [OESaveStateWriter stateWithContentsOfURL:url error:&error];
+            if (state == nil) {
+                if (handler != nil)
+                    handler(NO, error);
+                return;
+            }
+
+            [gameCore performBlock:^{
+                NSError *error;
+                BOOL success = [gameCore deserializeState:state withError:&error];
+                if (!success && error == nil)
+                    error = [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreCouldNotLoadStateError userInfo:nil];
+                if (handler != nil)
+                    handler(success, error);
+            }];
+        });
+    }];
+}
+
++ (NSData *)stateWithContentsOfURL:(NSURL *)url error:(NSError **)error
+{
+    NSData *file = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:error];
+    if (file == nil)
+        return nil;
+
+    uint64_t stateLength = OEReadSaveStateHeader(file.bytes, file.length);
+    if (stateLength == 0)
+        return file;
+
+    // One byte more than the header claims tells streams which decode to
+    // more apart from those which decode to just as much.
+    NSMutableData *state = [NSMutableData dataWithLength:(NSUInteger)stateLength + 1];
+    if (state == nil
+        || compression_decode_buffer(state.mutableBytes, state.length,
+                                     (const uint8_t *)file.bytes + OE_SAVE_STATE_HEADER_LENGTH, file.length - OE_SAVE_STATE_HEADER_LENGTH,
+                                     NULL, COMPRESSION_LZFSE) != stateLength) {
+        os_log_error(OE_LOG_DEFAULT, "Save state %{public}@ doesn't decode to the length in its header, loading it uncompressed", url.path);
+        return file;
+    }
+    state.length = (NSUInteger)stateLength;
+    return state;
+}
+
+@end
@@ -25,6 +25,7 @@
  */
 
 #import <Foundation/Foundation.h>
+#import <OpenEmuBase/OECommandQueue.h>
 
 @protocol OESystemResponderClient <NSObject>
 
@@ -40,4 +41,10 @@
 - (void)stepFrameForward;
 - (void)stepFrameBackward;
 
+@optional
+
+/// Queues a command for the core thread without blocking or allocating.
+/// @returns NO if the command could not be queued.
+- (BOOL)pushCommand:(const OECommand *)command;
+
 @end
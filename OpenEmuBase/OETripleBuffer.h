@@ -0,0 +1,122 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <OpenEmuBase/OEGeometry.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ * @struct OETripleBufferFrame
+ * @abstract A frame acquired by the reader of an OETripleBuffer, or last published by the writer.
+ * @field bytes The pixels. Stay valid until the reader acquires another frame, or the writer publishes another one.
+ * @field frameNumber Counts published frames from 1. 0 until a frame is published, when the bytes are zero.
+ * @field screenRect The screenRect of the core when the frame was published.
+ * @field aspectSize The aspectSize of the core when the frame was published.
+ * @field dirtyRect The part of screenRect which differs from frame frameNumber - 1.
+ * Only useful if the reader acquired that frame; otherwise all of screenRect may differ.
+ */
+typedef struct OETripleBufferFrame {
+    const void *bytes;
+    uint64_t frameNumber;
+    OEIntRect screenRect;
+    OEIntSize aspectSize;
+    OEIntRect dirtyRect;
+} OETripleBufferFrame;
+
+/*!
+ * @class OETripleBuffer
+ * @abstract Hands finished video frames from a core to a presenter without locks.
+ * @discussion
+ * Owns three buffers of the same length. The writer, the core thread,
+ * draws into one and publishes it by atomically swapping it with the
+ * middle buffer. The reader, e.g. the presenter, atomically swaps its
+ * buffer with the middle one when that holds a newer frame. Each side
+ * owns its buffer until it swaps again, so frames never tear and neither
+ * side waits for the other: the core keeps its own pace, and frames which
+ * are published faster than they are read are overwritten.
+ *
+ * There must be one writer and one reader at a time. A screenshotter
+ * running alongside a presenter should copy the frame the presenter has
+ * acquired, or acquire frames itself while the presenter doesn't.
+ *
+ * Assign a buffer to OEGameCore.videoTripleBuffer to have the core draw
+ * into it and publish every displayed frame.
+ */
+@interface OETripleBuffer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Allocates three zeroed buffers of length bytes.
+- (instancetype)initWithLength:(NSUInteger)length NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) NSUInteger length;
+
+#pragma mark - Writer
+
+/// The buffer to draw the next frame into. Changes when it is published.
+@property (readonly) void *writeBuffer;
+
+/*!
+ * @method publishWriteBufferWithScreenRect:aspectSize:
+ * @abstract Makes the write buffer the latest frame, and takes the oldest free buffer to write into.
+ * @discussion The new write buffer holds an older frame; draw every pixel of the next one.
+ * The whole screenRect is dirty.
+ */
+- (void)publishWriteBufferWithScreenRect:(OEIntRect)screenRect aspectSize:(OEIntSize)aspectSize;
+
+/// Like -publishWriteBufferWithScreenRect:aspectSize:, for a frame which only differs from the previous one in dirtyRect.
+- (void)publishWriteBufferWithScreenRect:(OEIntRect)screenRect aspectSize:(OEIntSize)aspectSize dirtyRect:(OEIntRect)dirtyRect;
+
+/*!
+ * @property publishedFrame
+ * @abstract The frame the writer published last.
+ * @discussion For the writer only, e.g. to take a screenshot between frames.
+ * The reader may be reading the same bytes, but nobody writes them until
+ * the writer publishes again.
+ */
+@property (readonly) OETripleBufferFrame publishedFrame;
+
+#pragma mark - Reader
+
+/*!
+ * @method acquireLatestFrame
+ * @abstract Returns the latest published frame.
+ * @discussion Returns the previously acquired frame again if no newer one
+ * was published; compare frameNumber to tell. Never blocks.
+ */
+- (OETripleBufferFrame)acquireLatestFrame;
+
+#pragma mark - Statistics
+
+/// The number of frames published so far.
+@property (readonly) uint64_t publishedFrameCount;
+/// The number of published frames which were overwritten before the reader acquired them.
+@property (readonly) uint64_t overwrittenFrameCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2026, OpenEmu Team
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+     * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+     * Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+     * Neither the name of the OpenEmu Team nor the
+       names of its contributors may be used to endorse or promote products
+       derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+ EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "OETripleBuffer.h"
+#import <stdatomic.h>
+
+// The middle buffer holds a frame the reader hasn't acquired.
+#define OE_TRIPLE_BUFFER_FRESH 4u
+#define OE_TRIPLE_BUFFER_INDEX 3u
+
+typedef struct {
+    void *bytes;
+    uint64_t frameNumber;
+    OEIntRect screenRect;
+    OEIntSize aspectSize;
+    OEIntRect dirtyRect;
+} OETripleBufferSlot;
+
+static inline OETripleBufferFrame OETripleBufferFrameFromSlot(const OETripleBufferSlot *slot)
+{
+    return (OETripleBufferFrame){ slot->bytes, slot->frameNumber, slot->screenRect, slot->aspectSize, slot->dirtyRect };
+}
+
+@implementation OETripleBuffer
+{
+    OETripleBufferSlot _slots[3];
+    // The index of the middle buffer, ORed with OE_TRIPLE_BUFFER_FRESH.
+    _Atomic(uint32_t) _middle;
+    // Writer only.
+    uint32_t _writeIndex;
+    uint32_t _publishedIndex;
+    // Reader only.
+    uint32_t _readIndex;
+    _Atomic(uint64_t) _publishedFrameCount;
+    _Atomic(uint64_t) _overwrittenFrameCount;
+}
+
+- (instancetype)initWithLength:(NSUInteger)length
+{
+    if ((self = [super init])) {
+        _length = length;
+        for (int i = 0; i < 3; i++) {
+            _slots[i].bytes = calloc(MAX(length, 1), 1);
+            if (_slots[i].bytes == NULL)
+                return nil;
+        }
+        _writeIndex = 0;
+        _publishedIndex = 1;
+        atomic_init(&_middle, 1);
+        _readIndex = 2;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (int i = 0; i < 3; i++)
+        free(_slots[i].bytes);
+}
+
+#pragma mark - Writer
+
+- (void *)writeBuffer
+{
+    return _slots[_writeIndex].bytes;
+}
+
+- (void)publishWriteBufferWithScreenRect:(OEIntRect)screenRect aspectSize:(OEIntSize)aspectSize
+{
+    [self publishWriteBufferWithScreenRect:screenRect aspectSize:aspectSize dirtyRect:screenRect];
+}
+
+- (void)publishWriteBufferWithScreenRect:(OEIntRect)screenRect aspectSize:(OEIntSize)aspectSize dirtyRect:(OEIntRect)dirtyRect
+{
+    OETripleBufferSlot *slot = &_slots[_writeIndex];
+    slot->frameNumber = atomic_load_explicit(&_publishedFrameCount, memory_order_relaxed) + 1;
+    slot->screenRect = screenRect;
+    slot->aspectSize = aspectSize;
+    slot->dirtyRect = dirtyRect;
+    atomic_store_explicit(&_publishedFrameCount, slot->frameNumber, memory_order_relaxed);
+
+    // Release the frame to the reader, and acquire whatever it left behind.
+    uint32_t previous = atomic_exchange_explicit(&_middle, _writeIndex | OE_TRIPLE_BUFFER_FRESH, memory_order_acq_rel);
+    if (previous & OE_TRIPLE_BUFFER_FRESH)
+        atomic_fetch_add_explicit(&_overwrittenFrameCount, 1, memory_order_relaxed);
+    _publishedIndex = _writeIndex;
+    _writeIndex = previous & OE_TRIPLE_BUFFER_INDEX;
+}
+
+- (OETripleBufferFrame)publishedFrame
+{
+    return OETripleBufferFrameFromSlot(&_slots[_publishedIndex]);
+}
+
+#pragma mark - Reader
+
+- (OETripleBufferFrame)acquireLatestFrame
+{
+    if (atomic_load_explicit(&_middle, memory_order_relaxed) & OE_TRIPLE_BUFFER_FRESH) {
+        uint32_t previous = atomic_exchange_explicit(&_middle, _readIndex, memory_order_acq_rel);
+        _readIndex = previous & OE_TRIPLE_BUFFER_INDEX;
+    }
+
+    return OETripleBufferFrameFromSlot(&_slots[_readIndex]);
+}
+
+#pragma mark - Statistics
+
+- (uint64_t)publishedFrameCount
+{
+    return atomic_load_explicit(&_publishedFrameCount, memory_order_relaxed);
+}
+
+- (uint64_t)overwrittenFrameCount
+{
+    return atomic_load_explicit(&_overwrittenFrameCount, memory_order_relaxed);
+}
+
+@end
@@ -35,12 +35,26 @@
 
 #import <OpenEmuBase/NSDictionary+OpenEmuSDK.h>
 #import <OpenEmuBase/OEAbstractAdditions.h>
+#import <OpenEmuBase/OECommandQueue.h>
 #import <OpenEmuBase/OEGameCore.h>
 #import <OpenEmuBase/OEGameCoreController.h>
+#import <OpenEmuBase/OEGameCoreScheduler.h>
+#import <OpenEmuBase/OEGameCoreWatchdog.h>
+#import <OpenEmuBase/OEInputMovie.h>
+#import <OpenEmuBase/OECaptureWriter.h>
+#import <OpenEmuBase/OETripleBuffer.h>
+#import <OpenEmuBase/OEFrameChangeDetector.h>
+#import <OpenEmuBase/OESaveStateWriter.h>
 #import <OpenEmuBase/OERingBuffer.h>
 #import <OpenEmuBase/OESystemResponderClient.h>
 #import <OpenEmuBase/OETimingUtils.h>
 #import <OpenEmuBase/TPCircularBuffer.h>
 #import <OpenEmuBase/OEAudioBuffer.h>
+#import <OpenEmuBase/OEAudioConversion.h>
+#import <OpenEmuBase/OEPixelConversion.h>
+#import <OpenEmuBase/OEPixelScaler.h>
+#import <OpenEmuBase/OEAudioMixer.h>
+#import <OpenEmuBase/OEAudioResampler.h>
+#import <OpenEmuBase/OEAudioTimeStretcher.h>
 #import <OpenEmuBase/NSUserDefaults+OpenEmuSDK.h>
 #import <OpenEmuBase/OEGameCoreDisplayModes.h>
@@ -27,11 +27,18 @@
 //  3. This notice may not be removed or altered from any source distribution.
 //
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // MAP_ANONYMOUS and syscall() in strict standard modes
+#endif
+
 #include "TPCircularBuffer.h"
-#include <mach/mach.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(__APPLE__)
+
+#include <mach/mach.h>
+
 #define reportResult(result,operation) (_reportResult((result),(operation),strrchr(__FILE__, '/')+1,__LINE__))
 static inline bool _reportResult(kern_return_t result, const char *operation, const char* file, int line) {
     if ( result != ERR_SUCCESS ) {
@@ -137,6 +144,102 @@ void TPCircularBufferCleanup(TPCircularBuffer *buffer) {
     memset(buffer, 0, sizeof(TPCircularBuffer));
 }
 
+#else // POSIX
+
+// The mirror is made of two shared mappings of the same file, placed back to
+// back inside an address range reserved beforehand. On Linux the file is an
+// anonymous memfd; elsewhere, or on kernels without memfd_create, it is a
+// POSIX shared memory object which is unlinked right away.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static int _TPCircularBufferCreateFile(size_t length) {
+    int fd = -1;
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+    // Called through syscall() so this builds against C libraries older than glibc 2.27.
+    fd = (int)syscall(SYS_memfd_create, "TPCircularBuffer", 1U /* MFD_CLOEXEC */);
+#endif
+
+    if ( fd < 0 ) {
+        static atomicInt counter;
+        for ( int attempt = 0; fd < 0 && attempt < 16; attempt++ ) {
+            char name[64];
+            snprintf(name, sizeof(name), "/TPCircularBuffer-%ld-%d", (long)getpid(), atomicFetchAdd(&counter, 1));
+            fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+            if ( fd >= 0 ) shm_unlink(name);
+            else if ( errno != EEXIST ) break;
+        }
+        if ( fd < 0 ) {
+            perror("TPCircularBuffer: shm_open");
+            return -1;
+        }
+    }
+
+    if ( ftruncate(fd, (off_t)length) != 0 ) {
+        perror("TPCircularBuffer: ftruncate");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool _TPCircularBufferInit(TPCircularBuffer *buffer, uint32_t length, size_t structSize) {
+
+    assert(length > 0);
+
+    if ( structSize != sizeof(TPCircularBuffer) ) {
+        fprintf(stderr, "TPCircularBuffer: Header version mismatch. Check for old versions of TPCircularBuffer in your project\n");
+        abort();
+    }
+
+    // We need whole page sizes
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = ((size_t)length + pageSize - 1) & ~(pageSize - 1);
+
+    int fd = _TPCircularBufferCreateFile(size);
+    if ( fd < 0 ) return false;
+
+    // Reserve twice the length, then map the file over both halves. Since the
+    // range is ours, MAP_FIXED can't race with other allocations.
+    char *address = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ( address == MAP_FAILED ) {
+        perror("TPCircularBuffer: reserving address space");
+        close(fd);
+        return false;
+    }
+
+    if ( mmap(address, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+      || mmap(address + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ) {
+        perror("TPCircularBuffer: mapping buffer memory");
+        munmap(address, size * 2);
+        close(fd);
+        return false;
+    }
+
+    // The mappings keep the memory alive.
+    close(fd);
+
+    buffer->length = (uint32_t)size;
+    buffer->buffer = address;
+    buffer->fillCount = 0;
+    buffer->head = buffer->tail = 0;
+    buffer->atomic = true;
+
+    return true;
+}
+
+void TPCircularBufferCleanup(TPCircularBuffer *buffer) {
+    if ( buffer->buffer ) munmap(buffer->buffer, (size_t)buffer->length * 2);
+    memset(buffer, 0, sizeof(TPCircularBuffer));
+}
+
+#endif
+
 void TPCircularBufferClear(TPCircularBuffer *buffer) {
     uint32_t fillCount;
     if ( TPCircularBufferTail(buffer, &fillCount) ) {
@@ -43,6 +43,7 @@
 #define TPCircularBuffer_h
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 
@@ -58,6 +59,10 @@
     #define atomicFetchAdd(a,b) atomic_fetch_add(a,b)
 #endif
 
+#ifndef __deprecated_msg
+#define __deprecated_msg(_msg) __attribute__((deprecated(_msg)))
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,214 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEAudioConversion.h"
+#import "OERingBuffer.h"
+
+
+@interface OEAudioConversionTests : XCTestCase
+
+@end
+
+
+#define OE_TEST_FRAME_COUNT 1001
+
+static const OEAudioFormat OEInt16Stereo   = { OEAudioSampleTypeInt16, 2, false };
+static const OEAudioFormat OEInt16Mono     = { OEAudioSampleTypeInt16, 1, false };
+static const OEAudioFormat OEInt24Stereo   = { OEAudioSampleTypeInt24, 2, false };
+static const OEAudioFormat OEInt32Stereo   = { OEAudioSampleTypeInt32, 2, false };
+static const OEAudioFormat OEFloatStereo   = { OEAudioSampleTypeFloat32, 2, false };
+static const OEAudioFormat OEFloatPlanar   = { OEAudioSampleTypeFloat32, 2, true };
+
+static void OEConvert(const OEAudioFormat *from, const OEAudioFormat *to, float gain, const void *const *source, void *const *destination, size_t frameCount)
+{
+    OEAudioConverter *converter = OEAudioConverterCreate(from, to);
+    OEAudioConverterSetGain(converter, gain);
+    OEAudioConverterConvert(converter, source, destination, frameCount);
+    OEAudioConverterDestroy(converter);
+}
+
+
+@implementation OEAudioConversionTests
+{
+    int16_t samples[OE_TEST_FRAME_COUNT * 2];
+}
+
+- (void)setUp
+{
+    // An odd frame count and a spread of values, to hit every kernel's tail.
+    for (int i=0; i<OE_TEST_FRAME_COUNT * 2; i++)
+        samples[i] = (int16_t)((i * 7919) % 65536 - 32768);
+}
+
+- (void)testRoundTrips
+{
+    const OEAudioFormat *formats[] = { &OEInt24Stereo, &OEInt32Stereo, &OEFloatStereo, &OEFloatPlanar };
+    const void *source[] = { samples };
+
+    for (int f=0; f<4; f++) {
+        const OEAudioFormat *format = formats[f];
+        NSMutableData *left = [NSMutableData dataWithLength:OE_TEST_FRAME_COUNT * 2 * 4], *right = [NSMutableData dataWithLength:OE_TEST_FRAME_COUNT * 4];
+        void *intermediate[] = { left.mutableBytes, right.mutableBytes };
+        int16_t result[OE_TEST_FRAME_COUNT * 2] = { 0 };
+        void *destination[] = { result };
+
+        OEConvert(&OEInt16Stereo, format, 1, source, intermediate, OE_TEST_FRAME_COUNT);
+        OEConvert(format, &OEInt16Stereo, 1, (const void *const *)intermediate, destination, OE_TEST_FRAME_COUNT);
+        XCTAssertEqual(memcmp(samples, result, sizeof(result)), 0, @"int16 round trip through sample type %u, planar %d", format->sampleType, format->planar);
+    }
+}
+
+- (void)testSampleEncoding
+{
+    const void *source[] = { samples };
+    uint8_t int24[OE_TEST_FRAME_COUNT * 6];
+    int32_t int32[OE_TEST_FRAME_COUNT * 2];
+    float left[OE_TEST_FRAME_COUNT], right[OE_TEST_FRAME_COUNT];
+
+    OEConvert(&OEInt16Stereo, &OEInt24Stereo, 1, source, (void *[]){ int24 }, OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(int24[0], 0);
+    XCTAssertEqual(int24[1], (uint8_t)samples[0]);
+    XCTAssertEqual(int24[2], (uint8_t)(samples[0] >> 8));
+
+    OEConvert(&OEInt16Stereo, &OEInt32Stereo, 1, source, (void *[]){ int32 }, OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(int32[3], samples[3] * 65536);
+
+    OEConvert(&OEInt16Stereo, &OEFloatPlanar, 1, source, (void *[]){ left, right }, OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(left[5], samples[10] / 32768.0f);
+    XCTAssertEqual(right[1000], samples[2001] / 32768.0f);
+
+    // Full scale and rounding to the nearest integer.
+    float values[] = { 1.0f, -1.0f, 0.4f / 32768, 0.6f / 32768, -0.6f / 32768, 100.0f };
+    int16_t rounded[6];
+    OEConvert(&(OEAudioFormat){ OEAudioSampleTypeFloat32, 1, false }, &OEInt16Mono, 1, (const void *[]){ values }, (void *[]){ rounded }, 6);
+    XCTAssertEqual(rounded[0], 32767);
+    XCTAssertEqual(rounded[1], -32768);
+    XCTAssertEqual(rounded[2], 0);
+    XCTAssertEqual(rounded[3], 1);
+    XCTAssertEqual(rounded[4], -1);
+    XCTAssertEqual(rounded[5], 32767);
+}
+
+- (void)testGainClips
+{
+    int16_t result[OE_TEST_FRAME_COUNT * 2];
+    float floats[OE_TEST_FRAME_COUNT * 2];
+    OEConvert(&OEInt16Stereo, &OEInt16Stereo, 4, (const void *[]){ samples }, (void *[]){ result }, OE_TEST_FRAME_COUNT);
+    OEConvert(&OEInt16Stereo, &OEFloatStereo, 4, (const void *[]){ samples }, (void *[]){ floats }, OE_TEST_FRAME_COUNT);
+
+    for (int i=0; i<OE_TEST_FRAME_COUNT * 2; i++) {
+        XCTAssertEqual(result[i], MAX(-32768, MIN(samples[i] * 4, 32767)));
+        XCTAssertEqualWithAccuracy(floats[i], MAX(-1.0f, MIN(samples[i] / 8192.0f, 1.0f)), 1e-6);
+    }
+}
+
+- (void)testChannelRouting
+{
+    // Downmixing averages the channels.
+    int16_t mono[OE_TEST_FRAME_COUNT];
+    OEConvert(&OEInt16Stereo, &OEInt16Mono, 1, (const void *[]){ samples }, (void *[]){ mono }, OE_TEST_FRAME_COUNT);
+    for (int i=0; i<OE_TEST_FRAME_COUNT; i++)
+        XCTAssertEqualWithAccuracy(mono[i], (samples[2 * i] + samples[2 * i + 1]) / 2.0, 1);
+
+    // Mono is copied to both channels.
+    float left[OE_TEST_FRAME_COUNT], right[OE_TEST_FRAME_COUNT];
+    OEConvert(&OEInt16Mono, &OEFloatPlanar, 1, (const void *[]){ mono }, (void *[]){ left, right }, OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(memcmp(left, right, sizeof(left)), 0);
+    XCTAssertEqual(left[9], mono[9] / 32768.0f);
+
+    // Extra destination channels are silent.
+    int16_t surround[OE_TEST_FRAME_COUNT * 6];
+    memset(surround, 0x55, sizeof(surround));
+    OEConvert(&OEInt16Stereo, &(OEAudioFormat){ OEAudioSampleTypeInt16, 6, false }, 1, (const void *[]){ samples }, (void *[]){ surround }, OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(surround[6], samples[2]);
+    XCTAssertEqual(surround[7], samples[3]);
+    XCTAssertEqual(surround[8], 0);
+    XCTAssertEqual(surround[11], 0);
+}
+
+- (void)testRingBufferConversion
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:sizeof(samples) * 2];
+    [buffer write:samples maxLength:sizeof(samples)];
+
+    OEAudioConverter *converter = OEAudioConverterCreate(&OEInt16Stereo, &OEFloatPlanar);
+    float left[OE_TEST_FRAME_COUNT], right[OE_TEST_FRAME_COUNT];
+    XCTAssertEqual([buffer readFrames:OE_TEST_FRAME_COUNT + 10 intoBuffers:(void *[]){ left, right } converter:converter], OE_TEST_FRAME_COUNT);
+    XCTAssertEqual(right[500], samples[1001] / 32768.0f);
+    XCTAssertEqual(buffer.availableBytes, 0);
+    OEAudioConverterDestroy(converter);
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)measureConversionFrom:(const OEAudioFormat *)from to:(const OEAudioFormat *)to gain:(float)gain
+{
+    const size_t frameCount = 48000;
+    // Large enough for any of the interleaved stereo formats.
+    void *interleaved = calloc(frameCount * 2, sizeof(int32_t));
+    float *left = calloc(frameCount, sizeof(float)), *right = calloc(frameCount, sizeof(float));
+    OEAudioConverter *converter = OEAudioConverterCreate(from, to);
+    OEAudioConverterSetGain(converter, gain);
+    const void *source = from->planar ? left : interleaved;
+    void *destination = to->planar ? left : interleaved;
+
+    [self measureBlock:^{
+        for (int i=0; i<100; i++)
+            OEAudioConverterConvert(converter, (const void *[]){ source, right }, (void *[]){ destination, right }, frameCount);
+    }];
+
+    OEAudioConverterDestroy(converter);
+    free(interleaved);
+    free(left);
+    free(right);
+}
+
+- (void)testInt16ToFloatPlanarThroughput
+{
+    [self measureConversionFrom:&OEInt16Stereo to:&OEFloatPlanar gain:1];
+}
+
+- (void)testFloatPlanarToInt16Throughput
+{
+    [self measureConversionFrom:&OEFloatPlanar to:&OEInt16Stereo gain:1];
+}
+
+- (void)testInt16GainThroughput
+{
+    [self measureConversionFrom:&OEInt16Stereo to:&OEInt16Stereo gain:0.5f];
+}
+
+- (void)testInt16StereoToMonoThroughput
+{
+    [self measureConversionFrom:&OEInt16Stereo to:&OEInt16Mono gain:1];
+}
+
+- (void)testInt24ToFloatThroughput
+{
+    [self measureConversionFrom:&OEInt24Stereo to:&OEFloatStereo gain:1];
+}
+
+@end
@@ -0,0 +1,146 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEAudioMixer.h"
+#import "OEGameCore.h"
+
+
+/// Endless frames of constant samples.
+@interface OEConstantAudioSource : NSObject <OEAudioBuffer>
+- (instancetype)initWithFrame:(NSArray<NSNumber *> *)frame;
+@end
+
+@implementation OEConstantAudioSource
+{
+    int16_t _frame[8];
+    NSUInteger _channelCount;
+}
+
+- (instancetype)initWithFrame:(NSArray<NSNumber *> *)frame
+{
+    if((self = [super init]))
+    {
+        _channelCount = frame.count;
+        for (NSUInteger i=0; i<_channelCount; i++)
+            _frame[i] = frame[i].shortValue;
+    }
+    return self;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    int16_t *samples = buffer;
+    NSUInteger count = len / (_channelCount * sizeof(int16_t));
+    for (NSUInteger i=0; i<count; i++)
+        memcpy(samples + i * _channelCount, _frame, _channelCount * sizeof(int16_t));
+    return count * _channelCount * sizeof(int16_t);
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    return 0;
+}
+
+- (NSUInteger)length
+{
+    return 8192;
+}
+
+@end
+
+
+/// A core with a mono track at 32040 Hz and a stereo track at 48000 Hz.
+@interface OETwoTrackGameCore : OEGameCore
+@property NSArray<OEConstantAudioSource *> *sources;
+@end
+
+@implementation OETwoTrackGameCore
+
+- (NSUInteger)audioBufferCount { return 2; }
+- (NSUInteger)channelCountForBuffer:(NSUInteger)buffer { return buffer == 0 ? 1 : 2; }
+- (double)audioSampleRateForBuffer:(NSUInteger)buffer { return buffer == 0 ? 32040 : 48000; }
+- (id<OEAudioBuffer>)audioBufferAtIndex:(NSUInteger)index { return self.sources[index]; }
+
+@end
+
+
+@interface OEAudioMixerTests : XCTestCase
+
+@end
+
+
+@implementation OEAudioMixerTests
+{
+    OETwoTrackGameCore *core;
+}
+
+- (void)setUp
+{
+    core = [[OETwoTrackGameCore alloc] init];
+    core.sources = @[
+        [[OEConstantAudioSource alloc] initWithFrame:@[ @8192 ]],
+        [[OEConstantAudioSource alloc] initWithFrame:@[ @4096, @-4096 ]],
+    ];
+}
+
+- (void)testMixesTracksWithGain
+{
+    OEAudioMixer *mixer = [[OEAudioMixer alloc] initWithGameCore:core outputSampleRate:48000 channelCount:2];
+    XCTAssertEqual(mixer.trackCount, 2);
+    [mixer setGain:2 forTrack:1];
+
+    // The mono track goes to both channels; the stereo track is doubled.
+    int16_t output[1000 * 2];
+    XCTAssertEqual([mixer read:output maxLength:sizeof(output)], sizeof(output));
+    for (int i=64; i<1000; i++) {
+        XCTAssertEqualWithAccuracy(output[2 * i], 8192 + 8192, 64);
+        XCTAssertEqualWithAccuracy(output[2 * i + 1], 8192 - 8192, 64);
+    }
+}
+
+- (void)testClipsTheMix
+{
+    OEAudioMixer *mixer = [[OEAudioMixer alloc] initWithGameCore:core outputSampleRate:44100 channelCount:1];
+    [mixer setGain:8 forTrack:0];
+
+    int16_t output[512];
+    [mixer read:output maxLength:sizeof(output)];
+    XCTAssertEqual(output[256], 32767, @"a mix above full scale was not clipped");
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)testMixThroughput
+{
+    OEAudioMixer *mixer = [[OEAudioMixer alloc] initWithGameCore:core outputSampleRate:48000 channelCount:2];
+    [self measureBlock:^{
+        int16_t output[512 * 2];
+        for (int i=0; i<1000; i++)
+            [mixer read:output maxLength:sizeof(output)];
+    }];
+}
+
+@end
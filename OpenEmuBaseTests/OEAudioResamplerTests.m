@@ -0,0 +1,194 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEAudioResampler.h"
+
+
+/// An endless stereo sine, inverted on the right channel.
+@interface OESineAudioSource : NSObject <OEAudioBuffer>
+- (instancetype)initWithFrequency:(double)frequency sampleRate:(double)sampleRate;
+@property (readonly) NSUInteger framesRead;
+@end
+
+@implementation OESineAudioSource
+{
+    double _frequency, _sampleRate;
+}
+
+- (instancetype)initWithFrequency:(double)frequency sampleRate:(double)sampleRate
+{
+    if((self = [super init]))
+    {
+        _frequency = frequency;
+        _sampleRate = sampleRate;
+    }
+    return self;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    int16_t *samples = buffer;
+    NSUInteger count = len / (2 * sizeof(int16_t));
+    for (NSUInteger i=0; i<count; i++) {
+        double value = 0.5 * sin(2 * M_PI * _frequency * _framesRead++ / _sampleRate);
+        samples[2 * i] = (int16_t)lrint(value * 32767);
+        samples[2 * i + 1] = (int16_t)lrint(-value * 32767);
+    }
+    return count * 2 * sizeof(int16_t);
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    return 0;
+}
+
+- (NSUInteger)length
+{
+    return 4096;
+}
+
+@end
+
+
+@interface OEAudioResamplerTests : XCTestCase
+
+@end
+
+
+@implementation OEAudioResamplerTests
+
+static const NSUInteger OEAudioResamplerTestsFilterLengths[] = { 8, 16, 32, 64 };
+
+/// Signal to noise ratio in dB of the left channel of one second of output,
+/// compared with the ideal resampled sine.
+static double OEResampledSineSNR(NSUInteger filterLength, double inputRate, double outputRate)
+{
+    OESineAudioSource *source = [[OESineAudioSource alloc] initWithFrequency:1000 sampleRate:inputRate];
+    OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:source channelCount:2 inputSampleRate:inputRate outputSampleRate:outputRate filterLength:filterLength];
+
+    NSUInteger frameCount = (NSUInteger)outputRate;
+    int16_t *output = calloc(frameCount * 2, sizeof(int16_t));
+    for (NSUInteger frame=0; frame<frameCount; frame += 512)
+        [resampler read:output + frame * 2 maxLength:MIN(512, frameCount - frame) * 2 * sizeof(int16_t)];
+
+    // Output frame n is centered on input frame n * step + filterLength / 2 - 1.
+    double step = inputRate / outputRate, signal = 0, noise = 0;
+    for (NSUInteger frame=filterLength; frame<frameCount; frame++) {
+        double ideal = 0.5 * 32767 * sin(2 * M_PI * 1000 * (frame * step + resampler.filterLength / 2 - 1) / inputRate);
+        signal += ideal * ideal;
+        noise += (output[frame * 2] - ideal) * (output[frame * 2] - ideal);
+    }
+    free(output);
+    return 10 * log10(signal / noise);
+}
+
+- (void)testPassband
+{
+    for (int i=0; i<4; i++) {
+        NSUInteger length = OEAudioResamplerTestsFilterLengths[i];
+        XCTAssertGreaterThan(OEResampledSineSNR(length, 32040, 48000), 70, @"%lu taps, upsampling", length);
+        XCTAssertGreaterThan(OEResampledSineSNR(length, 48000, 44100), 70, @"%lu taps, downsampling", length);
+    }
+}
+
+- (void)testAliasRejection
+{
+    // A 20 kHz tone is above the Nyquist frequency of 32040 Hz, so it must
+    // be filtered out instead of folding back into the audible range.
+    OESineAudioSource *source = [[OESineAudioSource alloc] initWithFrequency:20000 sampleRate:48000];
+    OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:source channelCount:2 inputSampleRate:48000 outputSampleRate:32040 filterLength:32];
+
+    int16_t output[4096 * 2];
+    [resampler read:output maxLength:sizeof(output)];
+    double power = 0;
+    for (NSUInteger frame=64; frame<4096; frame++)
+        power += (double)output[frame * 2] * output[frame * 2];
+    double level = 10 * log10(power / (4096 - 64) / (0.125 * 32767 * 32767));
+
+    XCTAssertLessThan(level, -60, @"aliased tone only attenuated by %.1f dB", -level);
+}
+
+- (void)testRateAdjustment
+{
+    OESineAudioSource *source = [[OESineAudioSource alloc] initWithFrequency:1000 sampleRate:48000];
+    OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:source channelCount:2 inputSampleRate:48000 outputSampleRate:48000 filterLength:32];
+    int16_t output[480 * 2];
+
+    for (int i=0; i<100; i++)
+        [resampler read:output maxLength:sizeof(output)];
+    XCTAssertEqualWithAccuracy(source.framesRead, 48000, 64);
+
+    resampler.rateAdjustment = 1.01;
+    XCTAssertEqualWithAccuracy(resampler.ratio, 1 / 1.01, 1e-9);
+    for (int i=0; i<100; i++)
+        [resampler read:output maxLength:sizeof(output)];
+    XCTAssertEqualWithAccuracy(source.framesRead, 48000 + 48480, 64);
+}
+
+- (void)testPartialFrames
+{
+    OESineAudioSource *sine = [[OESineAudioSource alloc] initWithFrequency:1000 sampleRate:44100];
+    OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:sine channelCount:2 inputSampleRate:44100 outputSampleRate:48000 filterLength:16];
+    int16_t output[256 * 2];
+    XCTAssertEqual([resampler read:output maxLength:sizeof(output)], sizeof(output));
+    XCTAssertEqual([resampler read:output maxLength:3], 0, @"partial frame returned");
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)measureThroughputWithFilterLength:(NSUInteger)filterLength
+{
+    // Includes generating the input.
+    OESineAudioSource *source = [[OESineAudioSource alloc] initWithFrequency:1000 sampleRate:32040];
+    OEAudioResampler *resampler = [[OEAudioResampler alloc] initWithSourceBuffer:source channelCount:2 inputSampleRate:32040 outputSampleRate:48000 filterLength:filterLength];
+    [self measureBlock:^{
+        int16_t output[512 * 2];
+        for (int i=0; i<1000; i++)
+            [resampler read:output maxLength:sizeof(output)];
+    }];
+}
+
+- (void)testThroughput8Taps
+{
+    [self measureThroughputWithFilterLength:8];
+}
+
+- (void)testThroughput16Taps
+{
+    [self measureThroughputWithFilterLength:16];
+}
+
+- (void)testThroughput32Taps
+{
+    [self measureThroughputWithFilterLength:32];
+}
+
+- (void)testThroughput64Taps
+{
+    [self measureThroughputWithFilterLength:64];
+}
+
+@end
@@ -0,0 +1,217 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEAudioTimeStretcher.h"
+
+
+/// An endless stereo sine, inverted on the right channel.
+@interface OEToneAudioSource : NSObject <OEAudioBuffer>
+- (instancetype)initWithFrequency:(double)frequency sampleRate:(double)sampleRate;
+@property (readonly) NSUInteger framesRead;
+/// Reads stop once this many frames were read, to starve the reader. Defaults to NSUIntegerMax.
+@property NSUInteger frameLimit;
+@end
+
+@implementation OEToneAudioSource
+{
+    double _frequency, _sampleRate;
+}
+
+- (instancetype)initWithFrequency:(double)frequency sampleRate:(double)sampleRate
+{
+    if((self = [super init]))
+    {
+        _frequency = frequency;
+        _sampleRate = sampleRate;
+        _frameLimit = NSUIntegerMax;
+    }
+    return self;
+}
+
+- (NSUInteger)read:(void *)buffer maxLength:(NSUInteger)len
+{
+    int16_t *samples = buffer;
+    NSUInteger count = MIN(len / (2 * sizeof(int16_t)), _frameLimit - MIN(_framesRead, _frameLimit));
+    for (NSUInteger i=0; i<count; i++) {
+        double value = 0.5 * sin(2 * M_PI * _frequency * _framesRead++ / _sampleRate);
+        samples[2 * i] = (int16_t)lrint(value * 32767);
+        samples[2 * i + 1] = (int16_t)lrint(-value * 32767);
+    }
+    return count * 2 * sizeof(int16_t);
+}
+
+- (NSUInteger)write:(const void *)buffer maxLength:(NSUInteger)length
+{
+    return 0;
+}
+
+- (NSUInteger)length
+{
+    return 4096;
+}
+
+@end
+
+
+@interface OEAudioTimeStretcherTests : XCTestCase
+
+@end
+
+
+@implementation OEAudioTimeStretcherTests
+
+/// The frequency of the left channel, from the distance between its first
+/// and last rising zero crossings.
+static double OEMeasuredFrequency(const int16_t *samples, NSUInteger frameCount, double sampleRate)
+{
+    double first = -1, last = 0;
+    NSUInteger crossings = 0;
+    for (NSUInteger frame=1; frame<frameCount; frame++) {
+        int16_t a = samples[2 * (frame - 1)], b = samples[2 * frame];
+        if (a < 0 && b >= 0) {
+            last = frame - 1 + (double)-a / (b - a);
+            if (first < 0)
+                first = last;
+            crossings++;
+        }
+    }
+    return (crossings - 1) * sampleRate / (last - first);
+}
+
+/// The largest difference between two consecutive samples of the left channel.
+static int OELargestStep(const int16_t *samples, NSUInteger frameCount)
+{
+    int largest = 0;
+    for (NSUInteger frame=1; frame<frameCount; frame++)
+        largest = MAX(largest, abs(samples[2 * frame] - samples[2 * (frame - 1)]));
+    return largest;
+}
+
+- (void)testPassThroughAtNormalRate
+{
+    OEToneAudioSource *source = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+    OEToneAudioSource *reference = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+    OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:source channelCount:2 sampleRate:48000];
+    int16_t output[960 * 2], expected[960 * 2];
+
+    XCTAssertTrue(stretcher.passesThrough);
+    XCTAssertEqual([stretcher read:output maxLength:sizeof(output)], sizeof(output));
+    [reference read:expected maxLength:sizeof(expected)];
+    XCTAssertEqual(memcmp(output, expected, sizeof(output)), 0);
+}
+
+- (void)testPitchIsPreserved
+{
+    const double rates[] = { 0.25, 0.5, 2, 5, 8 };
+    const NSUInteger frameCount = 48000;
+    int16_t *output = calloc(frameCount * 2, sizeof(int16_t));
+
+    for (int i=0; i<5; i++) {
+        OEToneAudioSource *source = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+        OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:source channelCount:2 sampleRate:48000];
+        stretcher.rate = rates[i];
+        for (NSUInteger frame=0; frame<frameCount; frame += 512)
+            [stretcher read:output + frame * 2 maxLength:MIN(512, frameCount - frame) * 2 * sizeof(int16_t)];
+
+        XCTAssertEqualWithAccuracy(OEMeasuredFrequency(output, frameCount, 48000), 440, 1, @"pitch changed at rate %g", rates[i]);
+        // The stretcher reads ahead by up to four 10 ms hops.
+        XCTAssertEqualWithAccuracy(source.framesRead, rates[i] * frameCount, 2048 + rates[i] * 480, @"wrong duration at rate %g", rates[i]);
+        // Segments are joined in phase, so there are no jumps larger than the sine's own.
+        XCTAssertLessThan(OELargestStep(output, frameCount), 1000, @"discontinuity at rate %g", rates[i]);
+    }
+    free(output);
+}
+
+- (void)testRateChangesAreContinuous
+{
+    OEToneAudioSource *source = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+    OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:source channelCount:2 sampleRate:48000];
+    const double rates[] = { 1, 2.5, 1, 0.5, 4, 1 };
+    const NSUInteger frameCount = 48000;
+    int16_t *output = calloc(frameCount * 2, sizeof(int16_t));
+
+    for (NSUInteger frame=0; frame<frameCount; frame += 480) {
+        stretcher.rate = rates[frame / 8000];
+        XCTAssertEqual([stretcher read:output + frame * 2 maxLength:480 * 2 * sizeof(int16_t)], 480 * 2 * sizeof(int16_t));
+    }
+
+    XCTAssertLessThan(OELargestStep(output, frameCount), 1000);
+    XCTAssertTrue(stretcher.passesThrough, @"still stretching at rate 1");
+    free(output);
+}
+
+- (void)testRateIsClamped
+{
+    OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:[[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000] channelCount:2 sampleRate:48000];
+    stretcher.rate = 100;
+    XCTAssertEqual(stretcher.rate, 8);
+    stretcher.rate = 0;
+    XCTAssertEqual(stretcher.rate, 0.25);
+}
+
+
+- (void)testReturnsToNormalRateAfterStarving
+{
+    // Starve the stretcher at many points, so some fetches run out of input
+    // before reaching the frames following the last segment.
+    const NSUInteger hopFrames = 480;
+    for (NSUInteger limit = 8 * hopFrames; limit < 24 * hopFrames; limit += 11) {
+        OEToneAudioSource *source = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+        OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:source channelCount:2 sampleRate:48000];
+        int16_t output[4 * 480 * 2];
+        source.frameLimit = limit;
+        stretcher.rate = 2;
+        while ([stretcher read:output maxLength:sizeof(output)] == sizeof(output)) {}
+
+        // The history left is flushed, then reads go straight to the source again.
+        stretcher.rate = 1;
+        NSUInteger flushed = [stretcher read:output maxLength:sizeof(output)] / sizeof(output[0]) / 2;
+        XCTAssertLessThanOrEqual(flushed, 4 * hopFrames, @"limit %lu", (unsigned long)limit);
+        XCTAssertEqual([stretcher read:output maxLength:sizeof(output)], 0);
+
+        source.frameLimit = NSUIntegerMax;
+        NSUInteger framesRead = source.framesRead;
+        XCTAssertEqual([stretcher read:output maxLength:sizeof(output)], sizeof(output));
+        XCTAssertTrue(stretcher.passesThrough);
+        XCTAssertEqual(source.framesRead, framesRead + 4 * hopFrames);
+    }
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)testThroughputAtRate8
+{
+    OEToneAudioSource *source = [[OEToneAudioSource alloc] initWithFrequency:440 sampleRate:48000];
+    OEAudioTimeStretcher *stretcher = [[OEAudioTimeStretcher alloc] initWithSourceBuffer:source channelCount:2 sampleRate:48000];
+    stretcher.rate = 8;
+    [self measureBlock:^{
+        int16_t output[512 * 2];
+        for (int i=0; i<1000; i++)
+            [stretcher read:output maxLength:sizeof(output)];
+    }];
+}
+
+@end
@@ -0,0 +1,210 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OECaptureWriter.h"
+#import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
+#import "OERingBuffer.h"
+#import "OETestGameCore.h"
+
+
+@interface OECaptureWriterTests : XCTestCase
+
+@end
+
+
+@implementation OECaptureWriterTests
+{
+    OETestGameCore *core;
+    NSURL *audioURL;
+    NSURL *videoURL;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+    NSURL *directory = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+    NSString *name = NSUUID.UUID.UUIDString;
+    audioURL = [directory URLByAppendingPathComponent:[name stringByAppendingPathExtension:@"wav"]];
+    videoURL = [directory URLByAppendingPathComponent:[name stringByAppendingPathExtension:@"y4m"]];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:audioURL error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:videoURL error:nil];
+}
+
+- (OECaptureWriter *)attachWriter
+{
+    NSError *error;
+    OECaptureWriter *writer = [[OECaptureWriter alloc] initWithAudioURL:audioURL videoURL:videoURL error:&error];
+    XCTAssertNotNil(writer, @"%@", error);
+    core.captureWriter = writer;
+    return writer;
+}
+
+/// Fills the screenRect of an 8x4 BGRA buffer with a gray level.
+static void OEFillFrame(uint32_t *pixels, uint8_t level)
+{
+    for (int i=0; i<8*4; i++)
+        pixels[i] = 0xFF0000FF; // red outside the screenRect
+    for (int y=1; y<3; y++)
+        for (int x=2; x<6; x++)
+            pixels[y * 8 + x] = 0xFF000000 | level << 16 | level << 8 | level;
+}
+
+- (void)testTapsAudioWithoutConsumingIt
+{
+    OECaptureWriter *writer = [self attachWriter];
+    OERingBuffer *ringBuffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+
+    int16_t samples[400 * 2];
+    for (int i=0; i<400 * 2; i++)
+        samples[i] = i;
+    for (int i=0; i<4; i++)
+        [ringBuffer write:samples maxLength:sizeof(samples)];
+    XCTAssertEqual(ringBuffer.availableBytes, 4 * sizeof(samples), @"the capture consumed audio");
+
+    [writer finishWriting];
+    XCTAssertEqual(writer.writtenAudioFrameCount, 1600);
+    XCTAssertEqual(writer.droppedAudioFrameCount, 0);
+
+    NSData *file = [NSData dataWithContentsOfURL:audioURL];
+    XCTAssertEqual(file.length, 44 + 4 * sizeof(samples));
+    const uint8_t *bytes = file.bytes;
+    XCTAssertEqual(memcmp(bytes, "RIFF", 4), 0);
+    XCTAssertEqual(memcmp(bytes + 8, "WAVEfmt ", 8), 0);
+    XCTAssertEqual(OSReadLittleInt16(bytes, 22), 2, @"channel count");
+    XCTAssertEqual(OSReadLittleInt32(bytes, 24), 48000, @"sample rate");
+    XCTAssertEqual(OSReadLittleInt16(bytes, 34), 16, @"bit depth");
+    XCTAssertEqual(OSReadLittleInt32(bytes, 40), 4 * sizeof(samples), @"data length");
+    XCTAssertEqual(memcmp(bytes + 44 + 3 * sizeof(samples), samples, sizeof(samples)), 0);
+}
+
+- (void)testReplacesDroppedAudioWithSilence
+{
+    OECaptureWriter *writer = [self attachWriter];
+    OERingBuffer *ringBuffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+
+    // Larger than the writer's buffer, so it can never be queued.
+    NSUInteger frameCount = 48000 * 4;
+    int16_t *samples = calloc(frameCount * 2, sizeof(int16_t));
+    for (NSUInteger i=0; i<frameCount * 2; i++)
+        samples[i] = 1000;
+    [ringBuffer write:samples maxLength:frameCount * 2 * sizeof(int16_t)];
+    [ringBuffer write:samples maxLength:100 * 2 * sizeof(int16_t)];
+    free(samples);
+
+    [writer finishWriting];
+    XCTAssertEqual(writer.droppedAudioFrameCount, frameCount);
+    XCTAssertEqual(writer.writtenAudioFrameCount, frameCount + 100);
+
+    NSData *file = [NSData dataWithContentsOfURL:audioURL];
+    const int16_t *written = (const int16_t *)((const uint8_t *)file.bytes + 44);
+    XCTAssertEqual(written[0], 0);
+    XCTAssertEqual(written[frameCount * 2 - 1], 0);
+    XCTAssertEqual(written[frameCount * 2], 1000);
+}
+
+- (void)testRepeatsMissingVideoFrames
+{
+    OECaptureWriter *writer = [self attachWriter];
+    uint32_t pixels[8 * 4];
+
+    // A frame before the first appended one, then a white frame which is
+    // repeated twice, then a gray one.
+    [writer OE_gameCoreDidExecuteFrame:core];
+    OEFillFrame(pixels, 255);
+    XCTAssertTrue([writer appendVideoFrame:pixels]);
+    [writer OE_gameCoreDidExecuteFrame:core];
+    [writer OE_gameCoreDidExecuteFrame:core];
+    [writer OE_gameCoreDidExecuteFrame:core];
+    OEFillFrame(pixels, 128);
+    XCTAssertTrue([writer appendVideoFrame:pixels]);
+    [writer OE_gameCoreDidExecuteFrame:core];
+
+    [writer finishWriting];
+    XCTAssertEqual(writer.writtenVideoFrameCount, 5);
+    XCTAssertEqual(writer.droppedVideoFrameCount, 0);
+
+    NSData *file = [NSData dataWithContentsOfURL:videoURL];
+    NSString *header = @"YUV4MPEG2 W4 H2 F60:1 Ip A2:3 C444\n";
+    XCTAssertEqual(memcmp(file.bytes, header.UTF8String, header.length), 0);
+
+    NSUInteger frameLength = strlen("FRAME\n") + 4 * 2 * 3;
+    XCTAssertEqual(file.length, header.length + 5 * frameLength);
+    const uint8_t *frames = (const uint8_t *)file.bytes + header.length;
+    uint8_t expectedLuma[] = { 16, 235, 235, 235, 126 };
+    for (int i=0; i<5; i++) {
+        const uint8_t *frame = frames + i * frameLength;
+        XCTAssertEqual(memcmp(frame, "FRAME\n", 6), 0);
+        for (int p=0; p<8; p++) {
+            XCTAssertEqual(frame[6 + p], expectedLuma[i], @"luma of frame %d", i);
+            XCTAssertEqual(frame[6 + 8 + p], 128, @"gray frames have no chroma");
+        }
+    }
+}
+
+- (void)testReleasingWhileTheCoreWritesAudio
+{
+    OERingBuffer *ringBuffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+    __block OECaptureWriter *writer = [[OECaptureWriter alloc] initWithAudioURL:audioURL videoURL:nil error:NULL];
+    [writer OE_attachToGameCore:core];
+    __weak OECaptureWriter *weakWriter = writer;
+
+    // The last reference goes away on another thread, without detaching first.
+    dispatch_semaphore_t released = dispatch_semaphore_create(0);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        writer = nil;
+        dispatch_semaphore_signal(released);
+    });
+
+    int16_t samples[64 * 2] = { 0 };
+    uint8_t discarded[sizeof(samples)];
+    while (dispatch_semaphore_wait(released, DISPATCH_TIME_NOW) != 0) {
+        [ringBuffer write:samples maxLength:sizeof(samples)];
+        [ringBuffer read:discarded maxLength:sizeof(discarded)];
+    }
+    for (int i=0; i<100; i++)
+        [ringBuffer write:samples maxLength:sizeof(samples)];
+
+    XCTAssertNil(weakWriter);
+}
+
+- (void)testIgnoresFramesAfterFinishing
+{
+    OECaptureWriter *writer = [self attachWriter];
+    uint32_t pixels[8 * 4];
+    OEFillFrame(pixels, 0);
+    XCTAssertTrue([writer appendVideoFrame:pixels]);
+    [writer finishWriting];
+
+    XCTAssertTrue(writer.isFinished);
+    XCTAssertFalse([writer appendVideoFrame:pixels]);
+    XCTAssertEqual(writer.writtenVideoFrameCount, 1);
+}
+
+@end
@@ -0,0 +1,205 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "OECommandQueue.h"
+
+
+@interface OECommandQueueTests : XCTestCase
+
+@end
+
+
+static atomic_int OECommandQueueTestsReleased;
+static atomic_bool OECommandQueueTestsReceived;
+
+static void OECountReleasedContext(void *context)
+{
+    atomic_fetch_add(&OECommandQueueTestsReleased, 1);
+}
+
+static void OEAddValueToContext(const OECommand *command)
+{
+    *(uint64_t *)command->context += command->key;
+}
+
+
+@implementation OECommandQueueTests
+
+
+- (void)testOrderAndCapacity
+{
+    OECommandQueue *queue = OECommandQueueCreate(6);
+    XCTAssertEqual(OECommandQueueCapacity(queue), 8, @"capacity not rounded up to a power of 2");
+
+    for (uint32_t i=0; i<8; i++) {
+        OECommand command = { .key = i };
+        XCTAssertTrue(OECommandQueuePush(queue, &command), @"push failed before the queue was full");
+    }
+    OECommand overflow = { .key = 8 };
+    XCTAssertFalse(OECommandQueuePush(queue, &overflow), @"push succeeded on a full queue");
+    XCTAssertEqual(OECommandQueueCount(queue), 8);
+
+    OECommand command;
+    for (uint32_t i=0; i<8; i++) {
+        XCTAssertTrue(OECommandQueuePop(queue, &command));
+        XCTAssertEqual(command.key, i, @"commands popped out of order");
+    }
+    XCTAssertFalse(OECommandQueuePop(queue, &command), @"popped from an empty queue");
+
+    OECommandQueueDestroy(queue);
+}
+
+
+- (void)testDrainPerformsAndReleases
+{
+    OECommandQueue *queue = OECommandQueueCreate(16);
+    uint64_t sum = 0;
+    atomic_store(&OECommandQueueTestsReleased, 0);
+
+    for (uint32_t i=1; i<=10; i++) {
+        OECommand command = { .function = OEAddValueToContext, .context = &sum, .releaseContext = OECountReleasedContext, .key = i };
+        OECommandQueuePush(queue, &command);
+    }
+    XCTAssertEqual(OECommandQueueDrain(queue), 10);
+    XCTAssertEqual(sum, 55);
+    XCTAssertEqual(atomic_load(&OECommandQueueTestsReleased), 10);
+
+    // Commands left in the queue are released, but not performed.
+    OECommand command = { .function = OEAddValueToContext, .context = &sum, .releaseContext = OECountReleasedContext, .key = 1 };
+    OECommandQueuePush(queue, &command);
+    OECommandQueueDestroy(queue);
+    XCTAssertEqual(sum, 55);
+    XCTAssertEqual(atomic_load(&OECommandQueueTestsReleased), 11);
+}
+
+
+- (void)testMultipleProducers
+{
+    const uint32_t producerCount = 4, commandCount = 100000;
+    OECommandQueue *queue = OECommandQueueCreate(256);
+
+    dispatch_group_t group = dispatch_group_create();
+    for (uint32_t p=0; p<producerCount; p++) {
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            for (uint32_t i=0; i<commandCount; ) {
+                OECommand command = { .player = p, .key = i };
+                if (OECommandQueuePush(queue, &command))
+                    i++;
+            }
+        });
+    }
+
+    uint32_t next[4] = { 0 };
+    BOOL ordered = YES;
+    OECommand command;
+    for (NSUInteger popped=0; popped < producerCount * commandCount; ) {
+        if (!OECommandQueuePop(queue, &command))
+            continue;
+        ordered = ordered && command.key == next[command.player];
+        next[command.player] = command.key + 1;
+        popped++;
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    XCTAssertTrue(ordered, @"commands from a single producer popped out of order");
+    XCTAssertEqual(OECommandQueueCount(queue), 0);
+    OECommandQueueDestroy(queue);
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)testPushPopThroughput
+{
+    OECommandQueue *queue = OECommandQueueCreate(1024);
+    [self measureBlock:^{
+        OECommand command = { .tag = OECommandTagPressKey };
+        for (int round=0; round<1000; round++) {
+            for (int i=0; i<1000; i++)
+                OECommandQueuePush(queue, &command);
+            OECommandQueueDrain(queue);
+        }
+    }];
+    OECommandQueueDestroy(queue);
+}
+
+
+- (void)testContendedThroughput
+{
+    const uint32_t producerCount = 4, commandCount = 250000;
+    OECommandQueue *queue = OECommandQueueCreate(1024);
+    [self measureBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        for (uint32_t p=0; p<producerCount; p++) {
+            dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                OECommand command = { .player = p };
+                for (uint32_t i=0; i<commandCount; )
+                    if (OECommandQueuePush(queue, &command))
+                        i++;
+            });
+        }
+        OECommand command;
+        for (NSUInteger popped=0; popped < producerCount * commandCount; )
+            if (OECommandQueuePop(queue, &command))
+                popped++;
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    }];
+    OECommandQueueDestroy(queue);
+}
+
+
+- (void)testPushToPopLatency
+{
+    const uint32_t sampleCount = 10000;
+    OECommandQueue *queue = OECommandQueueCreate(16);
+
+    // The producer sends one command at a time to a spinning consumer, so the
+    // measured time is sampleCount round trips between the two threads.
+    [self measureBlock:^{
+        atomic_store(&OECommandQueueTestsReceived, true);
+        dispatch_group_t group = dispatch_group_create();
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            for (uint32_t i=0; i<sampleCount; i++) {
+                while (!atomic_load(&OECommandQueueTestsReceived)) {}
+                atomic_store(&OECommandQueueTestsReceived, false);
+                OECommand command = { .key = i };
+                OECommandQueuePush(queue, &command);
+            }
+        });
+
+        OECommand command;
+        for (uint32_t i=0; i<sampleCount; i++) {
+            while (!OECommandQueuePop(queue, &command)) {}
+            XCTAssertEqual(command.key, i);
+            atomic_store(&OECommandQueueTestsReceived, true);
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    }];
+    OECommandQueueDestroy(queue);
+}
+
+
+@end
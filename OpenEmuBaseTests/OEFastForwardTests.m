@@ -0,0 +1,138 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
+#import "OERingBuffer.h"
+#import "OERingBuffer_Internal.h"
+#import "OETestGameCore.h"
+
+
+@interface OEFastForwardTests : XCTestCase
+
+@end
+
+
+@implementation OEFastForwardTests
+{
+    OETestGameCore *core;
+    OETestRenderDelegate *renderDelegate;
+    NSMutableString *pattern;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+    renderDelegate = [[OETestRenderDelegate alloc] init];
+    core.renderDelegate = renderDelegate;
+    core.decimatesFastForward = YES;
+    core.stretchesAudio = NO;
+
+    // P for presented frames, S for skipped ones.
+    pattern = [NSMutableString string];
+    NSMutableString *frames = pattern;
+    core.executeFrameHandler = ^(OETestGameCore *gameCore) {
+        [frames appendString:gameCore.isSkippingFrame ? @"S" : @"P"];
+    };
+}
+
+- (void)executeFrames:(NSUInteger)count
+{
+    for (NSUInteger i=0; i<count; i++)
+        [core OE_executeFrame];
+}
+
+- (void)testPresentsOneInEveryRateFrames
+{
+    core.rate = 4;
+    [self executeFrames:8];
+
+    XCTAssertEqualObjects(pattern, @"PSSSPSSS");
+    XCTAssertEqual(renderDelegate.presentedFrameCount, 2);
+    XCTAssertEqual(renderDelegate.skippedFrameCount, 6);
+    XCTAssertEqual(core.skippedFrameCount, 6);
+}
+
+- (void)testAlternatesIntervalsForFractionalRates
+{
+    core.rate = 2.5;
+    [self executeFrames:10];
+
+    XCTAssertEqualObjects(pattern, @"PSSPSPSSPS");
+}
+
+- (void)testPresentsEveryFrameAtNormalSpeed
+{
+    core.rate = 1;
+    [self executeFrames:4];
+
+    XCTAssertEqualObjects(pattern, @"PPPP");
+}
+
+- (void)testPresentsEveryFrameWhenDisabled
+{
+    core.decimatesFastForward = NO;
+    core.rate = 4;
+    [self executeFrames:4];
+
+    XCTAssertEqualObjects(pattern, @"PPPP");
+}
+
+- (void)testDropsTheAudioOfSkippedFrames
+{
+    OERingBuffer *ringBuffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+    ringBuffer.anticipatesUnderflow = NO;
+    NSData *samples = [NSMutableData dataWithLength:64];
+    core.executeFrameHandler = ^(OETestGameCore *gameCore) {
+        [ringBuffer write:samples.bytes maxLength:samples.length];
+    };
+
+    core.rate = 4;
+    [self executeFrames:8];
+
+    XCTAssertEqual(ringBuffer.availableBytes, 2 * samples.length, @"only presented frames keep their audio");
+    XCTAssertFalse(ringBuffer.discardsWrites, @"writes are only discarded during skipped frames");
+}
+
+- (void)testKeepsTheAudioOfSkippedFramesWhenStretching
+{
+    core.stretchesAudio = YES;
+    OERingBuffer *ringBuffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+    XCTAssertNotNil(ringBuffer.timeStretcher);
+
+    NSMutableArray<NSNumber *> *discarded = [NSMutableArray array];
+    core.executeFrameHandler = ^(OETestGameCore *gameCore) {
+        [discarded addObject:@(ringBuffer.discardsWrites)];
+    };
+
+    core.rate = 4;
+    [self executeFrames:4];
+
+    XCTAssertEqualObjects(discarded, (@[ @NO, @NO, @NO, @NO ]));
+    XCTAssertEqual(core.skippedFrameCount, 3, @"presentation is still decimated");
+}
+
+@end
@@ -0,0 +1,170 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEFrameChangeDetector.h"
+
+
+@interface OEFrameChangeDetectorTests : XCTestCase
+
+@end
+
+
+// A 60x40 screenRect at (2, 1) of a 64x48 BGRA buffer, which is a 4x3 grid of 16x16 tiles.
+#define OE_TEST_WIDTH  64
+#define OE_TEST_HEIGHT 48
+static const OEIntRect OETestScreenRect = { { 2, 1 }, { 60, 40 } };
+
+
+@implementation OEFrameChangeDetectorTests
+{
+    uint32_t pixels[OE_TEST_HEIGHT][OE_TEST_WIDTH];
+    OEFrameChangeDetector *detector;
+}
+
+- (void)setUp
+{
+    for (int y=0; y<OE_TEST_HEIGHT; y++)
+        for (int x=0; x<OE_TEST_WIDTH; x++)
+            pixels[y][x] = y * OE_TEST_WIDTH + x;
+    detector = [[OEFrameChangeDetector alloc] init];
+}
+
+- (BOOL)detect
+{
+    return [detector detectChangesInFrame:pixels bytesPerRow:sizeof(pixels[0]) bytesPerPixel:4 rect:OETestScreenRect];
+}
+
+- (void)testFirstFrameIsDirty
+{
+    XCTAssertTrue([self detect]);
+    XCTAssertEqual(detector.tileGridSize.width, 4);
+    XCTAssertEqual(detector.tileGridSize.height, 3);
+    XCTAssertEqual(detector.dirtyTileCount, 12);
+    XCTAssertTrue(OEIntRectEqualToRect(detector.dirtyRect, OETestScreenRect));
+}
+
+- (void)testUnchangedFrames
+{
+    [self detect];
+
+    // Pixels outside the screenRect don't count.
+    pixels[0][0] = 0xFFFFFFFF;
+    pixels[47][63] = 0xFFFFFFFF;
+
+    XCTAssertFalse([self detect]);
+    XCTAssertFalse(detector.changed);
+    XCTAssertEqual(detector.dirtyTileCount, 0);
+    XCTAssertTrue(OEIntRectIsEmpty(detector.dirtyRect));
+    XCTAssertEqual(detector.frameCount, 2);
+    XCTAssertEqual(detector.unchangedFrameCount, 1);
+}
+
+- (void)testFindsDirtyTiles
+{
+    [self detect];
+
+    // Tile (1, 2), and the partial tile (3, 0) on the right edge.
+    pixels[1 + 35][2 + 20] = 0;
+    pixels[1 + 3][2 + 58] = 0;
+
+    XCTAssertTrue([self detect]);
+    XCTAssertEqual(detector.dirtyTileCount, 2);
+    XCTAssertTrue([detector isTileDirtyAtColumn:1 row:2]);
+    XCTAssertTrue([detector isTileDirtyAtColumn:3 row:0]);
+    XCTAssertFalse([detector isTileDirtyAtColumn:1 row:0]);
+    XCTAssertFalse([detector isTileDirtyAtColumn:3 row:2]);
+    XCTAssertTrue(OEIntRectEqualToRect(detector.dirtyRect, OEIntRectMake(2 + 16, 1, 44, 40)));
+
+    // The copy of the previous frame is up to date.
+    XCTAssertFalse([self detect]);
+    pixels[1 + 39][2 + 59] = 0;
+    XCTAssertTrue([self detect]);
+    XCTAssertTrue(OEIntRectEqualToRect(detector.dirtyRect, OEIntRectMake(2 + 48, 1 + 32, 12, 8)));
+}
+
+- (void)testNewGeometryIsDirty
+{
+    [self detect];
+    XCTAssertTrue([detector detectChangesInFrame:pixels bytesPerRow:sizeof(pixels[0]) bytesPerPixel:4 rect:OEIntRectMake(0, 0, 64, 48)]);
+    XCTAssertEqual(detector.dirtyTileCount, 12);
+    XCTAssertFalse([detector detectChangesInFrame:pixels bytesPerRow:sizeof(pixels[0]) bytesPerPixel:4 rect:OEIntRectMake(0, 0, 64, 48)]);
+
+    [detector reset];
+    XCTAssertTrue([detector detectChangesInFrame:pixels bytesPerRow:sizeof(pixels[0]) bytesPerPixel:4 rect:OEIntRectMake(0, 0, 64, 48)]);
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)measureDetectionWithSize:(OEIntSize)size changing:(BOOL)changing
+{
+    uint32_t *frames[2] = { calloc(size.width * size.height, 4), calloc(size.width * size.height, 4) };
+    for (int i=0; i<size.width * size.height; i++)
+        frames[1][i] = 1;
+    uint32_t *first = frames[0], *second = changing ? frames[1] : frames[0];
+    OEFrameChangeDetector *sizedDetector = [[OEFrameChangeDetector alloc] init];
+    OEIntRect rect = OEIntRectMake(0, 0, size.width, size.height);
+
+    [self measureBlock:^{
+        for (int i=0; i<1000; i++)
+            [sizedDetector detectChangesInFrame:i & 1 ? second : first bytesPerRow:size.width * 4 bytesPerPixel:4 rect:rect];
+    }];
+
+    free(frames[0]);
+    free(frames[1]);
+}
+
+- (void)testChangedFrameThroughputAt256x224
+{
+    [self measureDetectionWithSize:OEIntSizeMake(256, 224) changing:YES];
+}
+
+- (void)testUnchangedFrameThroughputAt320x240
+{
+    [self measureDetectionWithSize:OEIntSizeMake(320, 240) changing:NO];
+}
+
+- (void)testChangedFrameThroughputAt320x240
+{
+    [self measureDetectionWithSize:OEIntSizeMake(320, 240) changing:YES];
+}
+
+- (void)testChangedFrameThroughputAt640x480
+{
+    [self measureDetectionWithSize:OEIntSizeMake(640, 480) changing:YES];
+}
+
+- (void)testUnchangedFrameThroughput
+{
+    uint32_t *frame = calloc(640 * 480, 4);
+    OEFrameChangeDetector *sizedDetector = [[OEFrameChangeDetector alloc] init];
+    [self measureBlock:^{
+        for (int i=0; i<100; i++)
+            [sizedDetector detectChangesInFrame:frame bytesPerRow:640 * 4 bytesPerPixel:4 rect:OEIntRectMake(0, 0, 640, 480)];
+    }];
+    free(frame);
+}
+
+@end
@@ -0,0 +1,161 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
+#import "OETestGameCore.h"
+
+
+@interface OEFrameDelayTests : XCTestCase
+
+@end
+
+
+static const NSTimeInterval OETestFrameDuration = 1.0 / 60;
+static const NSTimeInterval OETestDelayStep = OETestFrameDuration / 64;
+
+
+@implementation OEFrameDelayTests
+{
+    OETestGameCore *core;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+    core.rate = 1;
+    core.usesFrameDelay = YES;
+    core.frameDelaySafetyMargin = 0.002;
+}
+
+- (void)runFrames:(NSUInteger)count executionTime:(NSTimeInterval)executionTime lateness:(NSTimeInterval)lateness
+{
+    for (NSUInteger i = 0; i < count; i++)
+        [core OE_updateFrameDelayWithExecutionTime:executionTime lateness:lateness frameDuration:OETestFrameDuration];
+}
+
+/// The delay leaving room for frames taking executionTime and the safety margin.
+- (NSTimeInterval)targetForExecutionTime:(NSTimeInterval)executionTime
+{
+    return OETestFrameDuration - executionTime - core.frameDelaySafetyMargin;
+}
+
+- (void)testDisabledByDefault
+{
+    core = [[OETestGameCore alloc] init];
+    core.rate = 1;
+    [self runFrames:200 executionTime:0.004 lateness:-0.01];
+
+    XCTAssertEqual(core.frameDelay, 0);
+    XCTAssertEqualWithAccuracy(core.frameExecutionTime, 0.004, 1e-12, @"execution times are still measured");
+}
+
+- (void)testWaitsForEnoughSamples
+{
+    [self runFrames:15 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqual(core.frameDelay, 0);
+    XCTAssertEqual(core.frameExecutionTime, 0);
+
+    [self runFrames:1 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameDelay, OETestDelayStep, 1e-12);
+}
+
+- (void)testGrowsGraduallyToTarget
+{
+    [self runFrames:16 executionTime:0.004 lateness:-0.01];
+
+    NSTimeInterval target = [self targetForExecutionTime:0.004];
+    NSTimeInterval previous = core.frameDelay;
+    for (NSUInteger i = 0; i < 100; i++) {
+        [self runFrames:1 executionTime:0.004 lateness:-0.01];
+        XCTAssertGreaterThanOrEqual(core.frameDelay, previous);
+        XCTAssertLessThanOrEqual(core.frameDelay - previous, OETestDelayStep + 1e-12);
+        previous = core.frameDelay;
+    }
+
+    XCTAssertEqualWithAccuracy(core.frameDelay, target, 1e-12);
+}
+
+- (void)testUsesNinetyFifthPercentile
+{
+    // 3 slow frames out of 64 are outliers, 4 are not.
+    [self runFrames:61 executionTime:0.002 lateness:-0.01];
+    [self runFrames:3 executionTime:0.012 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameExecutionTime, 0.002, 1e-12);
+
+    [self runFrames:60 executionTime:0.002 lateness:-0.01];
+    [self runFrames:4 executionTime:0.012 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameExecutionTime, 0.012, 1e-12);
+}
+
+- (void)testShrinksWhenFramesGetSlower
+{
+    [self runFrames:200 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameDelay, [self targetForExecutionTime:0.004], 1e-12);
+
+    [self runFrames:64 executionTime:0.010 lateness:-0.001];
+    XCTAssertEqualWithAccuracy(core.frameDelay, [self targetForExecutionTime:0.010], 1e-12);
+}
+
+- (void)testNeverExceedsNinetyPercentOfFrame
+{
+    core.frameDelaySafetyMargin = 0;
+    [self runFrames:200 executionTime:0 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameDelay, OETestFrameDuration * 0.9, 1e-12);
+}
+
+- (void)testBacksOffAfterMissedDeadline
+{
+    [self runFrames:200 executionTime:0.004 lateness:-0.01];
+    NSTimeInterval delay = core.frameDelay;
+
+    [self runFrames:1 executionTime:0.004 lateness:0.001];
+    XCTAssertEqualWithAccuracy(core.frameDelay, delay / 2, 1e-12);
+    XCTAssertEqual(core.frameDelayMissCount, 1);
+
+    // The delay stays put during the cooldown, then grows again.
+    [self runFrames:120 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameDelay, delay / 2, 1e-12);
+    [self runFrames:1 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqualWithAccuracy(core.frameDelay, delay / 2 + OETestDelayStep, 1e-12);
+}
+
+- (void)testOnlyAppliesAtNormalSpeed
+{
+    [self runFrames:200 executionTime:0.004 lateness:-0.01];
+    XCTAssertGreaterThan(core.frameDelay, 0);
+
+    core.runsUncapped = YES;
+    [self runFrames:1 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqual(core.frameDelay, 0);
+
+    core.runsUncapped = NO;
+    core.usesFrameDelay = NO;
+    [self runFrames:1 executionTime:0.004 lateness:-0.01];
+    XCTAssertEqual(core.frameDelay, 0);
+}
+
+@end
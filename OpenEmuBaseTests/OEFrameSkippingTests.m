@@ -0,0 +1,177 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OEGameCore_Internal.h"
+#import "OETestGameCore.h"
+
+
+@interface OEFrameSkippingTests : XCTestCase
+
+@end
+
+
+static const NSTimeInterval OETestFrameDuration = 1.0 / 60;
+
+
+/// A render delegate which can't leave frames out.
+@interface OEPresentingRenderDelegate : OETestRenderDelegate
+@end
+
+@implementation OEPresentingRenderDelegate
+
+- (BOOL)respondsToSelector:(SEL)selector
+{
+    if (selector == @selector(willExecuteSkippedFrame) || selector == @selector(didExecuteSkippedFrame))
+        return NO;
+    return [super respondsToSelector:selector];
+}
+
+@end
+
+
+@implementation OEFrameSkippingTests
+{
+    OETestGameCore *core;
+    OETestRenderDelegate *renderDelegate;
+    NSMutableArray<NSNumber *> *skippedFrames;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+    renderDelegate = [[OETestRenderDelegate alloc] init];
+    core.renderDelegate = renderDelegate;
+    core.rate = 1;
+    core.maximumFrameSkip = 3;
+    core.frameSkipWindow = 1;
+
+    skippedFrames = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *frames = skippedFrames;
+    core.executeFrameHandler = ^(OETestGameCore *core) {
+        [frames addObject:@(core.isSkippingFrame)];
+    };
+}
+
+/// Finishes a frame lateness seconds after its deadline, then executes the next one.
+- (void)runFrameFinishingLate:(NSTimeInterval)lateness
+{
+    [core OE_updateFrameSkipAtTime:core.nextFrameTime + lateness frameDuration:OETestFrameDuration];
+    [core OE_executeFrame];
+}
+
+- (void)testPresentsFramesOnTime
+{
+    for (int i=0; i<4; i++)
+        [self runFrameFinishingLate:-0.005];
+
+    XCTAssertEqualObjects(skippedFrames, (@[ @NO, @NO, @NO, @NO ]));
+    XCTAssertEqual(core.skippedFrameCount, 0);
+    XCTAssertEqual(core.lateFrameCount, 0);
+    XCTAssertEqual(renderDelegate.presentedFrameCount, 4);
+}
+
+- (void)testSkipsFramesWhileBehind
+{
+    [self runFrameFinishingLate:OETestFrameDuration];
+
+    XCTAssertEqualObjects(skippedFrames, @[ @YES ]);
+    XCTAssertFalse(core.isSkippingFrame, @"only set during the frame");
+    XCTAssertEqual(core.skippedFrameCount, 1);
+    XCTAssertEqual(core.lateFrameCount, 1);
+    XCTAssertEqual(renderDelegate.skippedFrameCount, 1);
+    XCTAssertEqual(renderDelegate.presentedFrameCount, 0);
+}
+
+- (void)testPresentsFramesTheRenderDelegateCantLeaveOut
+{
+    renderDelegate = [[OEPresentingRenderDelegate alloc] init];
+    core.renderDelegate = renderDelegate;
+    [self runFrameFinishingLate:OETestFrameDuration];
+
+    XCTAssertEqualObjects(skippedFrames, @[ @NO ], @"the core must render the frame");
+    XCTAssertEqual(core.skippedFrameCount, 0);
+    XCTAssertEqual(renderDelegate.presentedFrameCount, 1);
+}
+
+- (void)testLimitsConsecutiveSkippedFrames
+{
+    for (int i=0; i<5; i++)
+        [self runFrameFinishingLate:OETestFrameDuration];
+
+    XCTAssertEqualObjects(skippedFrames, (@[ @YES, @YES, @YES, @NO, @YES ]));
+    XCTAssertEqual(core.skippedFrameCount, 4);
+}
+
+- (void)testIgnoresSlightLateness
+{
+    // Below frameSkipThreshold of a frame.
+    [self runFrameFinishingLate:OETestFrameDuration * 0.25];
+
+    XCTAssertEqualObjects(skippedFrames, @[ @NO ]);
+    XCTAssertEqual(core.lateFrameCount, 1);
+}
+
+- (void)testAveragesLatenessOverTheWindow
+{
+    core.frameSkipWindow = 8;
+
+    // A single slow frame doesn't move the average past the threshold.
+    [self runFrameFinishingLate:OETestFrameDuration];
+    XCTAssertEqualObjects(skippedFrames, @[ @NO ]);
+}
+
+- (void)testDoesNotSkipWhenDisabled
+{
+    core.maximumFrameSkip = 0;
+    for (int i=0; i<3; i++)
+        [self runFrameFinishingLate:OETestFrameDuration];
+
+    XCTAssertEqualObjects(skippedFrames, (@[ @NO, @NO, @NO ]));
+    XCTAssertEqual(core.lateFrameCount, 3);
+}
+
+- (void)testResynchronizesWhenTooFarBehind
+{
+    NSTimeInterval realTime = core.nextFrameTime + 1;
+    [core OE_updateFrameSkipAtTime:realTime frameDuration:OETestFrameDuration];
+    [core OE_executeFrame];
+
+    XCTAssertEqual(core.resynchronizationCount, 1);
+    XCTAssertEqual(core.nextFrameTime, realTime);
+    XCTAssertEqualObjects(skippedFrames, @[ @NO ], @"resynchronizing makes skipping unnecessary");
+}
+
+- (void)testNeverSkipsWhilePaused
+{
+    core.rate = 0;
+    [self runFrameFinishingLate:OETestFrameDuration];
+
+    XCTAssertEqualObjects(skippedFrames, @[ @NO ]);
+    XCTAssertEqual(core.skippedFrameCount, 0);
+}
+
+@end
@@ -0,0 +1,193 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OEGameCoreScheduler.h"
+#import "OETestGameCore.h"
+
+
+@interface OEGameCoreSchedulerTests : XCTestCase
+
+@end
+
+
+@implementation OEGameCoreSchedulerTests
+{
+    OEGameCoreScheduler *scheduler;
+    NSArray<OETestGameCore *> *cores;
+    NSMutableSet<OETestGameCore *> *runningCores;
+}
+
+- (void)setUp
+{
+    scheduler = [[OEGameCoreScheduler alloc] initWithThreadCount:2];
+
+    NSMutableArray<OETestGameCore *> *gameCores = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 4; i++) {
+        OETestGameCore *gameCore = [[OETestGameCore alloc] init];
+        gameCore.scheduler = scheduler;
+        [gameCores addObject:gameCore];
+    }
+    cores = gameCores;
+    runningCores = [NSMutableSet set];
+}
+
+- (void)tearDown
+{
+    [self stopCores:runningCores.allObjects];
+    [scheduler invalidate];
+}
+
+- (void)startCores:(NSArray<OETestGameCore *> *)gameCores
+{
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray array];
+    for (OETestGameCore *gameCore in gameCores) {
+        XCTestExpectation *started = [self expectationWithDescription:@"started"];
+        [gameCore startEmulationWithCompletionHandler:^{
+            [started fulfill];
+        }];
+        [expectations addObject:started];
+        [runningCores addObject:gameCore];
+    }
+    [self waitForExpectations:expectations timeout:5];
+}
+
+- (void)stopCores:(NSArray<OETestGameCore *> *)gameCores
+{
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray array];
+    for (OETestGameCore *gameCore in gameCores) {
+        XCTestExpectation *stopped = [self expectationWithDescription:@"stopped"];
+        [gameCore stopEmulationWithCompletionHandler:^{
+            [stopped fulfill];
+        }];
+        [expectations addObject:stopped];
+        [runningCores removeObject:gameCore];
+    }
+    [self waitForExpectations:expectations timeout:5];
+}
+
+- (void)testRunsAllCores
+{
+    [self startCores:cores];
+
+    XCTAssertEqual(scheduler.threadCount, 2);
+    XCTAssertEqual(scheduler.gameCoreCount, cores.count);
+    for (OETestGameCore *gameCore in cores)
+        XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(gameCore.executedFrameCount >= 4); }));
+
+    NSUInteger executedFrameCount = 0;
+    for (OETestGameCore *gameCore in cores)
+        executedFrameCount += gameCore.executedFrameCount;
+    XCTAssertGreaterThanOrEqual(scheduler.executedFrameCount, executedFrameCount - cores.count);
+}
+
+- (void)testRunsFramesOnWorkerThreads
+{
+    NSMutableSet<NSString *> *threadNames = [NSMutableSet set];
+    for (OETestGameCore *gameCore in cores) {
+        gameCore.executeFrameHandler = ^(OETestGameCore *core) {
+            @synchronized (threadNames) {
+                [threadNames addObject:NSThread.currentThread.name ?: @""];
+            }
+        };
+    }
+    [self startCores:cores];
+    for (OETestGameCore *gameCore in cores)
+        XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(gameCore.executedFrameCount >= 2); }));
+
+    @synchronized (threadNames) {
+        XCTAssertGreaterThan(threadNames.count, 0);
+        XCTAssertLessThanOrEqual(threadNames.count, scheduler.threadCount);
+        for (NSString *name in threadNames)
+            XCTAssertTrue([name hasPrefix:@"org.openemu.core-scheduler."], @"%@", name);
+    }
+}
+
+- (void)testPacesFramesAtFrameRate
+{
+    [self startCores:cores];
+
+    OETestGameCore *gameCore = cores.firstObject;
+    NSUInteger frameCount = gameCore.executedFrameCount;
+    [NSThread sleepForTimeInterval:0.5];
+    NSUInteger executed = gameCore.executedFrameCount - frameCount;
+
+    // 30 frames expected at 60 Hz; leave room for a loaded machine.
+    XCTAssertGreaterThan(executed, 10);
+    XCTAssertLessThan(executed, 45);
+}
+
+- (void)testPerformsBlocksOnScheduledCore
+{
+    [self startCores:cores];
+
+    XCTestExpectation *performed = [self expectationWithDescription:@"performed"];
+    [cores[1] performBlock:^{
+        XCTAssertTrue([NSThread.currentThread.name hasPrefix:@"org.openemu.core-scheduler."]);
+        [performed fulfill];
+    }];
+    [self waitForExpectations:@[performed] timeout:1];
+}
+
+- (void)testParksPausedCoreOnScheduler
+{
+    OETestGameCore *gameCore = cores.firstObject;
+    gameCore.parksWhenPaused = YES;
+    [self startCores:cores];
+
+    gameCore.rate = 0;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(gameCore.currentPhase == OEGameCorePhaseParked); }));
+    NSUInteger frameCount = gameCore.executedFrameCount;
+    NSUInteger otherFrameCount = cores.lastObject.executedFrameCount;
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(gameCore.executedFrameCount, frameCount);
+    XCTAssertGreaterThan(cores.lastObject.executedFrameCount, otherFrameCount, @"other cores keep running");
+
+    XCTestExpectation *performed = [self expectationWithDescription:@"performed"];
+    [gameCore performBlock:^{
+        [performed fulfill];
+    }];
+    [self waitForExpectations:@[performed] timeout:1];
+
+    gameCore.rate = 1;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(gameCore.executedFrameCount >= frameCount + 2); }));
+}
+
+- (void)testUnschedulesStoppedCore
+{
+    [self startCores:cores];
+    XCTAssertEqual(scheduler.gameCoreCount, cores.count);
+
+    OETestGameCore *gameCore = cores.firstObject;
+    [self stopCores:@[ gameCore ]];
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->scheduler.gameCoreCount == self->cores.count - 1); }));
+
+    NSUInteger frameCount = gameCore.executedFrameCount;
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(gameCore.executedFrameCount, frameCount);
+}
+
+@end
@@ -0,0 +1,181 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "OEGameCore.h"
+#import "OEGameCoreWatchdog.h"
+#import "OETestGameCore.h"
+
+
+@interface OEGameCoreWatchdogTests : XCTestCase
+
+@end
+
+
+@implementation OEGameCoreWatchdogTests
+{
+    OETestGameCore *core;
+    OEGameCoreWatchdog *watchdog;
+    NSMutableArray<OEGameCoreWatchdogEvent *> *events;
+
+    // The next executed frame sleeps for this long, or blocks until gate is signaled if negative.
+    _Atomic(double) nextFrameDuration;
+    dispatch_semaphore_t gate;
+}
+
+- (void)setUp
+{
+    events = [NSMutableArray array];
+    gate = dispatch_semaphore_create(0);
+    atomic_store(&nextFrameDuration, 0);
+
+    // At 60 fps, frames are slow after 33 ms and stalled after 100 ms.
+    watchdog = [[OEGameCoreWatchdog alloc] init];
+    watchdog.slowFrameMultiple = 2;
+    watchdog.stallMultiple = 6;
+    watchdog.checkInterval = 0.01;
+    NSMutableArray<OEGameCoreWatchdogEvent *> *receivedEvents = events;
+    watchdog.eventHandler = ^(OEGameCore *gameCore, OEGameCoreWatchdogEvent *event) {
+        @synchronized (receivedEvents) {
+            [receivedEvents addObject:event];
+        }
+    };
+
+    core = [[OETestGameCore alloc] init];
+    core.watchdog = watchdog;
+    dispatch_semaphore_t frameGate = gate;
+    _Atomic(double) *frameDuration = &nextFrameDuration;
+    core.executeFrameHandler = ^(OETestGameCore *gameCore) {
+        double duration = atomic_exchange(frameDuration, 0);
+        if (duration < 0)
+            dispatch_semaphore_wait(frameGate, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC));
+        else if (duration > 0)
+            [NSThread sleepForTimeInterval:duration];
+    };
+
+    XCTestExpectation *started = [self expectationWithDescription:@"started"];
+    [core startEmulationWithCompletionHandler:^{
+        [started fulfill];
+    }];
+    [self waitForExpectations:@[started] timeout:5];
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.executedFrameCount >= 2); }));
+}
+
+- (void)tearDown
+{
+    dispatch_semaphore_signal(gate);
+
+    XCTestExpectation *stopped = [self expectationWithDescription:@"stopped"];
+    [core stopEmulationWithCompletionHandler:^{
+        [stopped fulfill];
+    }];
+    [self waitForExpectations:@[stopped] timeout:5];
+    [watchdog invalidate];
+}
+
+- (NSArray<OEGameCoreWatchdogEvent *> *)eventsOfType:(OEGameCoreWatchdogEventType)type
+{
+    @synchronized (events) {
+        return [events filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(OEGameCoreWatchdogEvent *event, NSDictionary *bindings) {
+            return event.type == type;
+        }]];
+    }
+}
+
+- (void)testReportsSlowFrame
+{
+    atomic_store(&nextFrameDuration, 0.05);
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)([self eventsOfType:OEGameCoreWatchdogEventTypeSlowFrame].lastObject.duration >= 0.05); }));
+
+    OEGameCoreWatchdogEvent *event = [self eventsOfType:OEGameCoreWatchdogEventTypeSlowFrame].lastObject;
+    XCTAssertEqual(event.phase, OEGameCorePhaseExecute);
+    XCTAssertEqualWithAccuracy(event.frameBudget, 1.0 / 60, 1e-9);
+    XCTAssertGreaterThanOrEqual(watchdog.slowFrameCount, 1);
+    XCTAssertEqual(watchdog.stallCount, 0);
+}
+
+- (void)testIgnoresFramesWithinBudget
+{
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.executedFrameCount >= 20); }));
+    XCTAssertEqual(watchdog.stallCount, 0);
+    XCTAssertEqual(watchdog.stalledGameCores.count, 0);
+}
+
+- (void)testReportsStallAndRecovery
+{
+    atomic_store(&nextFrameDuration, -1);
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->watchdog.stallCount == 1); }));
+    XCTAssertEqualObjects(watchdog.stalledGameCores, @[ core ]);
+
+    // A frame is only reported as stalled once.
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(watchdog.stallCount, 1);
+
+    dispatch_semaphore_signal(gate);
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->watchdog.recoveryCount == 1); }));
+    XCTAssertEqual(watchdog.stalledGameCores.count, 0);
+
+    XCTAssertTrue(OETestWaitUntil(1, ^{ return (BOOL)([self eventsOfType:OEGameCoreWatchdogEventTypeRecovery].count == 1); }));
+    OEGameCoreWatchdogEvent *stall = [self eventsOfType:OEGameCoreWatchdogEventTypeStall].firstObject;
+    OEGameCoreWatchdogEvent *recovery = [self eventsOfType:OEGameCoreWatchdogEventTypeRecovery].firstObject;
+    XCTAssertEqual(stall.phase, OEGameCorePhaseExecute);
+    XCTAssertGreaterThan(stall.duration, 0.1);
+    XCTAssertEqual(recovery.frameNumber, stall.frameNumber);
+    XCTAssertGreaterThanOrEqual(recovery.duration, stall.duration);
+}
+
+- (void)testIgnoresParkedCore
+{
+    core.parksWhenPaused = YES;
+    core.rate = 0;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }));
+
+    [NSThread sleepForTimeInterval:0.2];
+    XCTAssertEqual(watchdog.stallCount, 0);
+}
+
+- (void)testReportsStallDuringParkedCommand
+{
+    core.parksWhenPaused = YES;
+    core.rate = 0;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }));
+
+    dispatch_semaphore_t commandGate = gate;
+    [core performBlock:^{
+        dispatch_semaphore_wait(commandGate, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC));
+    }];
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->watchdog.stallCount == 1); }));
+    XCTAssertEqualObjects(watchdog.stalledGameCores, @[ core ]);
+    XCTAssertEqual([self eventsOfType:OEGameCoreWatchdogEventTypeStall].firstObject.phase, OEGameCorePhaseCommands);
+
+    // The core stays parked once the command is done, and is healthy again.
+    dispatch_semaphore_signal(gate);
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->watchdog.recoveryCount == 1); }));
+    XCTAssertEqual(watchdog.stalledGameCores.count, 0);
+    XCTAssertEqual(core.currentPhase, OEGameCorePhaseParked);
+}
+
+@end
@@ -0,0 +1,254 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore_Internal.h"
+#import "OEInputMovie.h"
+#import "OETestGameCore.h"
+
+
+/// A core whose state is the number of frames it executed.
+@interface OEInputMovieTestGameCore : OETestGameCore
+@property uint64_t frame;
+@end
+
+@implementation OEInputMovieTestGameCore
+
+- (NSData *)serializeStateWithError:(NSError **)outError
+{
+    uint64_t frame = _frame;
+    return [NSData dataWithBytes:&frame length:sizeof(frame)];
+}
+
+- (BOOL)deserializeState:(NSData *)state withError:(NSError **)outError
+{
+    if (state.length != sizeof(uint64_t))
+        return NO;
+
+    [state getBytes:&_frame length:sizeof(_frame)];
+    return YES;
+}
+
+@end
+
+
+@interface OEInputMovieTests : XCTestCase
+
+@end
+
+
+@implementation OEInputMovieTests
+{
+    NSURL *directoryURL;
+    NSURL *movieURL;
+    OEInputMovieTestGameCore *core;
+    NSMutableArray<NSString *> *events;
+}
+
+- (void)setUp
+{
+    directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES] URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [NSFileManager.defaultManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+    movieURL = [directoryURL URLByAppendingPathComponent:@"Movie.oeinputmovie"];
+    core = [[OEInputMovieTestGameCore alloc] init];
+    events = [NSMutableArray array];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:directoryURL error:nil];
+}
+
+/// Records 10 frames with a save point every 4 frames. Player 0 holds key 1
+/// during frames 1-5, player 1 moves analog key 3 to 0.5 at frame 3.
+- (NSData *)recordMovie
+{
+    NSError *error;
+    OEInputMovieRecorder *recorder = [[OEInputMovieRecorder alloc] initWithURL:movieURL error:&error];
+    XCTAssertNotNil(recorder, @"%@", error);
+    recorder.savePointInterval = 4;
+
+    for (NSUInteger frame = 0; frame < 10; frame++) {
+        if (frame == 1)
+            [recorder recordValue:1 forKey:1 player:0 analog:NO];
+        if (frame == 3)
+            [recorder recordValue:0.5 forKey:3 player:1 analog:YES];
+        if (frame == 6)
+            [recorder recordValue:0 forKey:1 player:0 analog:NO];
+
+        [recorder OE_gameCoreWillExecuteFrame:core];
+        core.frame++;
+    }
+    [recorder finishRecording];
+
+    XCTAssertEqual(recorder.frameCount, 10);
+    XCTAssertEqual(recorder.eventCount, 3);
+    XCTAssertEqual(recorder.savePointCount, 3);
+
+    return [NSData dataWithContentsOfURL:movieURL];
+}
+
+- (OEInputMoviePlayer *)playerWithData:(NSData *)data error:(NSError **)error
+{
+    // Replace the file rather than rewriting it, earlier players may still map it.
+    [data writeToURL:movieURL atomically:YES];
+    OEInputMoviePlayer *moviePlayer = [[OEInputMoviePlayer alloc] initWithURL:movieURL error:error];
+
+    __weak OEInputMoviePlayer *weakPlayer = moviePlayer;
+    moviePlayer.eventHandler = ^(NSUInteger player, NSUInteger key, double value, BOOL analog) {
+        [self->events addObject:[NSString stringWithFormat:@"%lu: %lu.%lu = %g%@", (unsigned long)weakPlayer.currentFrame, (unsigned long)player, (unsigned long)key, value, analog ? @" analog" : @""]];
+    };
+    return moviePlayer;
+}
+
+- (void)playFrames:(NSUInteger)frameCount player:(OEInputMoviePlayer *)player
+{
+    for (NSUInteger i = 0; i < frameCount && !player.finished; i++) {
+        [player OE_gameCoreWillExecuteFrame:core];
+        core.frame++;
+    }
+}
+
+- (void)testRoundTrip
+{
+    NSData *data = [self recordMovie];
+    NSError *error;
+    OEInputMoviePlayer *player = [self playerWithData:data error:&error];
+    XCTAssertNotNil(player, @"%@", error);
+
+    XCTAssertEqual(player.frameCount, 10);
+    XCTAssertEqualObjects(player.savePointFrames, (@[ @0, @4, @8 ]));
+
+    core.frame = 100;
+    [self playFrames:20 player:player];
+
+    XCTAssertTrue(player.finished);
+    XCTAssertEqual(player.currentFrame, 10);
+    XCTAssertEqual(core.frame, 10, @"restored to the initial save point");
+    XCTAssertEqualObjects(events, (@[ @"1: 0.1 = 1", @"3: 1.3 = 0.5 analog", @"6: 0.1 = 0" ]));
+}
+
+- (void)testReplaysIdentically
+{
+    NSData *data = [self recordMovie];
+
+    [self playFrames:20 player:[self playerWithData:data error:NULL]];
+    NSArray<NSString *> *firstEvents = [events copy];
+    [events removeAllObjects];
+
+    [self playFrames:20 player:[self playerWithData:data error:NULL]];
+    XCTAssertEqualObjects(events, firstEvents);
+}
+
+- (void)testSeeksToSavePoint
+{
+    NSData *data = [self recordMovie];
+    OEInputMoviePlayer *player = [self playerWithData:data error:NULL];
+    [self playFrames:2 player:player];
+    [events removeAllObjects];
+
+    [player seekToFrame:6];
+    [self playFrames:1 player:player];
+
+    // Before moving to frame 4, the held key is released, then the inputs
+    // held at frame 4 are pressed again.
+    XCTAssertEqual(core.frame, 5);
+    XCTAssertEqual(player.currentFrame, 5);
+    XCTAssertEqualObjects(events, (@[ @"2: 0.1 = 0", @"2: 0.1 = 1", @"2: 1.3 = 0.5 analog" ]));
+
+    [events removeAllObjects];
+    [self playFrames:20 player:player];
+    XCTAssertEqualObjects(events, (@[ @"6: 0.1 = 0" ]));
+}
+
+- (void)testRejectsTruncatedHeader
+{
+    NSData *data = [self recordMovie];
+
+    for (NSUInteger length = 0; length < 8; length++) {
+        NSError *error;
+        XCTAssertNil([self playerWithData:[data subdataWithRange:NSMakeRange(0, length)] error:&error]);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+        XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+    }
+}
+
+- (void)testRejectsCorruptHeader
+{
+    NSMutableData *data = [[self recordMovie] mutableCopy];
+    NSError *error;
+
+    ((uint8_t *)data.mutableBytes)[0] = 'X';
+    XCTAssertNil([self playerWithData:data error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+
+    ((uint8_t *)data.mutableBytes)[0] = 'O';
+    ((uint8_t *)data.mutableBytes)[4] = 2;
+    error = nil;
+    XCTAssertNil([self playerWithData:data error:&error], @"newer version");
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void)testIgnoresTruncatedLastRecord
+{
+    NSData *data = [self recordMovie];
+    NSArray<NSNumber *> *savePointFrames = @[ @0, @4, @8 ];
+
+    for (NSUInteger length = 8; length < data.length; length++) {
+        NSError *error;
+        OEInputMoviePlayer *player = [self playerWithData:[data subdataWithRange:NSMakeRange(0, length)] error:&error];
+        XCTAssertNotNil(player, @"%@", error);
+
+        XCTAssertLessThanOrEqual(player.frameCount, 10);
+        XCTAssertLessThanOrEqual(player.savePointFrames.count, savePointFrames.count);
+        XCTAssertEqualObjects(player.savePointFrames, [savePointFrames subarrayWithRange:NSMakeRange(0, player.savePointFrames.count)]);
+
+        // Whatever is left plays without reading past the data.
+        [self playFrames:20 player:player];
+        XCTAssertTrue(player.finished);
+    }
+}
+
+- (void)testStopsAtUnknownRecord
+{
+    NSMutableData *data = [[self recordMovie] mutableCopy];
+
+    // The first record is the initial save point holding an 8 byte state:
+    // tag, delta, held count, state length, state.
+    NSUInteger secondRecord = 8 + 4 + sizeof(uint64_t);
+    ((uint8_t *)data.mutableBytes)[secondRecord] = 0x7F;
+
+    NSError *error;
+    OEInputMoviePlayer *player = [self playerWithData:data error:&error];
+    XCTAssertNotNil(player, @"%@", error);
+    XCTAssertEqualObjects(player.savePointFrames, @[ @0 ]);
+    XCTAssertEqual(player.frameCount, 1);
+
+    [self playFrames:20 player:player];
+    XCTAssertTrue(player.finished);
+    XCTAssertEqual(events.count, 0);
+}
+
+@end
@@ -0,0 +1,147 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OETestGameCore.h"
+
+
+@interface OEParkingTests : XCTestCase
+
+@end
+
+
+@implementation OEParkingTests
+{
+    OETestGameCore *core;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+}
+
+- (void)tearDown
+{
+    XCTestExpectation *stopped = [self expectationWithDescription:@"stopped"];
+    [core stopEmulationWithCompletionHandler:^{
+        [stopped fulfill];
+    }];
+    [self waitForExpectations:@[stopped] timeout:5];
+}
+
+- (void)startCore
+{
+    XCTestExpectation *started = [self expectationWithDescription:@"started"];
+    [core startEmulationWithCompletionHandler:^{
+        [started fulfill];
+    }];
+    [self waitForExpectations:@[started] timeout:5];
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.executedFrameCount >= 2); }));
+}
+
+- (void)pauseAndWaitUntilParked
+{
+    core.rate = 0;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }));
+}
+
+- (void)testParksWhilePaused
+{
+    core.parksWhenPaused = YES;
+    [self startCore];
+    [self pauseAndWaitUntilParked];
+
+    NSUInteger frameCount = core.executedFrameCount;
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(core.executedFrameCount, frameCount);
+    XCTAssertEqual(core.currentPhase, OEGameCorePhaseParked);
+}
+
+- (void)testKeepsLoopingWhilePausedByDefault
+{
+    [self startCore];
+    core.rate = 0;
+
+    // The loop keeps running at 1x rate without executing frames.
+    XCTAssertFalse(OETestWaitUntil(0.2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }));
+    NSUInteger frameCount = core.executedFrameCount;
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(core.executedFrameCount, frameCount);
+}
+
+- (void)testPerformsBlocksWhileParked
+{
+    core.parksWhenPaused = YES;
+    [self startCore];
+    [self pauseAndWaitUntilParked];
+    NSUInteger frameCount = core.executedFrameCount;
+
+    XCTestExpectation *performed = [self expectationWithDescription:@"performed"];
+    [core performBlock:^{
+        [performed fulfill];
+    }];
+    [self waitForExpectations:@[performed] timeout:1];
+
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }), @"parks again");
+    XCTAssertEqual(core.executedFrameCount, frameCount);
+}
+
+- (void)testStepsSingleFramesWhileParked
+{
+    core.parksWhenPaused = YES;
+    [self startCore];
+    [self pauseAndWaitUntilParked];
+    NSUInteger frameCount = core.executedFrameCount;
+
+    [core stepFrameForward];
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.executedFrameCount == frameCount + 1); }));
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase == OEGameCorePhaseParked); }));
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(core.executedFrameCount, frameCount + 1);
+}
+
+- (void)testUnparksWhenResumed
+{
+    core.parksWhenPaused = YES;
+    [self startCore];
+    [self pauseAndWaitUntilParked];
+    NSUInteger frameCount = core.executedFrameCount;
+
+    core.rate = 1;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.executedFrameCount >= frameCount + 2); }));
+}
+
+- (void)testUnparksWhenParkingIsTurnedOff
+{
+    core.parksWhenPaused = YES;
+    [self startCore];
+    [self pauseAndWaitUntilParked];
+
+    core.parksWhenPaused = NO;
+    XCTAssertTrue(OETestWaitUntil(2, ^{ return (BOOL)(self->core.currentPhase != OEGameCorePhaseParked); }));
+}
+
+@end
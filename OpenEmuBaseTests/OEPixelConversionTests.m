@@ -0,0 +1,287 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEPixelConversion.h"
+
+
+@interface OEPixelConversionTests : XCTestCase
+
+@end
+
+
+#define OE_TEST_PIXEL_COUNT 1003
+
+static const uint32_t OETestPixelFormats[] = {
+    OEPixelFormat_LUMINANCE, OEPixelFormat_RGB, OEPixelFormat_BGR, OEPixelFormat_RGBA, OEPixelFormat_BGRA,
+};
+
+static const uint32_t OETestPixelTypes[] = {
+    OEPixelType_UNSIGNED_BYTE,
+    OEPixelType_UNSIGNED_SHORT_5_6_5, OEPixelType_UNSIGNED_SHORT_5_6_5_REV,
+    OEPixelType_UNSIGNED_SHORT_4_4_4_4, OEPixelType_UNSIGNED_SHORT_4_4_4_4_REV,
+    OEPixelType_UNSIGNED_SHORT_5_5_5_1, OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV,
+    OEPixelType_UNSIGNED_INT_8_8_8_8, OEPixelType_UNSIGNED_INT_8_8_8_8_REV,
+    OEPixelType_UNSIGNED_INT_10_10_10_2, OEPixelType_UNSIGNED_INT_2_10_10_10_REV,
+};
+
+#define OE_TEST_FORMAT_COUNT (sizeof(OETestPixelFormats) / sizeof(OETestPixelFormats[0]))
+#define OE_TEST_TYPE_COUNT   (sizeof(OETestPixelTypes) / sizeof(OETestPixelTypes[0]))
+
+static void OEConvertRow(uint32_t fromFormat, uint32_t fromType, uint32_t toFormat, uint32_t toType, const void *source, void *destination, size_t width)
+{
+    OEPixelConverter *converter = OEPixelConverterCreate(fromFormat, fromType, toFormat, toType);
+    OEPixelConverterConvertRow(converter, source, destination, width);
+    OEPixelConverterDestroy(converter);
+}
+
+
+@implementation OEPixelConversionTests
+{
+    uint32_t pixels[OE_TEST_PIXEL_COUNT];
+}
+
+- (void)setUp
+{
+    // An odd pixel count and a spread of values, to hit every kernel's tail.
+    for (int i=0; i<OE_TEST_PIXEL_COUNT; i++)
+        pixels[i] = (uint32_t)i * 2654435761u;
+}
+
+- (void)testDecoding
+{
+    uint32_t result[2];
+
+    // Components are expanded by replicating their bits.
+    uint16_t rgb565[] = { 0xF800, 0x8410 };
+    OEConvertRow(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, rgb565, result, 2);
+    XCTAssertEqual(result[0], 0xFFFF0000);
+    XCTAssertEqual(result[1], 0xFF848284);
+
+    uint16_t bgra1555[] = { 0x7C00, 0x8000 };
+    OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, bgra1555, result, 2);
+    XCTAssertEqual(result[0], 0x00FF0000);
+    XCTAssertEqual(result[1], 0xFF000000);
+
+    uint8_t rgba[] = { 1, 2, 3, 4 };
+    OEConvertRow(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_BYTE, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, rgba, result, 1);
+    XCTAssertEqual(result[0], 0x04010203);
+
+    uint8_t luminance[] = { 0x80 };
+    OEConvertRow(OEPixelFormat_LUMINANCE, OEPixelType_UNSIGNED_BYTE, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, luminance, result, 1);
+    XCTAssertEqual(result[0], 0xFF808080);
+}
+
+- (void)testRoundsWideComponents
+{
+    // 3, 2 and 7 of 1023 are 0.75, 0.50 and 1.74 of 255. Enough pixels for
+    // every kernel, and a tail.
+    uint32_t rgba1010102[9], result[9];
+    for (int i=0; i<9; i++)
+        rgba1010102[i] = 0x40700803;
+    OEConvertRow(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_INT_2_10_10_10_REV, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, rgba1010102, result, 9);
+    for (int i=0; i<9; i++)
+        XCTAssertEqual(result[i], 0x55010002, @"pixel %d", i);
+
+    // Full scale stays full scale.
+    uint32_t white = 0xFFFFFFFF;
+    OEConvertRow(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_INT_2_10_10_10_REV, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, &white, result, 1);
+    XCTAssertEqual(result[0], 0xFFFFFFFF);
+}
+
+- (void)testEncoding
+{
+    uint32_t bgra[] = { 0xFF808080, 0xFFFF0000 };
+
+    // Components are rounded to the nearest value.
+    uint16_t rgb565[2];
+    OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5, bgra, rgb565, 2);
+    XCTAssertEqual(rgb565[0], 0x8410);
+    XCTAssertEqual(rgb565[1], 0xF800);
+
+    uint32_t rgba1010102;
+    OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, OEPixelFormat_RGBA, OEPixelType_UNSIGNED_INT_2_10_10_10_REV, bgra + 1, &rgba1010102, 1);
+    XCTAssertEqual(rgba1010102, 0xC00003FF);
+
+    // Luminance is BT.601 luma.
+    uint8_t luminance[2];
+    OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, OEPixelFormat_LUMINANCE, OEPixelType_UNSIGNED_BYTE, bgra, luminance, 2);
+    XCTAssertEqual(luminance[0], 0x80);
+    XCTAssertEqual(luminance[1], 0x4D);
+}
+
+- (void)testRoundTrips
+{
+    uint8_t encoded[OE_TEST_PIXEL_COUNT * 4], reencoded[OE_TEST_PIXEL_COUNT * 4];
+    uint32_t decoded[OE_TEST_PIXEL_COUNT], decodedOneByOne[OE_TEST_PIXEL_COUNT];
+    int supportedCount = 0;
+
+    for (size_t f=0; f<OE_TEST_FORMAT_COUNT; f++) {
+        for (size_t t=0; t<OE_TEST_TYPE_COUNT; t++) {
+            uint32_t format = OETestPixelFormats[f], type = OETestPixelTypes[t];
+            if (!OEPixelFormatIsSupported(format, type))
+                continue;
+            supportedCount++;
+
+            // Encoding a decoded pixel gives the same pixel.
+            size_t bytesPerPixel = OEPixelBytesPerPixel(format, type);
+            OEPixelConverter *encoder = OEPixelConverterCreate(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, format, type);
+            OEPixelConverter *decoder = OEPixelConverterCreateToBGRA8(format, type);
+            OEPixelConverterConvertRow(encoder, pixels, encoded, OE_TEST_PIXEL_COUNT);
+            OEPixelConverterConvertRow(decoder, encoded, decoded, OE_TEST_PIXEL_COUNT);
+            OEPixelConverterConvertRow(encoder, decoded, reencoded, OE_TEST_PIXEL_COUNT);
+            XCTAssertEqual(memcmp(encoded, reencoded, OE_TEST_PIXEL_COUNT * bytesPerPixel), 0, @"round trip through %#x %#x", format, type);
+
+            // The vector kernels agree with the scalar tail.
+            for (int i=0; i<OE_TEST_PIXEL_COUNT; i++)
+                OEPixelConverterConvertRow(decoder, encoded + i * bytesPerPixel, decodedOneByOne + i, 1);
+            XCTAssertEqual(memcmp(decoded, decodedOneByOne, sizeof(decoded)), 0, @"decoding %#x %#x one pixel at a time", format, type);
+
+            OEPixelConverterDestroy(encoder);
+            OEPixelConverterDestroy(decoder);
+        }
+    }
+
+    XCTAssertEqual(supportedCount, 25);
+}
+
+- (void)testConvertsBetweenAnyFormats
+{
+    // A direct conversion is the same as one through 8-bit BGRA.
+    uint8_t source[OE_TEST_PIXEL_COUNT * 4], direct[OE_TEST_PIXEL_COUNT * 4], indirect[OE_TEST_PIXEL_COUNT * 4];
+    uint32_t bgra[OE_TEST_PIXEL_COUNT];
+    OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_4_4_4_4, pixels, source, OE_TEST_PIXEL_COUNT);
+    OEConvertRow(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_4_4_4_4, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, source, bgra, OE_TEST_PIXEL_COUNT);
+
+    for (size_t f=0; f<OE_TEST_FORMAT_COUNT; f++) {
+        for (size_t t=0; t<OE_TEST_TYPE_COUNT; t++) {
+            uint32_t format = OETestPixelFormats[f], type = OETestPixelTypes[t];
+            if (!OEPixelFormatIsSupported(format, type))
+                continue;
+
+            OEConvertRow(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_4_4_4_4, format, type, source, direct, OE_TEST_PIXEL_COUNT);
+            OEConvertRow(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, format, type, bgra, indirect, OE_TEST_PIXEL_COUNT);
+            XCTAssertEqual(memcmp(direct, indirect, OE_TEST_PIXEL_COUNT * OEPixelBytesPerPixel(format, type)), 0, @"converting to %#x %#x", format, type);
+        }
+    }
+}
+
+- (void)testConvertsRectangles
+{
+    // A 4x2 screenRect at (2, 1) of an 8x4 RGB565 buffer with padded rows.
+    uint16_t buffer[4][10] = { 0 };
+    for (int y=1; y<3; y++)
+        for (int x=2; x<6; x++)
+            buffer[y][x] = 0x001F;
+
+    uint32_t result[2][5];
+    memset(result, 0x55, sizeof(result));
+    OEPixelConverter *converter = OEPixelConverterCreateToBGRA8(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5);
+    OEPixelConverterConvert(converter, buffer, sizeof(buffer[0]), 2, 1, result, sizeof(result[0]), 4, 2);
+    OEPixelConverterDestroy(converter);
+
+    for (int y=0; y<2; y++) {
+        for (int x=0; x<4; x++)
+            XCTAssertEqual(result[y][x], 0xFF0000FF);
+        XCTAssertEqual(result[y][4], 0x55555555, @"wrote past the width");
+    }
+}
+
+- (void)testRejectsUnsupportedFormats
+{
+    XCTAssertEqual(OEPixelBytesPerPixel(OEPixelFormat_RGB, OEPixelType_UNSIGNED_BYTE), 3);
+    XCTAssertEqual(OEPixelBytesPerPixel(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_5_6_5), 2);
+    XCTAssertEqual(OEPixelBytesPerPixel(0, 0), 0);
+
+    XCTAssertFalse(OEPixelFormatIsSupported(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_5_6_5));
+    XCTAssertFalse(OEPixelFormatIsSupported(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_4_4_4_4));
+    XCTAssertFalse(OEPixelFormatIsSupported(OEPixelFormat_LUMINANCE, OEPixelType_UNSIGNED_SHORT_5_6_5));
+    XCTAssertTrue(OEPixelConverterCreate(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_5_6_5, OEPixelFormat_BGRA, OEPixelType_UNSIGNED_BYTE) == NULL);
+    XCTAssertTrue(OEPixelConverterCreateToBGRA8(0, OEPixelType_UNSIGNED_BYTE) == NULL);
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)measureConversionFromFormat:(uint32_t)fromFormat type:(uint32_t)fromType toFormat:(uint32_t)toFormat type:(uint32_t)toType
+{
+    const size_t pixelCount = 1024 * 1024;
+    void *source = calloc(pixelCount, 4), *destination = calloc(pixelCount, 4);
+    OEPixelConverter *converter = OEPixelConverterCreate(fromFormat, fromType, toFormat, toType);
+    XCTAssertTrue(converter != NULL);
+
+    [self measureBlock:^{
+        for (int i=0; i<10; i++)
+            OEPixelConverterConvertRow(converter, source, destination, pixelCount);
+    }];
+
+    OEPixelConverterDestroy(converter);
+    free(source);
+    free(destination);
+}
+
+- (void)testBGRA5551ToBGRA8Throughput
+{
+    [self measureConversionFromFormat:OEPixelFormat_BGRA type:OEPixelType_UNSIGNED_SHORT_1_5_5_5_REV toFormat:OEPixelFormat_BGRA type:OEPixelType_UNSIGNED_INT_8_8_8_8_REV];
+}
+
+- (void)testRGBA8ToBGRA8Throughput
+{
+    [self measureConversionFromFormat:OEPixelFormat_RGBA type:OEPixelType_UNSIGNED_INT_8_8_8_8_REV toFormat:OEPixelFormat_BGRA type:OEPixelType_UNSIGNED_INT_8_8_8_8_REV];
+}
+
+- (void)testRGB8ToBGRA8Throughput
+{
+    [self measureConversionFromFormat:OEPixelFormat_RGB type:OEPixelType_UNSIGNED_BYTE toFormat:OEPixelFormat_BGRA type:OEPixelType_UNSIGNED_INT_8_8_8_8_REV];
+}
+
+- (void)testBGRA8ToRGB565Throughput
+{
+    [self measureConversionFromFormat:OEPixelFormat_BGRA type:OEPixelType_UNSIGNED_INT_8_8_8_8_REV toFormat:OEPixelFormat_RGB type:OEPixelType_UNSIGNED_SHORT_5_6_5];
+}
+
+- (void)testRGB565ToRGBA8Throughput
+{
+    [self measureConversionFromFormat:OEPixelFormat_RGB type:OEPixelType_UNSIGNED_SHORT_5_6_5 toFormat:OEPixelFormat_RGBA type:OEPixelType_UNSIGNED_BYTE];
+}
+
+- (void)testRGB565ToBGRA8Throughput
+{
+    // One 1080p frame per iteration.
+    const size_t width = 1920, height = 1080;
+    uint16_t *source = calloc(width * height, sizeof(uint16_t));
+    uint32_t *destination = calloc(width * height, sizeof(uint32_t));
+    OEPixelConverter *converter = OEPixelConverterCreateToBGRA8(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5);
+
+    [self measureBlock:^{
+        for (int i=0; i<10; i++)
+            OEPixelConverterConvert(converter, source, width * sizeof(uint16_t), 0, 0, destination, width * sizeof(uint32_t), width, height);
+    }];
+
+    OEPixelConverterDestroy(converter);
+    free(source);
+    free(destination);
+}
+
+@end
@@ -0,0 +1,205 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OEPixelScaler.h"
+#import "OEPixelConversion.h"
+#import "OEGeometry.h"
+
+
+@interface OEPixelScalerTests : XCTestCase
+
+@end
+
+
+static const OEPixelScalingMode OETestScalingModes[] = {
+    OEPixelScalingModeNearest, OEPixelScalingModeInteger, OEPixelScalingModeBilinear, OEPixelScalingModeArea,
+};
+
+/// Scales width x height BGRA8 pixels, packed, into a packed destination.
+static void OEScale(OEPixelScalingMode mode, const uint32_t *source, int width, int height, uint32_t *destination, int destinationWidth, int destinationHeight)
+{
+    OEPixelScaler *scaler = OEPixelScalerCreate(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, width, height, destinationWidth, destinationHeight, mode);
+    OEPixelScalerScale(scaler, source, width * 4, 0, 0, destination, destinationWidth * 4);
+    OEPixelScalerDestroy(scaler);
+}
+
+
+@implementation OEPixelScalerTests
+
+- (void)testSameSizeCopies
+{
+    uint32_t source[37 * 23], result[37 * 23];
+    for (int i=0; i<37 * 23; i++)
+        source[i] = (uint32_t)i * 2654435761u;
+
+    for (int m=0; m<4; m++) {
+        OEScale(OETestScalingModes[m], source, 37, 23, result, 37, 23);
+        XCTAssertEqual(memcmp(source, result, sizeof(result)), 0, @"mode %d", OETestScalingModes[m]);
+    }
+}
+
+- (void)testScalesTheScreenRectOfACoreBuffer
+{
+    // A 4x2 screenRect at (2, 1) of an 8x4 RGB565 buffer; blue inside, red outside.
+    uint16_t buffer[4][8];
+    for (int y=0; y<4; y++)
+        for (int x=0; x<8; x++)
+            buffer[y][x] = (y >= 1 && y < 3 && x >= 2 && x < 6) ? 0x001F : 0xF800;
+
+    // Scaled with aspect correction to a 4:3 display.
+    OEIntSize size = OECorrectScreenSizeForAspectSize(OEIntSizeMake(4, 2), OEIntSizeMake(4, 3));
+    XCTAssertEqual(size.width, 4);
+    XCTAssertEqual(size.height, 3);
+    size.width *= 3;
+    size.height *= 3;
+
+    // Integer scaling would leave a border, as 9 rows aren't a multiple of 2.
+    OEPixelScalingMode modes[] = { OEPixelScalingModeNearest, OEPixelScalingModeBilinear, OEPixelScalingModeArea };
+    for (int m=0; m<3; m++) {
+        uint32_t result[9][12];
+        OEPixelScaler *scaler = OEPixelScalerCreate(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5, 4, 2, size.width, size.height, modes[m]);
+        OEPixelScalerScale(scaler, buffer, sizeof(buffer[0]), 2, 1, result, sizeof(result[0]));
+        OEPixelScalerDestroy(scaler);
+
+        for (int y=0; y<9; y++)
+            for (int x=0; x<12; x++)
+                XCTAssertEqual(result[y][x], 0xFF0000FF, @"mode %d at %d, %d", modes[m], x, y);
+    }
+}
+
+- (void)testNearestAndInteger
+{
+    uint32_t source[2 * 2] = { 1, 2, 3, 4 };
+
+    uint32_t nearest[3 * 2];
+    OEScale(OEPixelScalingModeNearest, source, 2, 2, nearest, 3, 2);
+    uint32_t expectedNearest[] = { 1, 2, 2, 3, 4, 4 };
+    XCTAssertEqual(memcmp(nearest, expectedNearest, sizeof(nearest)), 0);
+
+    // Scaled 2x and centered on black.
+    uint32_t row[3] = { 1, 2, 3 };
+    uint32_t integer[8 * 2];
+    OEScale(OEPixelScalingModeInteger, row, 3, 1, integer, 8, 2);
+    const uint32_t b = 0xFF000000;
+    uint32_t expectedInteger[] = {
+        b, 1, 1, 2, 2, 3, 3, b,
+        b, 1, 1, 2, 2, 3, 3, b,
+    };
+    XCTAssertEqual(memcmp(integer, expectedInteger, sizeof(integer)), 0);
+}
+
+- (void)testFiltering
+{
+    // Black to white, scaled up: the pixels between are interpolated.
+    uint32_t ramp[2] = { 0xFF000000, 0xFFFFFFFF };
+    uint32_t bilinear[4];
+    OEScale(OEPixelScalingModeBilinear, ramp, 2, 1, bilinear, 4, 1);
+    XCTAssertEqual(bilinear[0], 0xFF000000);
+    XCTAssertEqual(bilinear[1], 0xFF404040);
+    XCTAssertEqual(bilinear[2], 0xFFBFBFBF);
+    XCTAssertEqual(bilinear[3], 0xFFFFFFFF);
+
+    // 3 pixels averaged into 2: the middle one is split between both.
+    uint32_t stripes[3] = { 0xFF000000, 0xFF909090, 0xFFFFFFFF };
+    uint32_t area[2];
+    OEScale(OEPixelScalingModeArea, stripes, 3, 1, area, 2, 1);
+    XCTAssertEqual(area[0], 0xFF303030);
+    XCTAssertEqual(area[1], 0xFFDADADA);
+}
+
+- (void)testRejectsInvalidScalers
+{
+    XCTAssertTrue(OEPixelScalerCreate(OEPixelFormat_RGBA, OEPixelType_UNSIGNED_SHORT_5_6_5, 4, 4, 8, 8, OEPixelScalingModeNearest) == NULL);
+    XCTAssertTrue(OEPixelScalerCreate(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, 0, 4, 8, 8, OEPixelScalingModeArea) == NULL);
+}
+
+
+#pragma mark - Benchmarks
+
+/// Measures scaling RGB565 frames, as a core renders them, to BGRA8.
+- (void)measureScalingFromWidth:(int)width height:(int)height toWidth:(int)destinationWidth height:(int)destinationHeight mode:(OEPixelScalingMode)mode
+{
+    void *source = calloc(width * height, 2), *destination = calloc(destinationWidth * destinationHeight, 4);
+    OEPixelScaler *scaler = OEPixelScalerCreate(OEPixelFormat_RGB, OEPixelType_UNSIGNED_SHORT_5_6_5, width, height, destinationWidth, destinationHeight, mode);
+    XCTAssertTrue(scaler != NULL);
+
+    [self measureBlock:^{
+        for (int i=0; i<100; i++)
+            OEPixelScalerScale(scaler, source, width * 2, 0, 0, destination, destinationWidth * 4);
+    }];
+
+    OEPixelScalerDestroy(scaler);
+    free(source);
+    free(destination);
+}
+
+// Screenshots of a 256x224 core at 4:3, and at twice that.
+
+- (void)testNearestScreenshotThroughput
+{
+    [self measureScalingFromWidth:256 height:224 toWidth:299 height:224 mode:OEPixelScalingModeNearest];
+}
+
+- (void)testBilinearScreenshotThroughput
+{
+    [self measureScalingFromWidth:256 height:224 toWidth:299 height:224 mode:OEPixelScalingModeBilinear];
+}
+
+- (void)testAreaScreenshotThroughput
+{
+    [self measureScalingFromWidth:256 height:224 toWidth:299 height:224 mode:OEPixelScalingModeArea];
+}
+
+- (void)testIntegerDoubleScreenshotThroughput
+{
+    [self measureScalingFromWidth:256 height:224 toWidth:598 height:448 mode:OEPixelScalingModeInteger];
+}
+
+- (void)testBilinearDoubleScreenshotThroughput
+{
+    [self measureScalingFromWidth:256 height:224 toWidth:598 height:448 mode:OEPixelScalingModeBilinear];
+}
+
+- (void)testRGB565ThumbnailThroughput
+{
+    [self measureScalingFromWidth:640 height:480 toWidth:160 height:120 mode:OEPixelScalingModeArea];
+}
+
+- (void)testThumbnailThroughput
+{
+    void *source = calloc(640 * 480, 4), *destination = calloc(160 * 120, 4);
+    OEPixelScaler *scaler = OEPixelScalerCreate(OEPixelFormat_BGRA, OEPixelType_UNSIGNED_INT_8_8_8_8_REV, 640, 480, 160, 120, OEPixelScalingModeArea);
+
+    [self measureBlock:^{
+        for (int i=0; i<100; i++)
+            OEPixelScalerScale(scaler, source, 640 * 4, 0, 0, destination, 160 * 4);
+    }];
+
+    OEPixelScalerDestroy(scaler);
+    free(source);
+    free(destination);
+}
+
+@end
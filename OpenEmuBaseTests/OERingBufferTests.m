@@ -0,0 +1,844 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import <stdatomic.h>
+#import "OERingBuffer.h"
+#import "OERingBuffer_Internal.h"
+#import "OETestGameCore.h"
+
+
+@interface OERingBufferTests : XCTestCase
+
+@end
+
+
+static atomic_bool OERingBufferTestsProducing;
+
+
+@implementation OERingBufferTests
+
+
+- (void)testDiscardNewest
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+
+    XCTAssertEqual([buffer write:data.bytes maxLength:length], length);
+    XCTAssertEqual(buffer.freeBytes, 0);
+    XCTAssertEqual([buffer write:data.bytes maxLength:1], 0, @"write accepted by a full buffer");
+    XCTAssertEqual([buffer read:data.mutableBytes maxLength:16], 16);
+    XCTAssertEqual(buffer.availableBytes, length - 16);
+}
+
+
+- (void)testDiscardOldest
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    NSUInteger count = buffer.length / sizeof(uint32_t);
+
+    // Write one and a half buffers worth of a counter, then read it all back.
+    uint32_t *values = malloc(count * 3 / 2 * sizeof(uint32_t));
+    for (NSUInteger i=0; i<count * 3 / 2; i++)
+        values[i] = (uint32_t)i;
+    [buffer write:values maxLength:count * sizeof(uint32_t)];
+    [buffer write:values + count maxLength:count / 2 * sizeof(uint32_t)];
+    XCTAssertEqual(buffer.availableBytes, buffer.length);
+
+    uint32_t *result = malloc(buffer.length);
+    XCTAssertEqual([buffer read:result maxLength:buffer.length], buffer.length);
+    XCTAssertEqual(result[0], count / 2, @"the oldest bytes were not the ones overwritten");
+    XCTAssertEqual(result[count - 1], count * 3 / 2 - 1);
+    XCTAssertEqual(buffer.availableBytes, 0);
+
+    // A single write larger than the buffer keeps its end.
+    XCTAssertEqual([buffer write:values maxLength:count * 3 / 2 * sizeof(uint32_t)], buffer.length);
+    XCTAssertEqual([buffer read:result maxLength:buffer.length], buffer.length);
+    XCTAssertEqual(result[0], count / 2);
+
+    free(values);
+    free(result);
+}
+
+
+- (void)testZeroCopy
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    // Regions are contiguous even across the end of the buffer.
+    for (int pass=0; pass<3; pass++) {
+        uint8_t *region = [buffer reserveWriteRegion:length * 3 / 4];
+        XCTAssertTrue(region != NULL);
+        for (NSUInteger i=0; i<length * 3 / 4; i++)
+            region[i] = (uint8_t)(i + pass);
+        XCTAssertEqual(buffer.availableBytes, 0, @"reserved bytes visible before being committed");
+        [buffer commitWrite:length * 3 / 4];
+        XCTAssertEqual(buffer.availableBytes, length * 3 / 4);
+
+        NSUInteger available = length;
+        const uint8_t *data = [buffer reserveReadRegion:&available];
+        XCTAssertEqual(available, length * 3 / 4);
+        XCTAssertEqual(data[0], (uint8_t)pass);
+        XCTAssertEqual(data[available - 1], (uint8_t)(available - 1 + pass));
+        XCTAssertTrue([buffer commitRead:available]);
+        XCTAssertEqual(buffer.availableBytes, 0);
+    }
+
+    // A full buffer refuses reservations, unless it discards the oldest bytes.
+    XCTAssertTrue([buffer reserveWriteRegion:length] != NULL);
+    [buffer commitWrite:length];
+    XCTAssertTrue([buffer reserveWriteRegion:1] == NULL);
+
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    NSUInteger available = 16;
+    XCTAssertTrue([buffer reserveReadRegion:&available] != NULL);
+    XCTAssertTrue([buffer reserveWriteRegion:16] != NULL);
+    [buffer commitWrite:16];
+    XCTAssertFalse([buffer commitRead:available], @"overwritten read region not reported");
+}
+
+
+- (void)testZeroCopyCommitsOnlyReservedBytes
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    [buffer commitWrite:16];
+    XCTAssertEqual(buffer.availableBytes, 0, @"committed without a reservation");
+
+    XCTAssertTrue([buffer reserveWriteRegion:16] != NULL);
+    [buffer commitWrite:64];
+    XCTAssertEqual(buffer.availableBytes, 16, @"committed more than reserved");
+    [buffer commitWrite:16];
+    XCTAssertEqual(buffer.availableBytes, 16, @"committed the same reservation twice");
+
+    // A refused reservation can't be committed either.
+    XCTAssertTrue([buffer reserveWriteRegion:length] == NULL);
+    [buffer commitWrite:length];
+    XCTAssertEqual(buffer.availableBytes, 16);
+
+    NSUInteger available = 8;
+    XCTAssertTrue([buffer reserveReadRegion:&available] != NULL);
+    XCTAssertTrue([buffer commitRead:64]);
+    XCTAssertEqual(buffer.availableBytes, 8, @"consumed more than reserved");
+    XCTAssertEqual(buffer.bytesRead, 8);
+}
+
+
+- (void)testZeroCopyDiscardedWrites
+{
+    for (int p=0; p<2; p++) {
+        OERingBufferDiscardPolicy policy = p == 0 ? OERingBufferDiscardPolicyNewest : OERingBufferDiscardPolicyOldest;
+        OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+        OERingBuffer *copyingBuffer = [[OERingBuffer alloc] initWithLength:4096];
+        buffer.discardPolicy = copyingBuffer.discardPolicy = policy;
+        NSUInteger length = buffer.length;
+        NSMutableData *data = [NSMutableData dataWithLength:length];
+        memset(data.mutableBytes, 0xAB, length);
+
+        // Fill both buffers, then discard a write to each.
+        uint8_t *region = [buffer reserveWriteRegion:length];
+        memcpy(region, data.bytes, length);
+        [buffer commitWrite:length];
+        [copyingBuffer write:data.bytes maxLength:length];
+
+        buffer.discardsWrites = copyingBuffer.discardsWrites = YES;
+        region = [buffer reserveWriteRegion:64];
+        XCTAssertTrue(region != NULL);
+        memset(region, 0, 64);
+        [buffer commitWrite:64];
+        XCTAssertEqual([copyingBuffer write:data.bytes maxLength:64], 64);
+
+        // The published bytes are untouched, and nothing counts as an overrun.
+        XCTAssertEqual(buffer.availableBytes, length);
+        NSUInteger available = length;
+        const uint8_t *bytes = [buffer reserveReadRegion:&available];
+        XCTAssertEqual(available, length);
+        XCTAssertEqual(bytes[0], 0xAB);
+        XCTAssertEqual(bytes[length - 1], 0xAB);
+        XCTAssertTrue([buffer commitRead:available]);
+
+        OERingBufferStatistics statistics = buffer.statistics;
+        OERingBufferStatistics copyingStatistics = copyingBuffer.statistics;
+        XCTAssertEqual(statistics.overrunCount, 0);
+        XCTAssertEqual(statistics.discardedBytes, 0);
+        XCTAssertEqual(statistics.writeCount, copyingStatistics.writeCount);
+        XCTAssertEqual(statistics.overrunCount, copyingStatistics.overrunCount);
+        XCTAssertEqual(statistics.bytesWritten, copyingStatistics.bytesWritten);
+    }
+}
+
+
+- (void)testStatistics
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSMutableData *data = [NSMutableData dataWithLength:length * 2];
+
+    // Fill three quarters, then read a quarter and ask for more than is left.
+    [buffer write:data.bytes maxLength:length * 3 / 4];
+    [buffer read:data.mutableBytes maxLength:length / 4];
+    [buffer read:data.mutableBytes maxLength:length];
+    // A write larger than the buffer is refused with the default policy.
+    [buffer write:data.bytes maxLength:length / 2];
+    [buffer write:data.bytes maxLength:length * 5 / 4];
+
+    OERingBufferStatistics statistics = buffer.statistics;
+    XCTAssertEqual(statistics.writeCount, 3);
+    XCTAssertEqual(statistics.overrunCount, 1);
+    XCTAssertEqual(statistics.discardedBytes, length * 5 / 4);
+    XCTAssertEqual(statistics.readCount, 2);
+    XCTAssertEqual(statistics.underrunCount, 1);
+    XCTAssertEqual(statistics.bytesRead, length * 3 / 4);
+    XCTAssertEqual(statistics.fillHistogram[12], 1, @"first read should find the buffer 3/4 full");
+    XCTAssertEqual(statistics.fillHistogram[8], 1, @"second read should find the buffer 1/2 full");
+    XCTAssertGreaterThan(statistics.producerRate, 0);
+
+    // Overwriting the oldest bytes counts the unread bytes lost.
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    [buffer write:data.bytes maxLength:length * 3 / 4];
+    [buffer write:data.bytes maxLength:length / 4];
+    statistics = buffer.statistics;
+    XCTAssertEqual(statistics.overrunCount, 3);
+    XCTAssertEqual(statistics.discardedBytes, length * 5 / 4 + length / 4 + length / 4);
+
+    // Refused reads are counted separately from underruns.
+    buffer.anticipatesUnderflow = YES;
+    [buffer read:data.mutableBytes maxLength:length];
+    XCTAssertEqual(buffer.statistics.refusedReadCount, 1);
+    XCTAssertEqual(buffer.statistics.underrunCount, 1);
+
+    [buffer resetStatistics];
+    XCTAssertEqual(buffer.statistics.readCount, 0);
+}
+
+
+- (void)testConcurrentDiscardOldest
+{
+    const uint32_t valueCount = 20000000, chunkCount = 735;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+
+    // The producer writes a counter in chunks of one 60 Hz frame of 44.1 kHz
+    // mono audio and overruns the consumer constantly.
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint32_t chunk[chunkCount];
+        for (uint32_t value=1; value<valueCount; ) {
+            uint32_t count = 0;
+            while (count < chunkCount && value < valueCount)
+                chunk[count++] = value++;
+            [buffer write:chunk maxLength:count * sizeof(uint32_t)];
+        }
+        atomic_store(&OERingBufferTestsProducing, false);
+    });
+
+    // Every read must return a run of consecutive values, newer than the
+    // previous read's, and nothing torn.
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    uint32_t result[256], last = 0;
+    NSUInteger readCount = 0, brokenCount = 0;
+    while (atomic_load(&OERingBufferTestsProducing) || buffer.availableBytes > 0) {
+        NSUInteger count = read(result, (arc4random_uniform(256) + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+        if (count == 0)
+            continue;
+        if (result[0] <= last)
+            brokenCount++;
+        for (NSUInteger i=1; i<count; i++)
+            if (result[i] != result[i - 1] + 1)
+                brokenCount++;
+        last = result[count - 1];
+        readCount++;
+    }
+
+    XCTAssertEqual(brokenCount, 0, @"%lu of %lu reads returned torn or out of order data", brokenCount, readCount);
+    XCTAssertEqual(last, valueCount - 1, @"the newest value was not read last");
+}
+
+
+- (void)testResizeKeepsQueuedBytes
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSUInteger count = length / sizeof(uint32_t);
+    uint32_t *values = malloc(count * 2 * sizeof(uint32_t));
+    for (NSUInteger i=0; i<count * 2; i++)
+        values[i] = (uint32_t)i;
+
+    // Queue half a buffer, with the read position away from the start.
+    [buffer write:values maxLength:count * 3 / 4 * sizeof(uint32_t)];
+    uint32_t *result = malloc(length * 2);
+    [buffer read:result maxLength:count / 4 * sizeof(uint32_t)];
+
+    buffer.length = length * 2;
+    XCTAssertGreaterThanOrEqual(buffer.length, length * 2);
+    XCTAssertEqual(buffer.availableBytes, length / 2, @"growing lost queued bytes");
+
+    // Fill the grown buffer past the old length, then shrink it back.
+    [buffer write:values + count * 3 / 4 maxLength:count / 4 * sizeof(uint32_t)];
+    buffer.length = length;
+    XCTAssertEqual(buffer.length, length);
+    XCTAssertEqual(buffer.availableBytes, length * 3 / 4);
+
+    XCTAssertEqual([buffer read:result maxLength:length], length * 3 / 4);
+    for (NSUInteger i=0; i<count * 3 / 4; i++)
+        if (result[i] != count / 4 + i) {
+            XCTFail(@"value %lu is %u after resizing", i, result[i]);
+            break;
+        }
+
+    free(values);
+    free(result);
+}
+
+
+- (void)testConcurrentResize
+{
+    const uint32_t valueCount = 5000000, chunkCount = 735;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    // The producer keeps resizing the buffer between one and four times its
+    // length, while the consumer reads. Nothing may be lost or reordered.
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint32_t chunk[chunkCount];
+        for (uint32_t value=1; value<valueCount; ) {
+            uint32_t count = 0;
+            while (count < chunkCount && value < valueCount)
+                chunk[count++] = value++;
+            NSUInteger newLength = length * (arc4random_uniform(4) + 1);
+            if (arc4random_uniform(4) == 0 && buffer.availableBytes + sizeof(chunk) <= newLength)
+                buffer.length = newLength;
+            while ([buffer write:chunk maxLength:count * sizeof(uint32_t)] == 0)
+                sched_yield();
+        }
+        atomic_store(&OERingBufferTestsProducing, false);
+    });
+
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    uint32_t result[256], last = 0;
+    NSUInteger brokenCount = 0;
+    while (atomic_load(&OERingBufferTestsProducing) || buffer.availableBytes > 0) {
+        NSUInteger count = read(result, (arc4random_uniform(256) + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+        for (NSUInteger i=0; i<count; i++) {
+            if (result[i] != last + 1)
+                brokenCount++;
+            last = result[i];
+        }
+    }
+
+    XCTAssertEqual(brokenCount, 0, @"values were lost or reordered while resizing");
+    XCTAssertEqual(last, valueCount - 1);
+}
+
+
+- (void)testAdaptiveLength
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    uint8_t data[64] = { 0 };
+    buffer.adaptsLength = YES;
+    buffer.stablePeriod = 0.1;
+
+    // An underrun grows the buffer at the next write.
+    [buffer write:data maxLength:16];
+    [buffer read:data maxLength:16];
+    [buffer read:data maxLength:64];
+    [buffer write:data maxLength:16];
+    XCTAssertGreaterThan(buffer.length, length, @"buffer did not grow after an underrun");
+    XCTAssertLessThanOrEqual(buffer.length, buffer.maximumLength);
+    XCTAssertEqual(buffer.availableBytes, 16);
+
+    // After a stable period, it shrinks back to the minimum.
+    [NSThread sleepForTimeInterval:0.2];
+    [buffer write:data maxLength:16];
+    XCTAssertEqual(buffer.length, length, @"buffer did not shrink after a stable period");
+    XCTAssertEqual(buffer.availableBytes, 32);
+}
+
+
+- (void)testGameCoreAdaptsLengthOnlyWhenAsked
+{
+    OETestGameCore *core = [[OETestGameCore alloc] init];
+    OERingBuffer *buffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+    XCTAssertFalse(buffer.adaptsLength);
+
+    core = [[OETestGameCore alloc] init];
+    core.adaptsAudioBufferLength = YES;
+    buffer = (OERingBuffer *)[core audioBufferAtIndex:0];
+    XCTAssertTrue(buffer.adaptsLength);
+    XCTAssertLessThan(buffer.minimumLength, buffer.length);
+    XCTAssertGreaterThan(buffer.maximumLength, buffer.length);
+}
+
+
+#pragma mark - Benchmarks
+
+/// Overflows the buffer continuously from another thread, as a core running
+/// ahead of the host would, until OERingBufferTestsProducing is cleared.
+static void OEStartOverflowingBuffer(OERingBuffer *buffer)
+{
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint8_t chunk[2940] = { 0 };
+        while (atomic_load(&OERingBufferTestsProducing))
+            [buffer write:chunk maxLength:sizeof(chunk)];
+    });
+}
+
+- (void)testWorstCaseReadLatency
+{
+    const int sampleCount = 100000;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    // Time every read of a typical audio callback's worth of bytes.
+    OEStartOverflowingBuffer(buffer);
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    uint8_t result[2048];
+    uint64_t total = 0, worst = 0;
+    for (int i=0; i<sampleCount; i++) {
+        uint64_t start = mach_absolute_time();
+        read(result, sizeof(result));
+        uint64_t latency = mach_absolute_time() - start;
+        total += latency;
+        worst = MAX(worst, latency);
+    }
+    atomic_store(&OERingBufferTestsProducing, false);
+
+    double toNanoseconds = (double)timebase.numer / timebase.denom;
+    double mean = total * toNanoseconds / sampleCount, worstNanoseconds = worst * toNanoseconds;
+    XCTAttachment *attachment = [XCTAttachment attachmentWithString:[NSString stringWithFormat:@"mean %.0f ns, worst %.0f ns", mean, worstNanoseconds]];
+    attachment.name = @"Read latency under overflow";
+    attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+    [self addAttachment:attachment];
+
+    // A read must never take as long as the audio it returns, 512 stereo
+    // 16-bit frames at 48 kHz, or the callback misses its deadline.
+    XCTAssertLessThan(worstNanoseconds, 512 / 48000.0 * 1e9);
+}
+
+- (void)testReadLatencyUnderOverflow
+{
+    const int sampleCount = 100000;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+
+    OEStartOverflowingBuffer(buffer);
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    [self measureBlock:^{
+        uint8_t result[2048];
+        for (int i=0; i<sampleCount; i++)
+            read(result, sizeof(result));
+    }];
+    atomic_store(&OERingBufferTestsProducing, false);
+}
+
+
+@end
+
+
+static atomic_bool OERingBufferTestsProducing;
+
+
+@implementation OERingBufferTests
+
+
+- (void)testDiscardNewest
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+
+    XCTAssertEqual([buffer write:data.bytes maxLength:length], length);
+    XCTAssertEqual(buffer.freeBytes, 0);
+    XCTAssertEqual([buffer write:data.bytes maxLength:1], 0, @"write accepted by a full buffer");
+    XCTAssertEqual([buffer read:data.mutableBytes maxLength:16], 16);
+    XCTAssertEqual(buffer.availableBytes, length - 16);
+}
+
+
+- (void)testDiscardOldest
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    NSUInteger count = buffer.length / sizeof(uint32_t);
+
+    // Write one and a half buffers worth of a counter, then read it all back.
+    uint32_t *values = malloc(count * 3 / 2 * sizeof(uint32_t));
+    for (NSUInteger i=0; i<count * 3 / 2; i++)
+        values[i] = (uint32_t)i;
+    [buffer write:values maxLength:count * sizeof(uint32_t)];
+    [buffer write:values + count maxLength:count / 2 * sizeof(uint32_t)];
+    XCTAssertEqual(buffer.availableBytes, buffer.length);
+
+    uint32_t *result = malloc(buffer.length);
+    XCTAssertEqual([buffer read:result maxLength:buffer.length], buffer.length);
+    XCTAssertEqual(result[0], count / 2, @"the oldest bytes were not the ones overwritten");
+    XCTAssertEqual(result[count - 1], count * 3 / 2 - 1);
+    XCTAssertEqual(buffer.availableBytes, 0);
+
+    // A single write larger than the buffer keeps its end.
+    XCTAssertEqual([buffer write:values maxLength:count * 3 / 2 * sizeof(uint32_t)], buffer.length);
+    XCTAssertEqual([buffer read:result maxLength:buffer.length], buffer.length);
+    XCTAssertEqual(result[0], count / 2);
+
+    free(values);
+    free(result);
+}
+
+
+- (void)testZeroCopy
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    // Regions are contiguous even across the end of the buffer.
+    for (int pass=0; pass<3; pass++) {
+        uint8_t *region = [buffer reserveWriteRegion:length * 3 / 4];
+        XCTAssertTrue(region != NULL);
+        for (NSUInteger i=0; i<length * 3 / 4; i++)
+            region[i] = (uint8_t)(i + pass);
+        XCTAssertEqual(buffer.availableBytes, 0, @"reserved bytes visible before being committed");
+        [buffer commitWrite:length * 3 / 4];
+        XCTAssertEqual(buffer.availableBytes, length * 3 / 4);
+
+        NSUInteger available = length;
+        const uint8_t *data = [buffer reserveReadRegion:&available];
+        XCTAssertEqual(available, length * 3 / 4);
+        XCTAssertEqual(data[0], (uint8_t)pass);
+        XCTAssertEqual(data[available - 1], (uint8_t)(available - 1 + pass));
+        XCTAssertTrue([buffer commitRead:available]);
+        XCTAssertEqual(buffer.availableBytes, 0);
+    }
+
+    // A full buffer refuses reservations, unless it discards the oldest bytes.
+    XCTAssertTrue([buffer reserveWriteRegion:length] != NULL);
+    [buffer commitWrite:length];
+    XCTAssertTrue([buffer reserveWriteRegion:1] == NULL);
+
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    NSUInteger available = 16;
+    XCTAssertTrue([buffer reserveReadRegion:&available] != NULL);
+    XCTAssertTrue([buffer reserveWriteRegion:16] != NULL);
+    [buffer commitWrite:16];
+    XCTAssertFalse([buffer commitRead:available], @"overwritten read region not reported");
+}
+
+
+- (void)testZeroCopyCommitsOnlyReservedBytes
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    [buffer commitWrite:16];
+    XCTAssertEqual(buffer.availableBytes, 0, @"committed without a reservation");
+
+    XCTAssertTrue([buffer reserveWriteRegion:16] != NULL);
+    [buffer commitWrite:64];
+    XCTAssertEqual(buffer.availableBytes, 16, @"committed more than reserved");
+    [buffer commitWrite:16];
+    XCTAssertEqual(buffer.availableBytes, 16, @"committed the same reservation twice");
+
+    // A refused reservation can't be committed either.
+    XCTAssertTrue([buffer reserveWriteRegion:length] == NULL);
+    [buffer commitWrite:length];
+    XCTAssertEqual(buffer.availableBytes, 16);
+
+    NSUInteger available = 8;
+    XCTAssertTrue([buffer reserveReadRegion:&available] != NULL);
+    XCTAssertTrue([buffer commitRead:64]);
+    XCTAssertEqual(buffer.availableBytes, 8, @"consumed more than reserved");
+    XCTAssertEqual(buffer.bytesRead, 8);
+}
+
+
+- (void)testZeroCopyDiscardedWrites
+{
+    for (int p=0; p<2; p++) {
+        OERingBufferDiscardPolicy policy = p == 0 ? OERingBufferDiscardPolicyNewest : OERingBufferDiscardPolicyOldest;
+        OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+        OERingBuffer *copyingBuffer = [[OERingBuffer alloc] initWithLength:4096];
+        buffer.discardPolicy = copyingBuffer.discardPolicy = policy;
+        NSUInteger length = buffer.length;
+        NSMutableData *data = [NSMutableData dataWithLength:length];
+        memset(data.mutableBytes, 0xAB, length);
+
+        // Fill both buffers, then discard a write to each.
+        uint8_t *region = [buffer reserveWriteRegion:length];
+        memcpy(region, data.bytes, length);
+        [buffer commitWrite:length];
+        [copyingBuffer write:data.bytes maxLength:length];
+
+        buffer.discardsWrites = copyingBuffer.discardsWrites = YES;
+        region = [buffer reserveWriteRegion:64];
+        XCTAssertTrue(region != NULL);
+        memset(region, 0, 64);
+        [buffer commitWrite:64];
+        XCTAssertEqual([copyingBuffer write:data.bytes maxLength:64], 64);
+
+        // The published bytes are untouched, and nothing counts as an overrun.
+        XCTAssertEqual(buffer.availableBytes, length);
+        NSUInteger available = length;
+        const uint8_t *bytes = [buffer reserveReadRegion:&available];
+        XCTAssertEqual(available, length);
+        XCTAssertEqual(bytes[0], 0xAB);
+        XCTAssertEqual(bytes[length - 1], 0xAB);
+        XCTAssertTrue([buffer commitRead:available]);
+
+        OERingBufferStatistics statistics = buffer.statistics;
+        OERingBufferStatistics copyingStatistics = copyingBuffer.statistics;
+        XCTAssertEqual(statistics.overrunCount, 0);
+        XCTAssertEqual(statistics.discardedBytes, 0);
+        XCTAssertEqual(statistics.writeCount, copyingStatistics.writeCount);
+        XCTAssertEqual(statistics.overrunCount, copyingStatistics.overrunCount);
+        XCTAssertEqual(statistics.bytesWritten, copyingStatistics.bytesWritten);
+    }
+}
+
+
+- (void)testStatistics
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSMutableData *data = [NSMutableData dataWithLength:length * 2];
+
+    // Fill three quarters, then read a quarter and ask for more than is left.
+    [buffer write:data.bytes maxLength:length * 3 / 4];
+    [buffer read:data.mutableBytes maxLength:length / 4];
+    [buffer read:data.mutableBytes maxLength:length];
+    // A write larger than the buffer is refused with the default policy.
+    [buffer write:data.bytes maxLength:length / 2];
+    [buffer write:data.bytes maxLength:length * 5 / 4];
+
+    OERingBufferStatistics statistics = buffer.statistics;
+    XCTAssertEqual(statistics.writeCount, 3);
+    XCTAssertEqual(statistics.overrunCount, 1);
+    XCTAssertEqual(statistics.discardedBytes, length * 5 / 4);
+    XCTAssertEqual(statistics.readCount, 2);
+    XCTAssertEqual(statistics.underrunCount, 1);
+    XCTAssertEqual(statistics.bytesRead, length * 3 / 4);
+    XCTAssertEqual(statistics.fillHistogram[12], 1, @"first read should find the buffer 3/4 full");
+    XCTAssertEqual(statistics.fillHistogram[8], 1, @"second read should find the buffer 1/2 full");
+    XCTAssertGreaterThan(statistics.producerRate, 0);
+
+    // Overwriting the oldest bytes counts the unread bytes lost.
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+    [buffer write:data.bytes maxLength:length * 3 / 4];
+    [buffer write:data.bytes maxLength:length / 4];
+    statistics = buffer.statistics;
+    XCTAssertEqual(statistics.overrunCount, 3);
+    XCTAssertEqual(statistics.discardedBytes, length * 5 / 4 + length / 4 + length / 4);
+
+    // Refused reads are counted separately from underruns.
+    buffer.anticipatesUnderflow = YES;
+    [buffer read:data.mutableBytes maxLength:length];
+    XCTAssertEqual(buffer.statistics.refusedReadCount, 1);
+    XCTAssertEqual(buffer.statistics.underrunCount, 1);
+
+    [buffer resetStatistics];
+    XCTAssertEqual(buffer.statistics.readCount, 0);
+}
+
+
+- (void)testConcurrentDiscardOldest
+{
+    const uint32_t valueCount = 20000000, chunkCount = 735;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+
+    // The producer writes a counter in chunks of one 60 Hz frame of 44.1 kHz
+    // mono audio and overruns the consumer constantly.
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint32_t chunk[chunkCount];
+        for (uint32_t value=1; value<valueCount; ) {
+            uint32_t count = 0;
+            while (count < chunkCount && value < valueCount)
+                chunk[count++] = value++;
+            [buffer write:chunk maxLength:count * sizeof(uint32_t)];
+        }
+        atomic_store(&OERingBufferTestsProducing, false);
+    });
+
+    // Every read must return a run of consecutive values, newer than the
+    // previous read's, and nothing torn.
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    uint32_t result[256], last = 0;
+    NSUInteger readCount = 0, brokenCount = 0;
+    while (atomic_load(&OERingBufferTestsProducing) || buffer.availableBytes > 0) {
+        NSUInteger count = read(result, (arc4random_uniform(256) + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+        if (count == 0)
+            continue;
+        if (result[0] <= last)
+            brokenCount++;
+        for (NSUInteger i=1; i<count; i++)
+            if (result[i] != result[i - 1] + 1)
+                brokenCount++;
+        last = result[count - 1];
+        readCount++;
+    }
+
+    XCTAssertEqual(brokenCount, 0, @"%lu of %lu reads returned torn or out of order data", brokenCount, readCount);
+    XCTAssertEqual(last, valueCount - 1, @"the newest value was not read last");
+}
+
+
+- (void)testResizeKeepsQueuedBytes
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    NSUInteger count = length / sizeof(uint32_t);
+    uint32_t *values = malloc(count * 2 * sizeof(uint32_t));
+    for (NSUInteger i=0; i<count * 2; i++)
+        values[i] = (uint32_t)i;
+
+    // Queue half a buffer, with the read position away from the start.
+    [buffer write:values maxLength:count * 3 / 4 * sizeof(uint32_t)];
+    uint32_t *result = malloc(length * 2);
+    [buffer read:result maxLength:count / 4 * sizeof(uint32_t)];
+
+    buffer.length = length * 2;
+    XCTAssertGreaterThanOrEqual(buffer.length, length * 2);
+    XCTAssertEqual(buffer.availableBytes, length / 2, @"growing lost queued bytes");
+
+    // Fill the grown buffer past the old length, then shrink it back.
+    [buffer write:values + count * 3 / 4 maxLength:count / 4 * sizeof(uint32_t)];
+    buffer.length = length;
+    XCTAssertEqual(buffer.length, length);
+    XCTAssertEqual(buffer.availableBytes, length * 3 / 4);
+
+    XCTAssertEqual([buffer read:result maxLength:length], length * 3 / 4);
+    for (NSUInteger i=0; i<count * 3 / 4; i++)
+        if (result[i] != count / 4 + i) {
+            XCTFail(@"value %lu is %u after resizing", i, result[i]);
+            break;
+        }
+
+    free(values);
+    free(result);
+}
+
+
+- (void)testConcurrentResize
+{
+    const uint32_t valueCount = 5000000, chunkCount = 735;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+
+    // The producer keeps resizing the buffer between one and four times its
+    // length, while the consumer reads. Nothing may be lost or reordered.
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint32_t chunk[chunkCount];
+        for (uint32_t value=1; value<valueCount; ) {
+            uint32_t count = 0;
+            while (count < chunkCount && value < valueCount)
+                chunk[count++] = value++;
+            NSUInteger newLength = length * (arc4random_uniform(4) + 1);
+            if (arc4random_uniform(4) == 0 && buffer.availableBytes + sizeof(chunk) <= newLength)
+                buffer.length = newLength;
+            while ([buffer write:chunk maxLength:count * sizeof(uint32_t)] == 0)
+                sched_yield();
+        }
+        atomic_store(&OERingBufferTestsProducing, false);
+    });
+
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    uint32_t result[256], last = 0;
+    NSUInteger brokenCount = 0;
+    while (atomic_load(&OERingBufferTestsProducing) || buffer.availableBytes > 0) {
+        NSUInteger count = read(result, (arc4random_uniform(256) + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+        for (NSUInteger i=0; i<count; i++) {
+            if (result[i] != last + 1)
+                brokenCount++;
+            last = result[i];
+        }
+    }
+
+    XCTAssertEqual(brokenCount, 0, @"values were lost or reordered while resizing");
+    XCTAssertEqual(last, valueCount - 1);
+}
+
+
+- (void)testAdaptiveLength
+{
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    NSUInteger length = buffer.length;
+    uint8_t data[64] = { 0 };
+    buffer.adaptsLength = YES;
+    buffer.stablePeriod = 0.1;
+
+    // An underrun grows the buffer at the next write.
+    [buffer write:data maxLength:16];
+    [buffer read:data maxLength:16];
+    [buffer read:data maxLength:64];
+    [buffer write:data maxLength:16];
+    XCTAssertGreaterThan(buffer.length, length, @"buffer did not grow after an underrun");
+    XCTAssertLessThanOrEqual(buffer.length, buffer.maximumLength);
+    XCTAssertEqual(buffer.availableBytes, 16);
+
+    // After a stable period, it shrinks back to the minimum.
+    [NSThread sleepForTimeInterval:0.2];
+    [buffer write:data maxLength:16];
+    XCTAssertEqual(buffer.length, length, @"buffer did not shrink after a stable period");
+    XCTAssertEqual(buffer.availableBytes, 32);
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)testReadLatencyUnderOverflow
+{
+    const int sampleCount = 100000;
+    OERingBuffer *buffer = [[OERingBuffer alloc] initWithLength:4096];
+    buffer.discardPolicy = OERingBufferDiscardPolicyOldest;
+
+    // Overflow the buffer continuously while reading a typical audio
+    // callback's worth of bytes at a time.
+    atomic_store(&OERingBufferTestsProducing, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint8_t chunk[2940] = { 0 };
+        while (atomic_load(&OERingBufferTestsProducing))
+            [buffer write:chunk maxLength:sizeof(chunk)];
+    });
+
+    OEAudioBufferReadBlock read = buffer.readBlock;
+    [self measureBlock:^{
+        uint8_t result[2048];
+        for (int i=0; i<sampleCount; i++)
+            read(result, sizeof(result));
+    }];
+    atomic_store(&OERingBufferTestsProducing, false);
+}
+
+
+@end
@@ -0,0 +1,285 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OESaveStateWriter.h"
+
+
+/// A core whose state is a blob of bytes.
+@interface OESaveStateTestGameCore : OEGameCore
+@property (nullable) NSData *state;
+@property (nullable) NSError *serializationError;
+@end
+
+@implementation OESaveStateTestGameCore
+
+- (NSData *)serializeStateWithError:(NSError **)outError
+{
+    if (_serializationError != nil && outError != NULL)
+        *outError = _serializationError;
+    return _serializationError != nil ? nil : _state;
+}
+
+- (BOOL)deserializeState:(NSData *)state withError:(NSError **)outError
+{
+    _state = [state copy];
+    return YES;
+}
+
+@end
+
+
+@interface OESaveStateWriterTests : XCTestCase
+
+@end
+
+
+@implementation OESaveStateWriterTests
+{
+    OESaveStateTestGameCore *core;
+    OESaveStateWriter *writer;
+    NSURL *directoryURL;
+    NSURL *stateURL;
+}
+
+- (void)setUp
+{
+    core = [[OESaveStateTestGameCore alloc] init];
+    writer = [[OESaveStateWriter alloc] init];
+    directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES] URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [NSFileManager.defaultManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+    stateURL = [directoryURL URLByAppendingPathComponent:@"State.oesavestate"];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:directoryURL error:nil];
+}
+
+/// A 1 MB state which compresses well.
+static NSData *OEMakeState(uint8_t seed)
+{
+    NSMutableData *state = [NSMutableData dataWithLength:1 << 20];
+    uint8_t *bytes = state.mutableBytes;
+    for (NSUInteger i=0; i<state.length; i++)
+        bytes[i] = (i / 64 + seed) & 0xFF;
+    return state;
+}
+
+- (NSError *)save
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"save"];
+    __block NSError *result;
+    [writer saveStateOfGameCore:core toURL:stateURL completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertEqual(success, error == nil);
+        result = error;
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:10];
+    return result;
+}
+
+- (NSError *)load
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"load"];
+    __block NSError *result;
+    [writer loadStateOfGameCore:core fromURL:stateURL completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertEqual(success, error == nil);
+        result = error;
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:10];
+    return result;
+}
+
+- (void)testRoundTripsCompressedStates
+{
+    NSData *state = OEMakeState(0);
+    core.state = state;
+    XCTAssertNil([self save]);
+
+    NSData *file = [NSData dataWithContentsOfURL:stateURL];
+    XCTAssertEqual(memcmp(file.bytes, "OESS", 4), 0);
+    XCTAssertLessThan(file.length, state.length / 10);
+
+    core.state = nil;
+    XCTAssertNil([self load]);
+    XCTAssertEqualObjects(core.state, state);
+    XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], state);
+}
+
+- (void)testWritesUncompressedStates
+{
+    writer.compressesStates = NO;
+    core.state = OEMakeState(0);
+    XCTAssertNil([self save]);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:stateURL], core.state);
+
+    NSData *state = core.state;
+    core.state = nil;
+    XCTAssertNil([self load]);
+    XCTAssertEqualObjects(core.state, state);
+}
+
+- (void)testWritesIncompressibleStatesUncompressed
+{
+    NSMutableData *state = [NSMutableData dataWithLength:4096];
+    arc4random_buf(state.mutableBytes, state.length);
+    core.state = state;
+    XCTAssertNil([self save]);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:stateURL], state);
+}
+
+- (void)testReplacesStatesWithoutLeavingTemporaryFiles
+{
+    core.state = OEMakeState(0);
+    XCTAssertNil([self save]);
+    NSData *state = OEMakeState(1);
+    core.state = state;
+    XCTAssertNil([self save]);
+
+    NSArray *contents = [NSFileManager.defaultManager contentsOfDirectoryAtPath:directoryURL.path error:NULL];
+    XCTAssertEqualObjects(contents, @[ @"State.oesavestate" ]);
+    XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], state);
+}
+
+- (void)testCopiesTheStateBeforeReturningToTheCore
+{
+    NSMutableData *state = [OEMakeState(0) mutableCopy];
+    core.state = state;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"save"];
+    [writer saveStateOfGameCore:core toURL:stateURL completionHandler:^(BOOL success, NSError *error) {
+        [expectation fulfill];
+    }];
+    // The core isn't running, so it was serialized right away.
+    memset(state.mutableBytes, 0xFF, state.length);
+    [self waitForExpectations:@[expectation] timeout:10];
+
+    XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], OEMakeState(0));
+}
+
+- (void)testReportsSerializationErrors
+{
+    core.serializationError = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFeatureUnsupportedError userInfo:nil];
+    XCTAssertEqualObjects([self save], core.serializationError);
+    XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:stateURL.path]);
+}
+
+- (void)testReportsWriteErrors
+{
+    core.state = OEMakeState(0);
+    stateURL = [directoryURL URLByAppendingPathComponent:@"Missing/State.oesavestate"];
+    NSError *error = [self save];
+    XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+    XCTAssertEqual(error.code, ENOENT);
+}
+
+- (void)testLoadsTruncatedCompressedStatesAsTheyAre
+{
+    core.state = OEMakeState(0);
+    XCTAssertNil([self save]);
+    NSMutableData *file = [[NSData dataWithContentsOfURL:stateURL] mutableCopy];
+    file.length = file.length / 2;
+    [file writeToURL:stateURL atomically:NO];
+
+    // It's up to the core to reject them.
+    XCTAssertNil([self load]);
+    XCTAssertEqualObjects(core.state, file);
+}
+
+- (void)testLoadsStatesWhichDecodeToAnotherLengthAsTheyAre
+{
+    core.state = OEMakeState(0);
+    XCTAssertNil([self save]);
+    NSMutableData *file = [[NSData dataWithContentsOfURL:stateURL] mutableCopy];
+
+    for (NSInteger difference = -1; difference <= 1; difference += 2) {
+        OSWriteLittleInt64(file.mutableBytes, 8, core.state.length + difference);
+        [file writeToURL:stateURL atomically:YES];
+        XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], file, @"difference %ld", (long)difference);
+    }
+}
+
+- (void)testLoadsUncompressedStatesStartingWithTheMagic
+{
+    NSData *valid = [NSData dataWithBytes:(uint8_t[]){ 'O', 'E', 'S', 'S', 1, 0, 0, 0, 0x10, 0, 0, 0, 0, 0, 0, 0 } length:16];
+    NSMutableData *state = [NSMutableData dataWithLength:256];
+    arc4random_buf(state.mutableBytes, state.length);
+    uint8_t *header = state.mutableBytes;
+
+    // A header which claims more than the payload can hold.
+    [state replaceBytesInRange:NSMakeRange(0, 16) withBytes:valid.bytes];
+    OSWriteLittleInt64(header, 8, 1ULL << 40);
+    [state writeToURL:stateURL atomically:YES];
+    XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], state);
+
+    // Unknown versions and flags.
+    for (int i=4; i<8; i++) {
+        [state replaceBytesInRange:NSMakeRange(0, 16) withBytes:valid.bytes];
+        header[i] = 0x80;
+        [state writeToURL:stateURL atomically:YES];
+        XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], state, @"byte %d", i);
+    }
+
+    // A valid header followed by anything but an LZFSE stream.
+    [state replaceBytesInRange:NSMakeRange(0, 16) withBytes:valid.bytes];
+    [state writeToURL:stateURL atomically:YES];
+    core.state = nil;
+    XCTAssertNil([self load]);
+    XCTAssertEqualObjects(core.state, state);
+}
+
+- (void)testReportsReadErrors
+{
+    NSError *error;
+    XCTAssertNil([OESaveStateWriter stateWithContentsOfURL:stateURL error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertNotNil([self load]);
+}
+
+- (void)testGameCoreSavesStatesInTheBackground
+{
+    NSData *state = OEMakeState(2);
+    core.state = state;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"save"];
+    [core saveStateToFileAtURL:stateURL completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertTrue(success, @"%@", error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:10];
+    XCTAssertEqualObjects([OESaveStateWriter stateWithContentsOfURL:stateURL error:NULL], state);
+
+    OEGameCore *statelessCore = [[OEGameCore alloc] init];
+    expectation = [self expectationWithDescription:@"unsupported"];
+    [statelessCore saveStateToFileAtURL:stateURL completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertFalse(success);
+        XCTAssertEqual(error.code, OEGameCoreDoesNotSupportSaveStatesError);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:10];
+}
+
+@end
@@ -0,0 +1,163 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import <XCTest/XCTest.h>
+#import "OEGameCore.h"
+#import "OETestGameCore.h"
+#import "OETripleBuffer.h"
+
+
+@interface OESnapshotTests : XCTestCase
+
+@end
+
+
+@implementation OESnapshotTests
+{
+    OETestGameCore *core;
+    OETripleBuffer *tripleBuffer;
+}
+
+- (void)setUp
+{
+    core = [[OETestGameCore alloc] init];
+    tripleBuffer = [[OETripleBuffer alloc] initWithLength:8 * 4 * 4];
+    core.videoTripleBuffer = tripleBuffer;
+}
+
+/// Publishes a frame whose screenRect pixels are base + their index, with red around it.
+- (void)publishFrameWithBase:(uint32_t)base
+{
+    uint32_t *pixels = tripleBuffer.writeBuffer;
+    for (int i=0; i<8*4; i++)
+        pixels[i] = 0xFFFF0000;
+    for (int y=0; y<2; y++)
+        for (int x=0; x<4; x++)
+            pixels[(y + 1) * 8 + x + 2] = base + y * 4 + x;
+    [tripleBuffer publishWriteBufferWithScreenRect:core.screenRect aspectSize:core.aspectSize];
+}
+
+- (NSData *)takeSnapshotWithFormat:(OESnapshotFormat)format size:(OEIntSize)size resultSize:(OEIntSize *)resultSize error:(NSError **)error
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"snapshot"];
+    __block NSData *result;
+    __block NSError *resultError;
+    [core takeSnapshotWithFormat:format size:size completionHandler:^(NSData *data, OEIntSize size, NSError *error) {
+        XCTAssertFalse(NSThread.isMainThread, @"encoded on the calling thread");
+        result = data;
+        resultError = error;
+        if (resultSize != NULL)
+            *resultSize = size;
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    if (error != NULL)
+        *error = resultError;
+    return result;
+}
+
+- (void)testCopiesTheScreenRectOfThePublishedFrame
+{
+    [self publishFrameWithBase:0xFF000000];
+
+    OEIntSize size;
+    NSData *data = [self takeSnapshotWithFormat:OESnapshotFormatBGRA8 size:(OEIntSize){ 4, 2 } resultSize:&size error:NULL];
+    XCTAssertEqual(size.width, 4);
+    XCTAssertEqual(size.height, 2);
+    XCTAssertEqual(data.length, 4 * 2 * 4);
+    const uint32_t *pixels = data.bytes;
+    for (uint32_t i=0; i<8; i++)
+        XCTAssertEqual(pixels[i], 0xFF000000 + i, @"pixel %u", i);
+}
+
+- (void)testLaterFramesDontChangeAPendingSnapshot
+{
+    [self publishFrameWithBase:0xFF000000];
+
+    // The core isn't running, so the frame is copied right away, and
+    // frames published before the picture is encoded don't show up.
+    XCTestExpectation *expectation = [self expectationWithDescription:@"snapshot"];
+    __block NSData *result;
+    [core takeSnapshotWithFormat:OESnapshotFormatBGRA8 size:(OEIntSize){ 4, 2 } completionHandler:^(NSData *data, OEIntSize size, NSError *error) {
+        result = data;
+        [expectation fulfill];
+    }];
+    [self publishFrameWithBase:0xFF100000];
+    [self publishFrameWithBase:0xFF200000];
+    [self waitForExpectations:@[expectation] timeout:5];
+
+    XCTAssertEqual(((const uint32_t *)result.bytes)[0], 0xFF000000);
+}
+
+- (void)testDefaultSizeIsCorrectedForAspectSize
+{
+    [self publishFrameWithBase:0xFF000000];
+
+    OEIntSize size;
+    NSData *data = [self takeSnapshotWithFormat:OESnapshotFormatBGRA8 size:(OEIntSize){} resultSize:&size error:NULL];
+    XCTAssertEqual(size.width, 4);
+    XCTAssertEqual(size.height, 3);
+    XCTAssertEqual(data.length, 4 * 3 * 4);
+}
+
+- (void)testScalesDown
+{
+    [self publishFrameWithBase:0xFF000000];
+
+    NSData *data = [self takeSnapshotWithFormat:OESnapshotFormatBGRA8 size:(OEIntSize){ 2, 1 } resultSize:NULL error:NULL];
+    XCTAssertEqual(data.length, 2 * 1 * 4);
+    // The average of pixels 0, 1, 4 and 5, rounded.
+    XCTAssertEqual(((const uint32_t *)data.bytes)[0], 0xFF000003);
+}
+
+- (void)testEncodesPNG
+{
+    [self publishFrameWithBase:0xFF000000];
+
+    NSData *data = [self takeSnapshotWithFormat:OESnapshotFormatPNG size:(OEIntSize){ 4, 2 } resultSize:NULL error:NULL];
+    const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    XCTAssertGreaterThan(data.length, sizeof(signature));
+    XCTAssertEqual(memcmp(data.bytes, signature, sizeof(signature)), 0);
+}
+
+- (void)testFailsWithoutAPublishedFrame
+{
+    NSError *error;
+    XCTAssertNil([self takeSnapshotWithFormat:OESnapshotFormatBGRA8 size:(OEIntSize){} resultSize:NULL error:&error]);
+    XCTAssertEqualObjects(error.domain, OEGameCoreErrorDomain);
+    XCTAssertEqual(error.code, OEGameCoreCouldNotTakeSnapshotError);
+}
+
+- (void)testFailsWithoutATripleBuffer
+{
+    [self publishFrameWithBase:0xFF000000];
+    core.videoTripleBuffer = nil;
+
+    NSError *error;
+    XCTAssertNil([self takeSnapshotWithFormat:OESnapshotFormatPNG size:(OEIntSize){} resultSize:NULL error:&error]);
+    XCTAssertEqual(error.code, OEGameCoreCouldNotTakeSnapshotError);
+}
+
+@end
@@ -0,0 +1,53 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import "OEGameCore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A stereo 48 kHz core showing 4x2 BGRA pixels at {2, 1} of an 8x4
+/// buffer, at a 4:3 aspect ratio. Shared by tests which need a core.
+@interface OETestGameCore : OEGameCore
+
+/// Called by -executeFrame, on the core thread.
+@property (nullable, copy) void (^executeFrameHandler)(OETestGameCore *core);
+
+/// The number of frames executed so far. Safe to read from any thread.
+@property (readonly) NSUInteger executedFrameCount;
+
+@end
+
+/// Polls condition until it is true or timeout has passed. Returns its last value.
+BOOL OETestWaitUntil(NSTimeInterval timeout, BOOL (^condition)(void));
+
+/// Counts the presentation callbacks of a core.
+@interface OETestRenderDelegate : NSObject <OERenderDelegate>
+
+@property (readonly) NSUInteger presentedFrameCount;
+@property (readonly) NSUInteger skippedFrameCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,81 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#import "OETestGameCore.h"
+#import <stdatomic.h>
+
+@implementation OETestGameCore
+{
+    atomic_ulong _executedFrameCount;
+}
+
+- (OEIntSize)bufferSize { return (OEIntSize){ 8, 4 }; }
+- (OEIntRect)screenRect { return (OEIntRect){ { 2, 1 }, { 4, 2 } }; }
+- (OEIntSize)aspectSize { return (OEIntSize){ 4, 3 }; }
+- (uint32_t)pixelFormat { return OEPixelFormat_BGRA; }
+- (uint32_t)pixelType { return OEPixelType_UNSIGNED_INT_8_8_8_8_REV; }
+- (NSUInteger)channelCount { return 2; }
+- (double)audioSampleRate { return 48000; }
+
+- (void)executeFrame
+{
+    atomic_fetch_add(&_executedFrameCount, 1);
+    if (_executeFrameHandler != nil)
+        _executeFrameHandler(self);
+}
+
+- (NSUInteger)executedFrameCount
+{
+    return atomic_load(&_executedFrameCount);
+}
+
+@end
+
+BOOL OETestWaitUntil(NSTimeInterval timeout, BOOL (^condition)(void))
+{
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition()) {
+        if (deadline.timeIntervalSinceNow < 0)
+            return condition();
+        usleep(1000);
+    }
+    return YES;
+}
+
+@implementation OETestRenderDelegate
+
+- (void)presentDoubleBufferedFBO {}
+- (void)willRenderFrameOnAlternateThread {}
+- (void)didRenderFrameOnAlternateThread {}
+- (id)presentationFramebuffer { return nil; }
+- (void)suspendFPSLimiting {}
+- (void)resumeFPSLimiting {}
+
+- (void)willExecute {}
+- (void)didExecute { _presentedFrameCount++; }
+- (void)willExecuteSkippedFrame {}
+- (void)didExecuteSkippedFrame { _skippedFrameCount++; }
+
+@end
@@ -0,0 +1,148 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#import <XCTest/XCTest.h>
+#import "OETripleBuffer.h"
+
+
+@interface OETripleBufferTests : XCTestCase
+
+@end
+
+
+#define OE_TEST_FRAME_LENGTH 4096
+
+/// Fills a frame with its frame number.
+static void OEFillFrame(void *bytes, uint32_t frameNumber)
+{
+    uint32_t *words = bytes;
+    for (int i=0; i<OE_TEST_FRAME_LENGTH / 4; i++)
+        words[i] = frameNumber;
+}
+
+/// Returns YES if every word of a frame is its frame number.
+static BOOL OEFrameIsWhole(OETripleBufferFrame frame)
+{
+    const uint32_t *words = frame.bytes;
+    for (int i=0; i<OE_TEST_FRAME_LENGTH / 4; i++)
+        if (words[i] != (uint32_t)frame.frameNumber)
+            return NO;
+    return YES;
+}
+
+
+@implementation OETripleBufferTests
+
+- (void)testHandsOverTheLatestFrame
+{
+    OETripleBuffer *buffer = [[OETripleBuffer alloc] initWithLength:OE_TEST_FRAME_LENGTH];
+
+    // Zeroed until a frame is published.
+    OETripleBufferFrame frame = [buffer acquireLatestFrame];
+    XCTAssertEqual(frame.frameNumber, 0);
+    XCTAssertTrue(OEFrameIsWhole(frame));
+
+    for (uint32_t i=1; i<=2; i++) {
+        OEFillFrame(buffer.writeBuffer, i);
+        [buffer publishWriteBufferWithScreenRect:OEIntRectMake(0, 0, 256, 4) aspectSize:OEIntSizeMake(i, 3)];
+    }
+
+    frame = [buffer acquireLatestFrame];
+    XCTAssertEqual(frame.frameNumber, 2);
+    XCTAssertTrue(OEFrameIsWhole(frame));
+    XCTAssertTrue(OEIntRectEqualToRect(frame.screenRect, OEIntRectMake(0, 0, 256, 4)));
+    XCTAssertEqual(frame.aspectSize.width, 2);
+    XCTAssertEqual(buffer.publishedFrameCount, 2);
+    XCTAssertEqual(buffer.overwrittenFrameCount, 1, @"frame 1 was never acquired");
+
+    // Without a newer frame, the reader keeps its frame.
+    OETripleBufferFrame again = [buffer acquireLatestFrame];
+    XCTAssertEqual(again.frameNumber, 2);
+    XCTAssertEqual(again.bytes, frame.bytes);
+}
+
+- (void)testWriterNeverDrawsIntoTheReadersFrame
+{
+    OETripleBuffer *buffer = [[OETripleBuffer alloc] initWithLength:OE_TEST_FRAME_LENGTH];
+    OEFillFrame(buffer.writeBuffer, 1);
+    [buffer publishWriteBufferWithScreenRect:OEIntRectMake(0, 0, 256, 4) aspectSize:OEIntSizeMake(4, 3)];
+    OETripleBufferFrame frame = [buffer acquireLatestFrame];
+
+    for (uint32_t i=2; i<10; i++) {
+        XCTAssertNotEqual(buffer.writeBuffer, frame.bytes);
+        OEFillFrame(buffer.writeBuffer, i);
+        [buffer publishWriteBufferWithScreenRect:OEIntRectMake(0, 0, 256, 4) aspectSize:OEIntSizeMake(4, 3)];
+    }
+
+    XCTAssertEqual(frame.frameNumber, 1);
+    XCTAssertTrue(OEFrameIsWhole(frame));
+    XCTAssertEqual([buffer acquireLatestFrame].frameNumber, 9);
+}
+
+- (void)testFramesDontTearAcrossThreads
+{
+    OETripleBuffer *buffer = [[OETripleBuffer alloc] initWithLength:OE_TEST_FRAME_LENGTH];
+    const uint32_t frameCount = 20000;
+
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for (uint32_t i=1; i<=frameCount; i++) {
+            OEFillFrame(buffer.writeBuffer, i);
+            [buffer publishWriteBufferWithScreenRect:OEIntRectMake(0, 0, 256, 4) aspectSize:OEIntSizeMake(4, 3)];
+        }
+    });
+
+    uint64_t lastFrameNumber = 0, acquiredCount = 0, tornCount = 0;
+    while (lastFrameNumber < frameCount) {
+        OETripleBufferFrame frame = [buffer acquireLatestFrame];
+        XCTAssertGreaterThanOrEqual(frame.frameNumber, lastFrameNumber, @"frames went back in time");
+        if (frame.frameNumber != lastFrameNumber) {
+            acquiredCount++;
+            if (!OEFrameIsWhole(frame))
+                tornCount++;
+        }
+        lastFrameNumber = frame.frameNumber;
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    XCTAssertEqual(tornCount, 0);
+    XCTAssertEqual(buffer.publishedFrameCount, frameCount);
+    XCTAssertEqual(acquiredCount + buffer.overwrittenFrameCount, frameCount, @"every frame is either acquired or overwritten");
+}
+
+
+#pragma mark - Benchmarks
+
+- (void)testHandoffThroughput
+{
+    OETripleBuffer *buffer = [[OETripleBuffer alloc] initWithLength:OE_TEST_FRAME_LENGTH];
+    [self measureBlock:^{
+        for (int i=0; i<100000; i++) {
+            [buffer publishWriteBufferWithScreenRect:OEIntRectMake(0, 0, 256, 4) aspectSize:OEIntSizeMake(4, 3)];
+            [buffer acquireLatestFrame];
+        }
+    }];
+}
+
+@end
@@ -34,6 +34,7 @@
 #error "Unsupported platform"
 #endif
 #import <OpenEmuBase/OEGameCore.h>
+#import <OpenEmuBase/OEInputMovie.h>
 #import <OpenEmuSystem/OEBindingMap.h>
 #import <OpenEmuSystem/OEKeyBindingDescription.h>
 #import <OpenEmuSystem/OESystemBindings.h>
@@ -62,6 +63,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property(nonatomic, strong) OEBindingMap *keyMap;
 
+/// Records every emulator key event sent to the client. Set from the core thread.
+@property(nullable, strong) OEInputMovieRecorder *inputMovieRecorder;
+
+/// Sends the inputs of the movie to the client instead of live input until the movie finishes.
+- (void)playInputMovie:(nullable OEInputMoviePlayer *)player;
+
 - (OESystemKey *)emulatorKeyForKey:(OEKeyBindingDescription *)aKey player:(NSUInteger)thePlayer;
 
 - (void)pressEmulatorKey:(OESystemKey *)aKey;
@@ -117,6 +117,8 @@ typedef struct OEPlayerRapidFireState {
     double _analogToDigitalThreshold;
     NSMutableDictionary<OEDeviceHandlerPlaceholder *, NSMutableArray<void (^)(void)>*>* _pendingDeviceHandlerBindings;
     id _token;
+
+    OEInputMoviePlayer *_inputMoviePlayer;
 }
 
 + (void)load
@@ -223,6 +225,59 @@ static OEJoystickStatusKey _OEJoystickStateKeyForEvent(OEHIDEvent *anEvent)
     return (OEJoystickStatusKey)ret;
 }
 
+#pragma mark - Input Movies
+
+/* All emulator key events go through these, on the core thread, so that
+ * input movies see exactly what the core sees. Live input is ignored while
+ * a movie is playing. */
+
+static inline BOOL _OESystemResponderAcceptsLiveInput(OESystemResponder *self)
+{
+    OEInputMoviePlayer *player = self->_inputMoviePlayer;
+    return player == nil || player.isFinished;
+}
+
+static inline void _OESystemResponderPressEmulatorKey(OESystemResponder *self, OESystemKey *key)
+{
+    if(!_OESystemResponderAcceptsLiveInput(self)) return;
+    [self.inputMovieRecorder recordValue:1.0 forKey:key.key player:key.player analog:NO];
+    [self pressEmulatorKey:key];
+}
+
+static inline void _OESystemResponderReleaseEmulatorKey(OESystemResponder *self, OESystemKey *key)
+{
+    if(!_OESystemResponderAcceptsLiveInput(self)) return;
+    [self.inputMovieRecorder recordValue:0.0 forKey:key.key player:key.player analog:NO];
+    [self releaseEmulatorKey:key];
+}
+
+static inline void _OESystemResponderChangeAnalogEmulatorKey(OESystemResponder *self, OESystemKey *key, CGFloat value)
+{
+    if(!_OESystemResponderAcceptsLiveInput(self)) return;
+    [self.inputMovieRecorder recordValue:value forKey:key.key player:key.player analog:YES];
+    [self changeAnalogEmulatorKey:key value:value];
+}
+
+- (void)playInputMovie:(nullable OEInputMoviePlayer *)player
+{
+    [[self client] performBlock:^{
+        self->_inputMoviePlayer.eventHandler = nil;
+        self->_inputMoviePlayer = player;
+
+        __weak OESystemResponder *weakSelf = self;
+        player.eventHandler = ^(NSUInteger playerNumber, NSUInteger keyNumber, double value, BOOL analog) {
+            OESystemResponder *strongSelf = weakSelf;
+            OESystemKey *key = [OESystemKey systemKeyWithKey:keyNumber player:playerNumber isAnalogic:analog];
+            if(analog)
+                [strongSelf changeAnalogEmulatorKey:key value:value];
+            else if(value != 0)
+                [strongSelf pressEmulatorKey:key];
+            else
+                [strongSelf releaseEmulatorKey:key];
+        };
+    }];
+}
+
 #pragma mark - Rapid Fire
 
 static inline BOOL _OESystemResponderHandleRapidFirePressForKey(OESystemResponder *self, OESystemKey *key)
@@ -245,7 +300,7 @@ static inline BOOL _OESystemResponderHandleRapidFirePressForKey(OESystemResponde
         case OEPlayerRapidFireSetupModeClear:
             [rfstate.rapidFireButtons removeObject:key];
             if (!rfstate.currentButtonStates[keyId].state)
-                [self pressEmulatorKey:key];
+                _OESystemResponderPressEmulatorKey(self, key);
             rfstate.currentButtonStates.erase(keyId);
             return YES;
             
@@ -272,7 +327,7 @@ static inline BOOL _OESystemResponderHandleRapidFireReleaseForKey(OESystemRespon
         case OEPlayerRapidFireSetupModeNone:
             if ([rfstate.rapidFireButtons containsObject:key]) {
                 if (rfstate.currentButtonStates[keyId].state)
-                    [self releaseEmulatorKey:key];
+                    _OESystemResponderReleaseEmulatorKey(self, key);
                 rfstate.currentButtonStates.erase(keyId);
                 return YES;
             }
@@ -296,9 +351,9 @@ static inline void _OESystemResponderRapidFireFrameCallback(OESystemResponder *s
             if (newState != bstate.state) {
                 bstate.state = newState;
                 if (newState) {
-                    [self pressEmulatorKey:key];
+                    _OESystemResponderPressEmulatorKey(self, key);
                 } else {
-                    [self releaseEmulatorKey:key];
+                    _OESystemResponderReleaseEmulatorKey(self, key);
                 }
             }
             
@@ -364,7 +419,7 @@ static inline void _OESystemResponderRapidFireFrameCallback(OESystemResponder *s
     for (OESystemKey *key in rfstate.rapidFireButtons) {
         if ([rfstate.pressedButtons containsObject:key]) {
             if (!rfstate.currentButtonStates[key.key].state)
-                [self pressEmulatorKey:key];
+                _OESystemResponderPressEmulatorKey(self, key);
             rfstate.currentButtonStates.erase(key.key);
         }
     }
@@ -394,7 +449,7 @@ static inline void _OESystemResponderRapidFireFrameCallback(OESystemResponder *s
     for (OESystemKey *key in rfstate.pressedButtons) {
         if ([rfstate.rapidFireButtons containsObject:key])
             if (!rfstate.currentButtonStates[key.key].state)
-                [self pressEmulatorKey:key];
+                _OESystemResponderPressEmulatorKey(self, key);
     }
     [rfstate.rapidFireButtons removeAllObjects];
     rfstate.currentButtonStates.clear();
@@ -402,65 +457,138 @@ static inline void _OESystemResponderRapidFireFrameCallback(OESystemResponder *s
 
 #pragma mark - Event Funneling Functions
 
+/* Key events are sent to the core thread as commands when the client
+ * supports them, which avoids a block copy and run loop round trip per event.
+ * The key field of the command carries these flags on top of the key number. */
+#define OE_KEY_COMMAND_ANALOGIC_EVENT (1u << 31)
+#define OE_KEY_COMMAND_ANALOGIC_KEY   (1u << 30)
+
+static void _OESystemResponderPerformPress(OESystemResponder *self, OESystemKey *key, BOOL isAnalogic)
+{
+    if([key isGlobalButtonKey])
+    {
+        OEGlobalButtonIdentifier ident = (OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag);
+        if(isAnalogic)
+            [self changeAnalogGlobalButtonIdentifier:ident value:1.0];
+        else
+            [self pressGlobalButtonWithIdentifier:ident player:key.player];
+    }
+    else
+    {
+        if(isAnalogic)
+            _OESystemResponderChangeAnalogEmulatorKey(self, key, 1.0);
+        else {
+            if (!_OESystemResponderHandleRapidFirePressForKey(self, key))
+                _OESystemResponderPressEmulatorKey(self, key);
+        }
+    }
+}
+
+static void _OESystemResponderPerformRelease(OESystemResponder *self, OESystemKey *key, BOOL isAnalogic)
+{
+    if([key isGlobalButtonKey])
+    {
+        OEGlobalButtonIdentifier ident = (OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag);
+        if(isAnalogic)
+            [self changeAnalogGlobalButtonIdentifier:ident value:0.0];
+        else
+            [self releaseGlobalButtonWithIdentifier:ident player:key.player];
+    }
+    else
+    {
+        if(isAnalogic)
+            _OESystemResponderChangeAnalogEmulatorKey(self, key, 0.0);
+        else {
+            if (!_OESystemResponderHandleRapidFireReleaseForKey(self, key))
+                _OESystemResponderReleaseEmulatorKey(self, key);
+        }
+    }
+}
+
+static void _OESystemResponderPerformChangeAnalog(OESystemResponder *self, OESystemKey *key, CGFloat value)
+{
+    if([key isGlobalButtonKey])
+        [self changeAnalogGlobalButtonIdentifier:(OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag) value:value];
+    else
+        _OESystemResponderChangeAnalogEmulatorKey(self, key, value);
+}
+
+static void _OESystemResponderPerformKeyCommand(const OECommand *command)
+{
+    OESystemResponder *self = (__bridge OESystemResponder *)command->context;
+    uint32_t keyNumber = command->key & ~(OE_KEY_COMMAND_ANALOGIC_EVENT | OE_KEY_COMMAND_ANALOGIC_KEY);
+    OESystemKey *key = [OESystemKey systemKeyWithKey:keyNumber player:command->player isAnalogic:!!(command->key & OE_KEY_COMMAND_ANALOGIC_KEY)];
+    BOOL isAnalogic = !!(command->key & OE_KEY_COMMAND_ANALOGIC_EVENT);
+
+    switch(command->tag)
+    {
+        case OECommandTagPressKey:
+            _OESystemResponderPerformPress(self, key, isAnalogic);
+            break;
+        case OECommandTagReleaseKey:
+            _OESystemResponderPerformRelease(self, key, isAnalogic);
+            break;
+        case OECommandTagChangeAnalogKey:
+            _OESystemResponderPerformChangeAnalog(self, key, command->value);
+            break;
+    }
+}
+
+static void _OESystemResponderReleaseKeyCommandContext(void *context)
+{
+    (void)(__bridge_transfer OESystemResponder *)context;
+}
+
+/// Returns NO if the event must be sent with -performBlock: instead.
+static BOOL _OESystemResponderPushKeyCommand(OESystemResponder *self, OECommandTag tag, OESystemKey *key, BOOL isAnalogic, CGFloat value)
+{
+    id<OESystemResponderClient> client = [self client];
+    if(![client respondsToSelector:@selector(pushCommand:)])
+        return NO;
+
+    OECommand command = {
+        .function = _OESystemResponderPerformKeyCommand,
+        .context = (__bridge_retained void *)self,
+        .releaseContext = _OESystemResponderReleaseKeyCommandContext,
+        .tag = tag,
+        .player = (uint32_t)key.player,
+        .key = (uint32_t)key.key | (isAnalogic ? OE_KEY_COMMAND_ANALOGIC_EVENT : 0) | (key.isAnalogic ? OE_KEY_COMMAND_ANALOGIC_KEY : 0),
+        .value = (float)value,
+    };
+    if([client pushCommand:&command])
+        return YES;
+
+    _OESystemResponderReleaseKeyCommandContext(command.context);
+    return NO;
+}
+
 static inline void _OEBasicSystemResponderPressSystemKey(OESystemResponder *self, OESystemKey *key, BOOL isAnalogic)
 {
     if(key == nil) return;
+    if(_OESystemResponderPushKeyCommand(self, OECommandTagPressKey, key, isAnalogic, 1.0)) return;
 
     [[self client] performBlock:^{
-        if([key isGlobalButtonKey])
-        {
-            OEGlobalButtonIdentifier ident = (OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag);
-            if(isAnalogic)
-                [self changeAnalogGlobalButtonIdentifier:ident value:1.0];
-            else
-                [self pressGlobalButtonWithIdentifier:ident player:key.player];
-        }
-        else
-        {
-            if(isAnalogic)
-                [self changeAnalogEmulatorKey:key value:1.0];
-            else {
-                if (!_OESystemResponderHandleRapidFirePressForKey(self, key))
-                    [self pressEmulatorKey:key];
-            }
-        }
+        _OESystemResponderPerformPress(self, key, isAnalogic);
     }];
 }
 
 static inline void _OEBasicSystemResponderReleaseSystemKey(OESystemResponder *self, OESystemKey *key, BOOL isAnalogic)
 {
     if(key == nil) return;
+    if(_OESystemResponderPushKeyCommand(self, OECommandTagReleaseKey, key, isAnalogic, 0.0)) return;
 
     [[self client] performBlock:^{
-        if([key isGlobalButtonKey])
-        {
-            OEGlobalButtonIdentifier ident = (OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag);
-            if(isAnalogic)
-                [self changeAnalogGlobalButtonIdentifier:ident value:0.0];
-            else
-                [self releaseGlobalButtonWithIdentifier:ident player:key.player];
-        }
-        else
-        {
-            if(isAnalogic)
-                [self changeAnalogEmulatorKey:key value:0.0];
-            else {
-                if (!_OESystemResponderHandleRapidFireReleaseForKey(self, key))
-                    [self releaseEmulatorKey:key];
-            }
-        }
+        _OESystemResponderPerformRelease(self, key, isAnalogic);
     }];
 }
 
 static inline void _OEBasicSystemResponderChangeAnalogSystemKey(OESystemResponder *self, OESystemKey *key, CGFloat value)
 {
     if(key == nil) return;
+    if(_OESystemResponderPushKeyCommand(self, OECommandTagChangeAnalogKey, key, YES, value)) return;
 
     [[self client] performBlock:^{
-        if([key isGlobalButtonKey])
-            [self changeAnalogGlobalButtonIdentifier:(OEGlobalButtonIdentifier)([key key] & ~OEGlobalButtonIdentifierFlag) value:value];
-        else
-            [self changeAnalogEmulatorKey:key value:value];
+        _OESystemResponderPerformChangeAnalog(self, key, value);
     }];
 }
 